@@ -0,0 +1,698 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <linkedlist.h>
+#include <btree.h>
+#include <bstree.h>
+#include <skiplist.h>
+#include <btreemap.h>
+#include <hashmap.h>
+#include <vec.h>
+#include <btree_par.h>
+#include <heap.h>
+#include <bitvec.h>
+#include <vec_soa.h>
+#include <pvec.h>
+#include <gapbuf.h>
+#include <vec_par.h>
+#include <segvec.h>
+#include <slotmap.h>
+#include <pthread.h>
+
+#define INT_CMP(a, b) (((a) > (b)) - ((a) < (b)))
+
+DECL_LL(int);
+DEF_LL(int);
+
+DECL_BT(int);
+DEF_BT(int);
+DECL_BT_PAR(int);
+DEF_BT_PAR(int);
+DECL_BST(int);
+DEF_BST(int);
+DECL_BST_BALANCED(int);
+DEF_BST_BALANCED(int, INT_CMP);
+
+DECL_SKIPLIST(int, int);
+DEF_SKIPLIST(int, int, INT_CMP);
+
+DECL_BTREE_MAP(int, int);
+DEF_BTREE_MAP(int, int, INT_CMP);
+
+DECL_HASHMAP(int, int);
+DEF_HASHMAP(int, int, HASHMAP_HASH_INT, HASHMAP_EQ);
+
+DECL_VEC(int);
+DEF_VEC(int);
+DECL_VEC_EYTZINGER(int);
+DEF_VEC_EYTZINGER(int, INT_CMP);
+DECL_HEAP(int);
+DEF_HEAP(int, INT_CMP, HEAP_DEFAULT_ARITY);
+
+// A binary heap, to compare against the default arity
+typedef int binary;
+DECL_VEC(binary);
+DEF_VEC(binary);
+DECL_HEAP(binary);
+DEF_HEAP(binary, INT_CMP, 2);
+
+// A wide record, stored both as an array of structs and as a struct of arrays
+#define BENCH_WIDE_FIELDS (double, a), (double, b), (double, c), (double, d), (double, e), (double, f), \
+    (double, g), (double, h), (double, i), (double, j), (double, k), (double, l)
+DECL_SOA_VEC(wide, BENCH_WIDE_FIELDS);
+DEF_SOA_VEC(wide, BENCH_WIDE_FIELDS);
+typedef SOA_VEC_ROW(wide) wide_row;
+DECL_VEC(wide_row);
+DEF_VEC(wide_row);
+
+DECL_PVEC(int);
+DEF_PVEC(int);
+
+DECL_GAPBUF(char);
+DEF_GAPBUF(char);
+
+DECL_VEC_PAR(int);
+DEF_VEC_PAR(int);
+DECL_VEC_SORTED(int);
+DEF_VEC_SORTED(int, INT_CMP);
+DECL_SEGVEC(int);
+DEF_SEGVEC(int);
+DECL_SLOTMAP(int);
+DEF_SLOTMAP(int);
+
+double bench_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/// The smallest size the benchmarks accept
+#define BENCH_MIN_SIZE 64
+
+void bench_report(const char* name, double seconds, size_t operations) {
+    if (operations == 0) {
+        printf("  %-40s %8.2f ms\n", name, seconds * 1e3);
+        return;
+    }
+    printf("  %-40s %8.2f ms %8.2f ns/op\n", name, seconds * 1e3, seconds * 1e9 / (double)operations);
+}
+
+void bench_shuffle(void** array, size_t length) {
+    if (length < 2) return;
+    for (size_t n = length - 1; n > 0; n--) {
+        size_t m = (size_t)rand() % (n + 1);
+        void* tmp = array[n];
+        array[n] = array[m];
+        array[m] = tmp;
+    }
+}
+
+// Builds `count` lists of `length` nodes each, whose nodes are scattered in memory
+void bench_ll_build(LL(int)** lists, size_t count, size_t length) {
+    if (length == 0) {
+        for (size_t n = 0; n < count; n++) lists[n] = NULL;
+        return;
+    }
+    LL(int)** nodes = malloc(sizeof(LL(int)*) * count * length);
+    for (size_t n = 0; n < count * length; n++) nodes[n] = int_ll_new((int)n);
+    bench_shuffle((void**)nodes, count * length);
+    for (size_t n = 0; n < count; n++) {
+        for (size_t m = 0; m < length; m++) {
+            nodes[n * length + m]->next = m + 1 < length ? nodes[n * length + m + 1] : NULL;
+        }
+        lists[n] = nodes[n * length];
+    }
+    free(nodes);
+}
+
+void bench_ll_sum(int* value, void* sum) {
+    *(long*)sum += *value;
+}
+
+void bench_ll(size_t size) {
+    printf("LinkedList traversal, %zu nodes (shuffled in memory):\n", size);
+    LL(int)* lists[LL_MULTI_WIDTH];
+    bench_ll_build(lists, LL_MULTI_WIDTH, size / LL_MULTI_WIDTH);
+    long sum = 0;
+    double start;
+
+    start = bench_now();
+    for (size_t n = 0; n < LL_MULTI_WIDTH; n++) {
+        for (LL(int)* node = lists[n]; node != NULL; node = node->next) bench_ll_sum(&node->value, &sum);
+    }
+    bench_report("plain loop", bench_now() - start, size);
+
+    start = bench_now();
+    size_t length = 0;
+    for (size_t n = 0; n < LL_MULTI_WIDTH; n++) length += int_ll_length(lists[n]);
+    bench_report("int_ll_length", bench_now() - start, length);
+
+    start = bench_now();
+    for (size_t n = 0; n < LL_MULTI_WIDTH; n++) int_ll_for_each(lists[n], bench_ll_sum, &sum);
+    bench_report("int_ll_for_each", bench_now() - start, size);
+
+    start = bench_now();
+    int_ll_for_each_multi(lists, LL_MULTI_WIDTH, bench_ll_sum, &sum);
+    bench_report("int_ll_for_each_multi", bench_now() - start, size);
+
+    for (size_t n = 0; n < LL_MULTI_WIDTH; n++) int_ll_free(lists[n]);
+    printf("  (checksum %ld)\n", sum);
+}
+
+// Random keys, in a random order
+int* bench_keys(size_t size) {
+    int* res = malloc(sizeof(int) * size);
+    for (size_t n = 0; n < size; n++) res[n] = rand();
+    return res;
+}
+
+void bench_ordered(size_t size) {
+    printf("Ordered structures, %zu random lookups among %zu keys:\n", size, size);
+    int* keys = bench_keys(size);
+    size_t found = 0;
+    double start;
+
+    BST(int)* bst = NULL;
+    for (size_t n = 0; n < size; n++) bst = int_bst_insert(bst, keys[n]);
+    start = bench_now();
+    for (size_t n = 0; n < size; n++) found += int_bst_find(bst, keys[(n * 7919) % size]) != NULL;
+    bench_report("int_bst_find", bench_now() - start, size);
+    int_bt_free(bst);
+
+    BST_BALANCED(int)* bbst = int_bbst_new();
+    for (size_t n = 0; n < size; n++) int_bbst_insert(bbst, keys[n]);
+    start = bench_now();
+    for (size_t n = 0; n < size; n++) found += int_bbst_find(bbst, keys[(n * 7919) % size]) != NULL;
+    bench_report("int_bbst_find", bench_now() - start, size);
+    int_bbst_free(bbst);
+
+    SKIPLIST(int, int)* skiplist = int_int_skiplist_new();
+    for (size_t n = 0; n < size; n++) int_int_skiplist_insert(skiplist, keys[n], 0);
+    start = bench_now();
+    for (size_t n = 0; n < size; n++) found += int_int_skiplist_find(skiplist, keys[(n * 7919) % size]) != NULL;
+    bench_report("int_int_skiplist_find", bench_now() - start, size);
+    int_int_skiplist_free(skiplist);
+
+    BTREE_MAP(int, int)* btree_map = int_int_btree_map_new();
+    for (size_t n = 0; n < size; n++) int_int_btree_map_insert(btree_map, keys[n], 0);
+    start = bench_now();
+    for (size_t n = 0; n < size; n++) found += int_int_btree_map_find(btree_map, keys[(n * 7919) % size]) != NULL;
+    bench_report("int_int_btree_map_find", bench_now() - start, size);
+    int_int_btree_map_free(btree_map);
+
+    HASHMAP(int, int)* hashmap = int_int_hashmap_new();
+    for (size_t n = 0; n < size; n++) int_int_hashmap_insert(hashmap, keys[n], 0);
+    start = bench_now();
+    for (size_t n = 0; n < size; n++) found += int_int_hashmap_find(hashmap, keys[(n * 7919) % size]) != NULL;
+    bench_report("int_int_hashmap_find", bench_now() - start, size);
+    int_int_hashmap_free(hashmap);
+
+    free(keys);
+    printf("  (found %zu)\n", found);
+}
+
+int bench_int_cmp(const void* a, const void* b) {
+    return INT_CMP(*(const int*)a, *(const int*)b);
+}
+
+// Textbook binary search on a sorted vector, for reference
+size_t bench_binary_search(const VEC(int)* sorted, int value) {
+    size_t low = 0, high = sorted->length;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (sorted->data[mid] < value) low = mid + 1;
+        else high = mid;
+    }
+    return low;
+}
+
+void bench_static(size_t size) {
+    printf("Static search, %zu random lower bounds among %zu keys:\n", size, size);
+    int* keys = bench_keys(size);
+    size_t checksum = 0;
+    double start;
+
+    BST(int)* bst = NULL;
+    for (size_t n = 0; n < size; n++) bst = int_bst_insert(bst, keys[n]);
+    start = bench_now();
+    for (size_t n = 0; n < size; n++) checksum += int_bst_lower_bound(bst, keys[(n * 7919) % size]) != NULL;
+    bench_report("int_bst_lower_bound", bench_now() - start, size);
+    int_bt_free(bst);
+
+    VEC(int)* sorted = int_vec_new(size);
+    for (size_t n = 0; n < size; n++) int_vec_push(sorted, keys[n]);
+    qsort(sorted->data, sorted->length, sizeof(int), bench_int_cmp);
+    start = bench_now();
+    for (size_t n = 0; n < size; n++) checksum += bench_binary_search(sorted, keys[(n * 7919) % size]);
+    bench_report("binary search", bench_now() - start, size);
+    start = bench_now();
+    for (size_t n = 0; n < size; n++) checksum += int_vec_lower_bound(sorted, keys[(n * 7919) % size]);
+    bench_report("int_vec_lower_bound", bench_now() - start, size);
+
+    VEC(int)* eytzinger = int_vec_build_eytzinger(sorted);
+    start = bench_now();
+    for (size_t n = 0; n < size; n++) checksum += int_vec_eytzinger_lower_bound(eytzinger, keys[(n * 7919) % size]);
+    bench_report("int_vec_eytzinger_lower_bound", bench_now() - start, size);
+
+    int_vec_free(sorted);
+    int_vec_free(eytzinger);
+    free(keys);
+    printf("  (checksum %zu)\n", checksum);
+}
+
+void bench_heap(size_t size) {
+    printf("Heaps, %zu random pushes, replace_tops and pops:\n", size);
+    int* keys = bench_keys(size);
+    long checksum = 0;
+    int value;
+    double start;
+
+    VEC(int)* heap = int_vec_new(16);
+    start = bench_now();
+    for (size_t n = 0; n < size; n++) int_heap_push(heap, keys[n]);
+    for (size_t n = 0; n < size; n++) {
+        int_heap_replace_top(heap, keys[(n * 7919) % size], &value);
+        checksum += value;
+    }
+    while (int_heap_pop(heap, &value)) checksum += value;
+    bench_report("int_heap (4-ary)", bench_now() - start, size * 3);
+    int_vec_free(heap);
+
+    VEC(binary)* binary_heap = binary_vec_new(16);
+    start = bench_now();
+    for (size_t n = 0; n < size; n++) binary_heap_push(binary_heap, keys[n]);
+    for (size_t n = 0; n < size; n++) {
+        binary_heap_replace_top(binary_heap, keys[(n * 7919) % size], &value);
+        checksum -= value;
+    }
+    while (binary_heap_pop(binary_heap, &value)) checksum -= value;
+    bench_report("binary_heap (2-ary)", bench_now() - start, size * 3);
+    binary_vec_free(binary_heap);
+
+    free(keys);
+    printf("  (checksum %ld)\n", checksum);
+}
+
+void bench_bitvec(size_t size) {
+    size_t bits = size * 64;
+    printf("Bit vectors, intersections of %zu bits:\n", bits);
+    BITVEC* a = bitvec_zeros(bits);
+    BITVEC* b = bitvec_zeros(bits);
+    for (size_t n = 0; n < bits / 8; n++) {
+        bitvec_set(a, (size_t)rand() % bits);
+        bitvec_set(b, (size_t)rand() % bits);
+    }
+    size_t checksum = 0;
+    double start;
+
+    start = bench_now();
+    for (int n = 0; n < 10; n++) checksum += bitvec_and_count(a, b);
+    bench_report("bitvec_and_count", bench_now() - start, bits / BITVEC_WORD_BITS * 10);
+
+    start = bench_now();
+    for (int n = 0; n < 10; n++) bitvec_and(a, b);
+    bench_report("bitvec_and", bench_now() - start, bits / BITVEC_WORD_BITS * 10);
+    checksum += bitvec_count(a);
+
+    bitvec_free(a);
+    bitvec_free(b);
+    printf("  (checksum %zu, ns/op are per 64-bit word)\n", checksum);
+}
+
+void bench_soa(size_t size) {
+    printf("Records of 12 doubles, sum of one field over %zu records:\n", size);
+    VEC(wide_row)* aos = wide_row_vec_new(size);
+    SOA_VEC(wide)* soa = wide_soa_new(size);
+    for (size_t n = 0; n < size; n++) {
+        wide_row row = {0};
+        row.c = (double)(rand() % 100);
+        wide_row_vec_push(aos, row);
+        wide_soa_push(soa, row);
+    }
+    double checksum = 0;
+    double start;
+
+    start = bench_now();
+    for (int round = 0; round < 10; round++) {
+        for (size_t n = 0; n < size; n++) checksum += aos->data[n].c;
+    }
+    bench_report("VEC(wide_row), field c", bench_now() - start, size * 10);
+
+    start = bench_now();
+    for (int round = 0; round < 10; round++) {
+        const double* c = wide_soa_slice_c(soa);
+        for (size_t n = 0; n < size; n++) checksum -= c[n];
+    }
+    bench_report("SOA_VEC(wide), field c", bench_now() - start, size * 10);
+
+    wide_row_vec_free(aos);
+    wide_soa_free(soa);
+    printf("  (checksum %g)\n", checksum);
+}
+
+void bench_pvec(size_t size) {
+    printf("Persistent vector, %zu values:\n", size);
+    long checksum = 0;
+    double start;
+
+    PVEC(int)* pvec = int_pvec_new();
+    start = bench_now();
+    for (size_t n = 0; n < size; n++) {
+        PVEC(int)* next = int_pvec_push(pvec, (int)n);
+        int_pvec_release(pvec);
+        pvec = next;
+    }
+    bench_report("int_pvec_push", bench_now() - start, size);
+
+    start = bench_now();
+    for (size_t n = 0; n < size; n++) checksum += *int_pvec_get(pvec, (n * 7919) % size);
+    bench_report("int_pvec_get", bench_now() - start, size);
+
+    VEC(int)* vec = int_vec_new(size);
+    for (size_t n = 0; n < size; n++) int_vec_push(vec, (int)n);
+    start = bench_now();
+    for (int n = 0; n < 100; n++) int_pvec_release(int_pvec_retain(pvec));
+    bench_report("snapshot: int_pvec_retain", bench_now() - start, 100);
+    start = bench_now();
+    for (int n = 0; n < 100; n++) int_vec_free(int_vec_clone(vec));
+    bench_report("snapshot: int_vec_clone", bench_now() - start, 100);
+
+    int_vec_free(vec);
+    int_pvec_release(pvec);
+    printf("  (checksum %ld)\n", checksum);
+}
+
+void bench_gapbuf(size_t size) {
+    printf("Edits at a drifting cursor in %zu characters:\n", size);
+    size_t edits = size;
+    size_t checksum = 0;
+    double start;
+
+    GAPBUF(char)* buffer = char_gapbuf_new(size * 2);
+    for (size_t n = 0; n < size; n++) char_gapbuf_insert(buffer, 'a');
+    size_t cursor = size / 2;
+    start = bench_now();
+    for (size_t n = 0; n < edits; n++) {
+        cursor = char_gapbuf_move_to(buffer, cursor + (size_t)(rand() % 64) - 31);
+        if (n % 2 == 0) char_gapbuf_insert(buffer, 'b');
+        else char_gapbuf_erase_before(buffer, 1);
+    }
+    bench_report("char_gapbuf insert/erase", bench_now() - start, edits);
+    checksum += char_gapbuf_length(buffer);
+    char_gapbuf_free(buffer);
+
+    // The same edits on a plain array, moving the whole tail each time
+    char* array = malloc(size * 2);
+    memset(array, 'a', size);
+    size_t length = size;
+    cursor = size / 2;
+    edits /= 16;
+    start = bench_now();
+    for (size_t n = 0; n < edits; n++) {
+        cursor += (size_t)(rand() % 64) - 31;
+        if (cursor > length) cursor = length;
+        if (n % 2 == 0) {
+            memmove(array + cursor + 1, array + cursor, length - cursor);
+            array[cursor] = 'b';
+            length++;
+        } else if (cursor > 0) {
+            memmove(array + cursor - 1, array + cursor, length - cursor);
+            length--;
+            cursor--;
+        }
+    }
+    bench_report("memmove insert/erase", bench_now() - start, edits);
+    checksum += length;
+    free(array);
+    printf("  (checksum %zu)\n", checksum);
+}
+
+// Builds a balanced tree holding the values [low, high)
+BT(int)* bench_bt_build(int low, int high) {
+    if (low >= high) return NULL;
+    int mid = low + (high - low) / 2;
+    return int_bt_connect(bench_bt_build(low, mid), bench_bt_build(mid + 1, high), mid);
+}
+
+bool bench_bt_equals(const int value, const void* data) {
+    return value == *(const int*)data;
+}
+
+void bench_bt_par(size_t size) {
+    printf("Parallel tree walks, %zu nodes, %zu threads:\n", size, lists_pool_threads());
+    BT(int)* tree = bench_bt_build(0, (int)size);
+    int missing = -1;
+    size_t checksum = 0;
+    double start;
+
+    start = bench_now();
+    checksum += int_bt_size(tree);
+    bench_report("int_bt_size", bench_now() - start, size);
+    start = bench_now();
+    checksum += int_bt_par_size(tree);
+    bench_report("int_bt_par_size", bench_now() - start, size);
+
+    start = bench_now();
+    checksum += int_bt_prefix_find(tree, bench_bt_equals, &missing) != NULL;
+    bench_report("int_bt_prefix_find", bench_now() - start, size);
+    start = bench_now();
+    checksum += int_bt_par_prefix_find(tree, bench_bt_equals, &missing) != NULL;
+    bench_report("int_bt_par_prefix_find", bench_now() - start, size);
+
+    start = bench_now();
+    BT(int)* clone = int_bt_clone(tree);
+    bench_report("int_bt_clone", bench_now() - start, size);
+    start = bench_now();
+    int_bt_free(clone);
+    bench_report("int_bt_free", bench_now() - start, size);
+
+    start = bench_now();
+    clone = int_bt_par_clone(tree);
+    bench_report("int_bt_par_clone", bench_now() - start, size);
+    start = bench_now();
+    int_bt_par_free(clone);
+    bench_report("int_bt_par_free", bench_now() - start, size);
+
+    int_bt_free(tree);
+    printf("  (checksum %zu)\n", checksum);
+}
+
+void bench_vec_par_scale(int* value, void* data) {
+    *value = (int)((unsigned)*value * 3u + (unsigned)*(int*)data);
+}
+
+int bench_vec_par_sum(int a, int b) {
+    return (int)((unsigned)a + (unsigned)b);
+}
+
+bool bench_vec_par_odd(const int* value, const void* data) {
+    (void)data;
+    return *value & 1;
+}
+
+void bench_vec_par(size_t size) {
+    printf("Parallel vector operations, %zu values, %zu threads:\n", size, lists_pool_threads());
+    VEC(int)* vec = int_vec_new(size);
+    for (size_t n = 0; n < size; n++) int_vec_push(vec, rand());
+    VEC(int)* dest = int_vec_new(size);
+    int offset = 1;
+    long checksum = 0;
+    double start;
+
+    start = bench_now();
+    for (size_t n = 0; n < size; n++) bench_vec_par_scale(&vec->data[n], &offset);
+    bench_report("serial for_each", bench_now() - start, size);
+    start = bench_now();
+    int_vec_par_for_each(vec, bench_vec_par_scale, &offset);
+    bench_report("int_vec_par_for_each", bench_now() - start, size);
+
+    start = bench_now();
+    checksum += int_vec_par_reduce(vec, 0, bench_vec_par_sum);
+    bench_report("int_vec_par_reduce", bench_now() - start, size);
+
+    start = bench_now();
+    checksum += (long)int_vec_par_filter_into(vec, dest, bench_vec_par_odd, NULL);
+    bench_report("int_vec_par_filter_into", bench_now() - start, size);
+
+    int_vec_free(dest);
+    int_vec_free(vec);
+    printf("  (checksum %ld)\n", checksum);
+}
+
+// Intersects two sorted vectors by walking both of them, one value at a time
+size_t bench_naive_intersection(const VEC(int)* a, const VEC(int)* b, VEC(int)* dest) {
+    size_t i = 0, j = 0;
+    while (i < a->length && j < b->length) {
+        if (a->data[i] < b->data[j]) i++;
+        else if (a->data[i] > b->data[j]) j++;
+        else {
+            int_vec_push(dest, a->data[i]);
+            i++;
+            j++;
+        }
+    }
+    return dest->length;
+}
+
+void bench_vec_sorted(size_t size) {
+    printf("Sorted vector intersections, %zu values against %zu and %zu values:\n", size, size, size / 64);
+    VEC(int)* a = int_vec_new(size);
+    VEC(int)* b = int_vec_new(size);
+    VEC(int)* c = int_vec_new(size / 64 + 1);
+    for (size_t n = 0; n < size; n++) int_vec_push(a, (int)(n * 2));
+    for (size_t n = 0; n < size; n++) int_vec_push(b, (int)(n * 3));
+    for (size_t n = 0; n < size / 64; n++) int_vec_push(c, (int)(n * 191));
+    VEC(int)* dest = int_vec_new(size);
+    size_t checksum = 0;
+    double start;
+
+    start = bench_now();
+    checksum += bench_naive_intersection(a, b, dest);
+    bench_report("naive intersection, same length", bench_now() - start, size);
+    dest->length = 0;
+    start = bench_now();
+    checksum += int_vec_intersection(a, b, dest);
+    bench_report("int_vec_intersection, same length", bench_now() - start, size);
+    dest->length = 0;
+
+    start = bench_now();
+    checksum += bench_naive_intersection(a, c, dest);
+    bench_report("naive intersection, 64x shorter", bench_now() - start, size);
+    dest->length = 0;
+    start = bench_now();
+    checksum += int_vec_intersection(a, c, dest);
+    bench_report("int_vec_intersection, 64x shorter", bench_now() - start, size);
+    dest->length = 0;
+
+    start = bench_now();
+    checksum += int_vec_merge(a, b, dest);
+    bench_report("int_vec_merge", bench_now() - start, size);
+
+    int_vec_free(dest);
+    int_vec_free(c);
+    int_vec_free(b);
+    int_vec_free(a);
+    printf("  (checksum %zu)\n", checksum);
+}
+
+#define BENCH_SEGVEC_THREADS 4
+
+struct bench_segvec_writer {
+    SEGVEC(int)* segvec;
+    size_t count;
+};
+
+void* bench_segvec_writer(void* data) {
+    struct bench_segvec_writer* writer = (struct bench_segvec_writer*)data;
+    for (size_t n = 0; n < writer->count; n++) int_segvec_push(writer->segvec, (int)n, NULL);
+    return NULL;
+}
+
+void bench_segvec(size_t size) {
+    printf("Segmented vector, %zu values:\n", size);
+    long checksum = 0;
+    double start;
+
+    VEC(int)* vec = int_vec_new(1);
+    start = bench_now();
+    for (size_t n = 0; n < size; n++) int_vec_push(vec, (int)n);
+    bench_report("int_vec_push", bench_now() - start, size);
+    SEGVEC(int)* segvec = int_segvec_new();
+    start = bench_now();
+    for (size_t n = 0; n < size; n++) int_segvec_push(segvec, (int)n, NULL);
+    bench_report("int_segvec_push", bench_now() - start, size);
+
+    start = bench_now();
+    for (size_t n = 0; n < size; n++) checksum += *int_vec_get(vec, (n * 7919) % size);
+    bench_report("int_vec_get", bench_now() - start, size);
+    start = bench_now();
+    for (size_t n = 0; n < size; n++) checksum += *int_segvec_get(segvec, (n * 7919) % size);
+    bench_report("int_segvec_get", bench_now() - start, size);
+    int_segvec_free(segvec);
+
+    segvec = int_segvec_new();
+    pthread_t threads[BENCH_SEGVEC_THREADS];
+    struct bench_segvec_writer writer = {segvec, size / BENCH_SEGVEC_THREADS};
+    start = bench_now();
+    for (int n = 0; n < BENCH_SEGVEC_THREADS; n++) pthread_create(&threads[n], NULL, bench_segvec_writer, &writer);
+    for (int n = 0; n < BENCH_SEGVEC_THREADS; n++) pthread_join(threads[n], NULL);
+    bench_report("int_segvec_push, 4 threads", bench_now() - start, writer.count * BENCH_SEGVEC_THREADS);
+    checksum += (long)int_segvec_length(segvec);
+
+    int_segvec_free(segvec);
+    int_vec_free(vec);
+    printf("  (checksum %ld)\n", checksum);
+}
+
+bool bench_slotmap_equal(const int* value, const void* data) {
+    return *value == *(const int*)data;
+}
+
+void bench_slotmap(size_t size) {
+    printf("Slot map, %zu values:\n", size);
+    uint64_t* handles = (uint64_t*)malloc(sizeof(uint64_t) * size);
+    long checksum = 0;
+    double start;
+
+    SLOTMAP(int)* map = int_slotmap_new(0);
+    start = bench_now();
+    for (size_t n = 0; n < size; n++) handles[n] = int_slotmap_insert(map, (int)n);
+    bench_report("int_slotmap_insert", bench_now() - start, size);
+
+    start = bench_now();
+    for (size_t n = 0; n < size; n++) checksum += *int_slotmap_get(map, handles[(n * 7919) % size]);
+    bench_report("int_slotmap_get", bench_now() - start, size);
+
+    // Looking values up by content is what a slot map replaces; it is linear, so only a few lookups are timed
+    VEC(int)* vec = int_vec_new(size);
+    for (size_t n = 0; n < size; n++) int_vec_push(vec, (int)n);
+    size_t lookups = 100;
+    start = bench_now();
+    for (size_t n = 0; n < lookups; n++) {
+        int key = (int)((n * 7919) % size);
+        checksum += int_vec_find(vec, bench_slotmap_equal, &key);
+    }
+    bench_report("int_vec_find", bench_now() - start, lookups);
+
+    start = bench_now();
+    for (size_t n = 0; n < size; n += 2) int_slotmap_remove(map, handles[(n * 7919) % size], NULL);
+    bench_report("int_slotmap_remove", bench_now() - start, (size + 1) / 2);
+
+    start = bench_now();
+    int* values = int_slotmap_values(map);
+    for (size_t n = 0; n < int_slotmap_length(map); n++) checksum += values[n];
+    bench_report("dense iteration", bench_now() - start, int_slotmap_length(map));
+
+    int_vec_free(vec);
+    int_slotmap_free(map);
+    free(handles);
+    printf("  (checksum %ld)\n", checksum);
+}
+
+int main(int argc, char* argv[]) {
+    // The default size is chosen so that the structures do not fit in the last-level cache
+    size_t size = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : (size_t)1 << 22;
+    // Some benchmarks split the values into LL_MULTI_WIDTH lists, or into a vector 64 times shorter
+    if (size < BENCH_MIN_SIZE) {
+        fprintf(stderr, "size %zu is too small, using %d instead\n", size, BENCH_MIN_SIZE);
+        size = BENCH_MIN_SIZE;
+    }
+    srand(0);
+
+    bench_ll(size);
+    bench_ordered(size);
+    bench_static(size);
+    bench_heap(size);
+    bench_bitvec(size);
+    bench_soa(size);
+    bench_pvec(size);
+    bench_gapbuf(size);
+    bench_bt_par(size);
+    bench_vec_par(size);
+    bench_vec_sorted(size);
+    bench_segvec(size);
+    bench_slotmap(size);
+
+    return EXIT_SUCCESS;
+}
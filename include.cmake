@@ -2,8 +2,19 @@ cmake_minimum_required(VERSION 3.15)
 
 set(LISTS_C_INCLUDE_DIR "${CMAKE_CURRENT_LIST_DIR}/src")
 
-set(LISTS_C_SOURCES "${CMAKE_CURRENT_LIST_DIR}/src/linkedlist.c")
-set(LISTS_C_HEADERS "${CMAKE_CURRENT_LIST_DIR}/src/linkedlist.h" "${CMAKE_CURRENT_LIST_DIR}/src/btree.h" "${CMAKE_CURRENT_LIST_DIR}/src/bstree.h" "${CMAKE_CURRENT_LIST_DIR}/src/vec.h")
+set(LISTS_C_SOURCES "${CMAKE_CURRENT_LIST_DIR}/src/linkedlist.c" "${CMAKE_CURRENT_LIST_DIR}/src/threadpool.c" "${CMAKE_CURRENT_LIST_DIR}/src/bitvec.c")
+set(LISTS_C_HEADERS "${CMAKE_CURRENT_LIST_DIR}/src/linkedlist.h" "${CMAKE_CURRENT_LIST_DIR}/src/btree.h" "${CMAKE_CURRENT_LIST_DIR}/src/bstree.h" "${CMAKE_CURRENT_LIST_DIR}/src/vec.h" "${CMAKE_CURRENT_LIST_DIR}/src/ring.h" "${CMAKE_CURRENT_LIST_DIR}/src/llstack.h" "${CMAKE_CURRENT_LIST_DIR}/src/skiplist.h" "${CMAKE_CURRENT_LIST_DIR}/src/btreemap.h" "${CMAKE_CURRENT_LIST_DIR}/src/threadpool.h" "${CMAKE_CURRENT_LIST_DIR}/src/btree_par.h" "${CMAKE_CURRENT_LIST_DIR}/src/btree_arena.h" "${CMAKE_CURRENT_LIST_DIR}/src/btree_io.h" "${CMAKE_CURRENT_LIST_DIR}/src/btree_bfs.h" "${CMAKE_CURRENT_LIST_DIR}/src/hashmap.h" "${CMAKE_CURRENT_LIST_DIR}/src/heap.h" "${CMAKE_CURRENT_LIST_DIR}/src/bitvec.h" "${CMAKE_CURRENT_LIST_DIR}/src/vec_soa.h" "${CMAKE_CURRENT_LIST_DIR}/src/pvec.h" "${CMAKE_CURRENT_LIST_DIR}/src/gapbuf.h" "${CMAKE_CURRENT_LIST_DIR}/src/vec_par.h" "${CMAKE_CURRENT_LIST_DIR}/src/segvec.h" "${CMAKE_CURRENT_LIST_DIR}/src/slotmap.h")
 set(LISTS_C_VERSION "1.3.0")
 
 add_library(lists-c ${LISTS_C_SOURCES} ${LISTS_C_HEADERS})
+set_target_properties(lists-c PROPERTIES C_STANDARD 11)
+
+# The lock-free structures and the thread pool need threads and, on some platforms, libatomic for double-width compare-and-swap
+find_package(Threads REQUIRED)
+target_link_libraries(lists-c PUBLIC Threads::Threads)
+
+include(CheckLibraryExists)
+check_library_exists(atomic __atomic_compare_exchange_16 "" LISTS_C_HAS_LIBATOMIC)
+if(LISTS_C_HAS_LIBATOMIC)
+    target_link_libraries(lists-c PUBLIC atomic)
+endif()
@@ -0,0 +1,254 @@
+#include <stdlib.h>
+#include <string.h>
+#include "bitvec.h"
+#if defined(__AVX2__) || defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+static size_t bitvec_words(size_t bits) {
+    return (bits + BITVEC_WORD_BITS - 1) / BITVEC_WORD_BITS;
+}
+
+static unsigned bitvec_trailing_zeros(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(word);
+#else
+    unsigned res = 0;
+    while (!(word & 1)) {
+        word >>= 1;
+        res++;
+    }
+    return res;
+#endif
+}
+
+static size_t bitvec_popcount(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (size_t)__builtin_popcountll(word);
+#else
+    size_t res = 0;
+    for (; word; word &= word - 1) res++;
+    return res;
+#endif
+}
+
+// Returns the index of the set bit of `word` that has `rank` set bits below it; `word` must have more than `rank` set bits
+static unsigned bitvec_select_word(uint64_t word, size_t rank) {
+#if defined(__BMI2__)
+    return bitvec_trailing_zeros(_pdep_u64((uint64_t)1 << rank, word));
+#else
+    for (; rank > 0; rank--) word &= word - 1;
+    return bitvec_trailing_zeros(word);
+#endif
+}
+
+// Clears the bits of the last word that lie past `length`
+static void bitvec_trim(BITVEC* bitvec) {
+    if (bitvec->length % BITVEC_WORD_BITS != 0) {
+        bitvec->words[bitvec->length / BITVEC_WORD_BITS] &= ((uint64_t)1 << (bitvec->length % BITVEC_WORD_BITS)) - 1;
+    }
+}
+
+BITVEC* bitvec_new(size_t capacity) {
+    BITVEC* res = (BITVEC*)malloc(sizeof(struct bitvec));
+    if (res == NULL) return NULL;
+    size_t words = bitvec_words(capacity);
+    res->capacity = words * BITVEC_WORD_BITS;
+    res->length = 0;
+    res->words = (uint64_t*)malloc(sizeof(uint64_t) * (words > 0 ? words : 1));
+    if (res->words == NULL) {
+        free(res);
+        return NULL;
+    }
+    return res;
+}
+
+BITVEC* bitvec_zeros(size_t length) {
+    BITVEC* res = (BITVEC*)malloc(sizeof(struct bitvec));
+    if (res == NULL) return NULL;
+    size_t words = bitvec_words(length);
+    res->capacity = words * BITVEC_WORD_BITS;
+    res->length = length;
+    res->words = (uint64_t*)calloc(words > 0 ? words : 1, sizeof(uint64_t));
+    if (res->words == NULL) {
+        free(res);
+        return NULL;
+    }
+    return res;
+}
+
+void bitvec_free(BITVEC* bitvec) {
+    if (bitvec == NULL) return;
+    free(bitvec->words);
+    free(bitvec);
+}
+
+size_t bitvec_length(const BITVEC* bitvec) {
+    if (bitvec == NULL) return 0;
+    return bitvec->length;
+}
+
+size_t bitvec_capacity(const BITVEC* bitvec) {
+    if (bitvec == NULL) return 0;
+    return bitvec->capacity;
+}
+
+size_t bitvec_resize(BITVEC* bitvec, size_t new_capacity) {
+    if (bitvec == NULL) return 0;
+    if (new_capacity == 0) return bitvec->capacity;
+    if (new_capacity < bitvec->length) new_capacity = bitvec->length;
+    size_t words = bitvec_words(new_capacity);
+    if (words == 0) return 0;
+    uint64_t* new_words = (uint64_t*)realloc((void*)bitvec->words, sizeof(uint64_t) * words);
+    if (new_words == NULL) return 0;
+    bitvec->words = new_words;
+    bitvec->capacity = words * BITVEC_WORD_BITS;
+    return bitvec->capacity;
+}
+
+size_t bitvec_push(BITVEC* bitvec, bool value) {
+    if (bitvec == NULL) return 0;
+    if (bitvec->length == bitvec->capacity) {
+        if (bitvec_resize(bitvec, bitvec->capacity * 2) == 0) return 0;
+    }
+    size_t word = bitvec->length / BITVEC_WORD_BITS;
+    uint64_t bit = (uint64_t)1 << (bitvec->length % BITVEC_WORD_BITS);
+    // The words past the length are uninitialized until the first bit is pushed to them
+    if (bit == 1) bitvec->words[word] = 0;
+    if (value) bitvec->words[word] |= bit;
+    bitvec->length += 1;
+    return bitvec->length;
+}
+
+bool bitvec_pop(BITVEC* bitvec) {
+    if (bitvec == NULL || bitvec->length == 0) return false;
+    bool res = bitvec_test(bitvec, bitvec->length - 1);
+    bitvec->length -= 1;
+    bitvec_trim(bitvec);
+    return res;
+}
+
+void bitvec_set(BITVEC* bitvec, size_t index) {
+    if (bitvec == NULL || index >= bitvec->length) return;
+    bitvec->words[index / BITVEC_WORD_BITS] |= (uint64_t)1 << (index % BITVEC_WORD_BITS);
+}
+
+void bitvec_clear(BITVEC* bitvec, size_t index) {
+    if (bitvec == NULL || index >= bitvec->length) return;
+    bitvec->words[index / BITVEC_WORD_BITS] &= ~((uint64_t)1 << (index % BITVEC_WORD_BITS));
+}
+
+bool bitvec_test(const BITVEC* bitvec, size_t index) {
+    if (bitvec == NULL || index >= bitvec->length) return false;
+    return (bitvec->words[index / BITVEC_WORD_BITS] >> (index % BITVEC_WORD_BITS)) & 1;
+}
+
+size_t bitvec_first_set(const BITVEC* bitvec) {
+    return bitvec_next_set(bitvec, 0);
+}
+
+size_t bitvec_next_set(const BITVEC* bitvec, size_t from) {
+    if (bitvec == NULL) return 0;
+    if (from >= bitvec->length) return bitvec->length;
+    size_t words = bitvec_words(bitvec->length);
+    size_t word = from / BITVEC_WORD_BITS;
+    // Bits past the length are clear, so they are never found
+    uint64_t bits = bitvec->words[word] & (~(uint64_t)0 << (from % BITVEC_WORD_BITS));
+    while (bits == 0) {
+        if (++word == words) return bitvec->length;
+        bits = bitvec->words[word];
+    }
+    return word * BITVEC_WORD_BITS + bitvec_trailing_zeros(bits);
+}
+
+size_t bitvec_count(const BITVEC* bitvec) {
+    if (bitvec == NULL) return 0;
+    return bitvec_rank(bitvec, bitvec->length);
+}
+
+size_t bitvec_rank(const BITVEC* bitvec, size_t index) {
+    if (bitvec == NULL) return 0;
+    if (index > bitvec->length) index = bitvec->length;
+    size_t res = 0;
+    size_t full = index / BITVEC_WORD_BITS;
+    for (size_t n = 0; n < full; n++) res += bitvec_popcount(bitvec->words[n]);
+    if (index % BITVEC_WORD_BITS != 0) {
+        res += bitvec_popcount(bitvec->words[full] & (((uint64_t)1 << (index % BITVEC_WORD_BITS)) - 1));
+    }
+    return res;
+}
+
+size_t bitvec_select(const BITVEC* bitvec, size_t rank) {
+    if (bitvec == NULL) return 0;
+    size_t words = bitvec_words(bitvec->length);
+    for (size_t n = 0; n < words; n++) {
+        size_t count = bitvec_popcount(bitvec->words[n]);
+        if (rank < count) return n * BITVEC_WORD_BITS + bitvec_select_word(bitvec->words[n], rank);
+        rank -= count;
+    }
+    return bitvec->length;
+}
+
+// Applies `dest[n] = dest[n] op src[n]` to `count` words; `simd` is the equivalent AVX2 intrinsic, which handles 4 words at a time
+#if defined(__AVX2__)
+#define BITVEC_BULK(name, simd, op) \
+    static void bitvec_##name##_words(uint64_t* dest, const uint64_t* src, size_t count) { \
+        size_t n = 0; \
+        for (; n + 4 <= count; n += 4) { \
+            __m256i a = _mm256_loadu_si256((const __m256i*)(dest + n)); \
+            __m256i b = _mm256_loadu_si256((const __m256i*)(src + n)); \
+            _mm256_storeu_si256((__m256i*)(dest + n), simd(a, b)); \
+        } \
+        for (; n < count; n++) dest[n] = dest[n] op src[n]; \
+    }
+#define BITVEC_ANDNOT(a, b) _mm256_andnot_si256(b, a)
+#else
+#define BITVEC_BULK(name, simd, op) \
+    static void bitvec_##name##_words(uint64_t* dest, const uint64_t* src, size_t count) { \
+        for (size_t n = 0; n < count; n++) dest[n] = dest[n] op src[n]; \
+    }
+#endif
+
+BITVEC_BULK(and, _mm256_and_si256, &)
+BITVEC_BULK(or, _mm256_or_si256, |)
+BITVEC_BULK(xor, _mm256_xor_si256, ^)
+BITVEC_BULK(andnot, BITVEC_ANDNOT, & ~)
+
+// Returns the number of words that both `dest` and `src` have
+static size_t bitvec_common_words(const BITVEC* dest, const BITVEC* src) {
+    size_t dest_words = bitvec_words(dest->length);
+    size_t src_words = bitvec_words(src->length);
+    return dest_words < src_words ? dest_words : src_words;
+}
+
+void bitvec_and(BITVEC* dest, const BITVEC* src) {
+    if (dest == NULL || src == NULL) return;
+    size_t common = bitvec_common_words(dest, src);
+    bitvec_and_words(dest->words, src->words, common);
+    memset(dest->words + common, 0, sizeof(uint64_t) * (bitvec_words(dest->length) - common));
+}
+
+void bitvec_or(BITVEC* dest, const BITVEC* src) {
+    if (dest == NULL || src == NULL) return;
+    bitvec_or_words(dest->words, src->words, bitvec_common_words(dest, src));
+    bitvec_trim(dest);
+}
+
+void bitvec_xor(BITVEC* dest, const BITVEC* src) {
+    if (dest == NULL || src == NULL) return;
+    bitvec_xor_words(dest->words, src->words, bitvec_common_words(dest, src));
+    bitvec_trim(dest);
+}
+
+void bitvec_andnot(BITVEC* dest, const BITVEC* src) {
+    if (dest == NULL || src == NULL) return;
+    bitvec_andnot_words(dest->words, src->words, bitvec_common_words(dest, src));
+}
+
+size_t bitvec_and_count(const BITVEC* a, const BITVEC* b) {
+    if (a == NULL || b == NULL) return 0;
+    size_t common = bitvec_common_words(a, b);
+    size_t res = 0;
+    for (size_t n = 0; n < common; n++) res += bitvec_popcount(a->words[n] & b->words[n]);
+    return res;
+}
@@ -0,0 +1,155 @@
+#ifndef BITVEC_H
+#define BITVEC_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define BITVEC bitvec_t
+
+/// The number of bits held by each word of a BITVEC
+#define BITVEC_WORD_BITS 64
+
+/** @struct bitvec
+
+    A scalable array of bits, packed in 64-bit words: it takes 8 times less memory than a `VEC(bool)`, and most operations handle 64 bits at a time.
+    The bits past `length` in the last word are always clear.
+**/
+struct bitvec {
+    uint64_t* words;
+    size_t capacity;
+    size_t length;
+};
+
+/** @typedef bitvec_t
+
+    Resolves to `struct bitvec`; can also be accessed with `BITVEC`.
+**/
+typedef struct bitvec BITVEC;
+
+/** @fn bitvec_new(size_t capacity)
+    @param capacity The capacity in number of bits
+    @returns A new, empty bit vector, or NULL on allocation failure
+
+    Like `TYPE_vec_new`, pushing to a bit vector of null capacity will not work until it is resized.
+**/
+BITVEC* bitvec_new(size_t capacity);
+
+/** @fn bitvec_zeros(size_t length)
+    @param length The number of bits
+    @returns A new bit vector of `length` clear bits, or NULL on allocation failure
+**/
+BITVEC* bitvec_zeros(size_t length);
+
+/** @fn bitvec_free(BITVEC* bitvec)
+    @param bitvec The bit vector to free
+**/
+void bitvec_free(BITVEC* bitvec);
+
+/** @fn bitvec_length(const BITVEC* bitvec)
+    @returns The number of bits of `bitvec`, 0 if NULL
+**/
+size_t bitvec_length(const BITVEC* bitvec);
+
+/** @fn bitvec_capacity(const BITVEC* bitvec)
+    @returns The number of bits `bitvec` can hold without being resized, 0 if NULL
+**/
+size_t bitvec_capacity(const BITVEC* bitvec);
+
+/** @fn bitvec_resize(BITVEC* bitvec, size_t new_capacity)
+    @param bitvec The bit vector whose capacity is to change
+    @param new_capacity The new capacity in bits, rounded up to a multiple of 64. Must be non-null, or else nothing is done.
+    @returns The new capacity, or 0 on allocation failure
+
+    Behaves like `TYPE_vec_resize`: the capacity is never shrunk below the length, so `bitvec_resize(bitvec, 1)` shrinks `bitvec` to fit.
+**/
+size_t bitvec_resize(BITVEC* bitvec, size_t new_capacity);
+
+/** @fn bitvec_push(BITVEC* bitvec, bool value)
+    @returns The new length, or 0 if the bit vector could not grow
+
+    Appends a bit to `bitvec`; the capacity is doubled when it is full, like with `TYPE_vec_push`.
+**/
+size_t bitvec_push(BITVEC* bitvec, bool value);
+
+/** @fn bitvec_pop(BITVEC* bitvec)
+    @returns The last bit of `bitvec`, which is removed, or false if it is empty
+**/
+bool bitvec_pop(BITVEC* bitvec);
+
+/** @fn bitvec_set(BITVEC* bitvec, size_t index)
+    Sets the bit at `index`; does nothing if `index` is out of bounds.
+**/
+void bitvec_set(BITVEC* bitvec, size_t index);
+
+/** @fn bitvec_clear(BITVEC* bitvec, size_t index)
+    Clears the bit at `index`; does nothing if `index` is out of bounds.
+**/
+void bitvec_clear(BITVEC* bitvec, size_t index);
+
+/** @fn bitvec_test(const BITVEC* bitvec, size_t index)
+    @returns The bit at `index`, or false if `index` is out of bounds
+**/
+bool bitvec_test(const BITVEC* bitvec, size_t index);
+
+/** @fn bitvec_first_set(const BITVEC* bitvec)
+    @returns The index of the first set bit, or the length of `bitvec` if there is none
+**/
+size_t bitvec_first_set(const BITVEC* bitvec);
+
+/** @fn bitvec_next_set(const BITVEC* bitvec, size_t from)
+    @returns The index of the first set bit at or after `from`, or the length of `bitvec` if there is none
+
+    Iterating over the set bits with `for (size_t n = bitvec_first_set(b); n < bitvec_length(b); n = bitvec_next_set(b, n + 1))` skips clear words 64 bits at a time.
+**/
+size_t bitvec_next_set(const BITVEC* bitvec, size_t from);
+
+/** @fn bitvec_count(const BITVEC* bitvec)
+    @returns The number of set bits of `bitvec`
+**/
+size_t bitvec_count(const BITVEC* bitvec);
+
+/** @fn bitvec_rank(const BITVEC* bitvec, size_t index)
+    @returns The number of set bits before `index`, ie. in `[0, index)`
+
+    Counts the bits word by word, in `O(index / 64)`.
+**/
+size_t bitvec_rank(const BITVEC* bitvec, size_t index);
+
+/** @fn bitvec_select(const BITVEC* bitvec, size_t rank)
+    @returns The index of the set bit that has `rank` set bits before it, or the length of `bitvec` if there are not that many set bits
+
+    The inverse of `bitvec_rank`: `bitvec_rank(b, bitvec_select(b, r)) == r` for every `r < bitvec_count(b)`.
+**/
+size_t bitvec_select(const BITVEC* bitvec, size_t rank);
+
+/** @fn bitvec_and(BITVEC* dest, const BITVEC* src)
+    @param dest The bit vector to modify
+    @param src The other operand; its missing bits, if it is shorter than `dest`, are considered clear
+
+    Sets `dest` to `dest & src`; the length of `dest` is left unchanged.
+    The bulk operations use AVX2 when the library is compiled with it (`-mavx2`), and go 64 bits at a time otherwise.
+**/
+void bitvec_and(BITVEC* dest, const BITVEC* src);
+
+/** @fn bitvec_or(BITVEC* dest, const BITVEC* src)
+    Sets `dest` to `dest | src`, like `bitvec_and`; the bits of `src` past the length of `dest` are ignored.
+**/
+void bitvec_or(BITVEC* dest, const BITVEC* src);
+
+/** @fn bitvec_xor(BITVEC* dest, const BITVEC* src)
+    Sets `dest` to `dest ^ src`, like `bitvec_and`; the bits of `src` past the length of `dest` are ignored.
+**/
+void bitvec_xor(BITVEC* dest, const BITVEC* src);
+
+/** @fn bitvec_andnot(BITVEC* dest, const BITVEC* src)
+    Sets `dest` to `dest & ~src`, ie. clears the bits of `dest` that are set in `src`.
+**/
+void bitvec_andnot(BITVEC* dest, const BITVEC* src);
+
+/** @fn bitvec_and_count(const BITVEC* a, const BITVEC* b)
+    @returns The number of bits set in both `a` and `b`, without building their intersection
+**/
+size_t bitvec_and_count(const BITVEC* a, const BITVEC* b);
+
+#endif // BITVEC_H
@@ -3,7 +3,9 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include "linkedlist.h"
+#include "vec.h"
 
 #define BST(type) type##_bst_t
 
@@ -17,7 +19,14 @@
     The new `BST(type)` type is effectively a typedef on `struct TYPE_bt`, and thus it can be used interchangeably with `BT(type)` and BT-associated functions.
 **/
 #define DECL_BST(type) typedef struct type##_bt BST(type); \
-    BST(type)* type##_bst_insert(BST(type)* tree, type value);
+    BST(type)* type##_bst_insert(BST(type)* tree, type value); \
+    BST(type)* type##_bst_erase(BST(type)* tree, type value); \
+    BST(type)* type##_bst_find(BST(type)* tree, type value); \
+    BST(type)* type##_bst_lower_bound(BST(type)* tree, type value); \
+    BST(type)* type##_bst_upper_bound(BST(type)* tree, type value); \
+    size_t type##_bst_range_count(BST(type)* tree, type lo, type hi); \
+    size_t type##_bst_for_each_in_range(BST(type)* tree, type lo, type hi, bool (*callback)(const type*, void*), void* callback_data); \
+    bool type##_bst_cursor_seek(BT_CURSOR(type)* cursor, type value);
 
 /**
     @def DECL_BST_LL
@@ -32,25 +41,162 @@
     LL(type)* type##_bst_sort_ll(LL(type)* list);
 
 /**
-    @def DEF_BST
+    @def DECL_BST_VEC
     @param type The type of the BST
 
-    Defines the BST-associated functions.
+    Declares the BST-associated functions that allow the usage of BSTs with vectors of `type` (VEC).
+    This macro requires `DECL_BT(type)`, `DECL_BST(type)` and `DECL_VEC(type)` to have been called beforehand.
+**/
+#define DECL_BST_VEC(type) \
+    BST(type)* type##_bst_from_sorted_vec(const VEC(type)* vec); \
+    size_t type##_bst_into_vec(BST(type)* tree, VEC(type)* vec);
+
+/// The comparison used by `DEF_BST`: orders values with the `<` and `>` operators
+#define BST_DEFAULT_CMP(a, b) (((a) > (b)) - ((a) < (b)))
+
+/**
+    @def DEF_BST_CMP
+    @param type The type of the BST
+    @param cmp A function or macro taking two values `a` and `b` and returning a negative value if `a < b`, a positive value if `a > b` and 0 if they are equal
+
+    Defines the BST-associated functions, ordering the values with `cmp`.
+    `cmp` is expanded inline, so that a macro or a `static inline` function costs no call.
     Requires `DECL_BT(type)`, `DECL_BST(type)` and `DEF_BT(type)` to have been called beforehand.
+
+    ## Example
+
+    ```c
+    typedef struct { int id; float weight; } item;
+    #define ITEM_CMP(a, b) (((a).id > (b).id) - ((a).id < (b).id))
+
+    DECL_BT(item);
+    DEF_BT(item);
+    DECL_BST(item);
+    DEF_BST_CMP(item, ITEM_CMP);
+    ```
 **/
-#define DEF_BST(type) \
+#define DEF_BST_CMP(type, cmp) \
     BST(type)* type##_bst_insert(BST(type)* tree, type value) { \
         if (tree == NULL) return type##_bt_new(value); \
         else { \
-            if (value < tree->value) { \
+            if (cmp(value, tree->value) < 0) { \
                 tree->left = type##_bst_insert(tree->left, value); \
             } else { \
                 tree->right = type##_bst_insert(tree->right, value); \
             } \
             return tree; \
         } \
+    } \
+    BST(type)* type##_bst_erase(BST(type)* tree, type value) { \
+        if (tree == NULL) return NULL; \
+        int order = cmp(value, tree->value); \
+        if (order < 0) { \
+            tree->left = type##_bst_erase(tree->left, value); \
+            return tree; \
+        } else if (order > 0) { \
+            tree->right = type##_bst_erase(tree->right, value); \
+            return tree; \
+        } \
+        BST(type)* res; \
+        if (tree->left == NULL) { \
+            res = tree->right; \
+        } else if (tree->right == NULL) { \
+            res = tree->left; \
+        } else { \
+            /* The leftmost node of the right subtree takes the place of the removed node */ \
+            BST(type)** link = &tree->right; \
+            while ((*link)->left != NULL) link = &(*link)->left; \
+            res = *link; \
+            *link = res->right; \
+            res->left = tree->left; \
+            res->right = tree->right; \
+        } \
+        free(tree); \
+        return res; \
+    } \
+    BST(type)* type##_bst_find(BST(type)* tree, type value) { \
+        while (tree != NULL) { \
+            int order = cmp(value, tree->value); \
+            if (order == 0) return tree; \
+            tree = order < 0 ? tree->left : tree->right; \
+        } \
+        return NULL; \
+    } \
+    BST(type)* type##_bst_lower_bound(BST(type)* tree, type value) { \
+        BST(type)* res = NULL; \
+        while (tree != NULL) { \
+            if (cmp(tree->value, value) >= 0) { \
+                res = tree; \
+                tree = tree->left; \
+            } else { \
+                tree = tree->right; \
+            } \
+        } \
+        return res; \
+    } \
+    BST(type)* type##_bst_upper_bound(BST(type)* tree, type value) { \
+        BST(type)* res = NULL; \
+        while (tree != NULL) { \
+            if (cmp(tree->value, value) > 0) { \
+                res = tree; \
+                tree = tree->left; \
+            } else { \
+                tree = tree->right; \
+            } \
+        } \
+        return res; \
+    } \
+    /* Left subtrees only hold smaller values and right subtrees only hold greater or equal values, so subtrees outside of [lo, hi) are skipped */ \
+    static bool type##_bst_for_each_in_range_rec(BST(type)* tree, type lo, type hi, bool (*callback)(const type*, void*), void* callback_data, size_t* count) { \
+        if (tree == NULL) return true; \
+        bool above_lo = cmp(tree->value, lo) >= 0; \
+        bool below_hi = cmp(tree->value, hi) < 0; \
+        if (above_lo && !type##_bst_for_each_in_range_rec(tree->left, lo, hi, callback, callback_data, count)) return false; \
+        if (above_lo && below_hi) { \
+            *count += 1; \
+            if (callback != NULL && !callback(&tree->value, callback_data)) return false; \
+        } \
+        if (below_hi) return type##_bst_for_each_in_range_rec(tree->right, lo, hi, callback, callback_data, count); \
+        return true; \
+    } \
+    size_t type##_bst_range_count(BST(type)* tree, type lo, type hi) { \
+        size_t res = 0; \
+        type##_bst_for_each_in_range_rec(tree, lo, hi, NULL, NULL, &res); \
+        return res; \
+    } \
+    size_t type##_bst_for_each_in_range(BST(type)* tree, type lo, type hi, bool (*callback)(const type*, void*), void* callback_data) { \
+        size_t res = 0; \
+        type##_bst_for_each_in_range_rec(tree, lo, hi, callback, callback_data, &res); \
+        return res; \
+    } \
+    bool type##_bst_cursor_seek(BT_CURSOR(type)* cursor, type value) { \
+        if (cursor == NULL) return false; \
+        cursor->depth = 0; \
+        /* The path to the lower bound is a prefix of the search path: keep the descent and cut it after the last candidate */ \
+        size_t found = 0; \
+        BST(type)* tree = cursor->root; \
+        while (tree != NULL) { \
+            if (!type##_bt_cursor_push(cursor, tree)) return false; \
+            if (cmp(tree->value, value) >= 0) { \
+                found = cursor->depth; \
+                tree = tree->left; \
+            } else { \
+                tree = tree->right; \
+            } \
+        } \
+        cursor->depth = found; \
+        return found > 0; \
     }
 
+/**
+    @def DEF_BST
+    @param type The type of the BST
+
+    Defines the BST-associated functions, ordering the values with the `<` and `>` operators.
+    Requires `DECL_BT(type)`, `DECL_BST(type)` and `DEF_BT(type)` to have been called beforehand.
+**/
+#define DEF_BST(type) DEF_BST_CMP(type, BST_DEFAULT_CMP)
+
 /**
     @def DEF_BST
     @param type The type of the BST
@@ -67,12 +213,16 @@
         } \
         return res; \
     } \
+    /* Walks the tree from right to left, so that each value can be pushed in front of the greater ones */ \
+    static LL(type)* type##_bst_into_ll_rec(BST(type)* tree, LL(type)* greater) { \
+        while (tree != NULL) { \
+            greater = type##_ll_push_head(type##_bst_into_ll_rec(tree->right, greater), tree->value); \
+            tree = tree->left; \
+        } \
+        return greater; \
+    } \
     LL(type)* type##_bst_into_ll(BST(type)* tree) { \
-        if (tree == NULL) return NULL; \
-        LL(type)* res = type##_bst_into_ll(tree->left); \
-        res = type##_ll_push_tail(res, tree->value); \
-        res = type##_ll_concat(res, type##_bst_into_ll(tree->right)); \
-        return res; \
+        return type##_bst_into_ll_rec(tree, NULL); \
     } \
     LL(type)* type##_bst_sort_ll(LL(type)* list) { \
         BST(type)* bst = type##_bst_from_ll(list); \
@@ -81,6 +231,596 @@
         return res; \
     }
 
+/**
+    @def DEF_BST_VEC_CMP
+    @param type The type of the BST
+    @param cmp The comparison given to `DEF_BST_CMP`
+
+    Defines the BST-associated functions that allow conversion to/from vectors (VEC).
+    Requires `DECL_BT(type)`, `DECL_BST(type)`, `DECL_VEC(type)`, `DECL_BST_VEC(type)`, `DEF_BT(type)` and `DEF_VEC(type)` to have been called beforehand.
+**/
+#define DEF_BST_VEC_CMP(type, cmp) \
+    /* Lays the tree of values[0..length) out in preorder from `nodes`; the right spines are walked iteratively, as runs of equal values all go there */ \
+    static void type##_bst_from_sorted_rec(BST(type)* nodes, const type* values, size_t length, BST(type)** link) { \
+        while (length > 0) { \
+            /* Equal values must be in the right subtree: take the first of the run holding the median as root */ \
+            type pivot = values[length / 2]; \
+            size_t low = 0, high = length / 2; \
+            while (low < high) { \
+                size_t mid = low + (high - low) / 2; \
+                if (cmp(values[mid], pivot) < 0) low = mid + 1; \
+                else high = mid; \
+            } \
+            nodes->value = values[low]; \
+            *link = nodes; \
+            type##_bst_from_sorted_rec(nodes + 1, values, low, &nodes->left); \
+            link = &nodes->right; \
+            nodes += low + 1; \
+            values += low + 1; \
+            length -= low + 1; \
+        } \
+        *link = NULL; \
+    } \
+    BST(type)* type##_bst_from_sorted_vec(const VEC(type)* vec) { \
+        if (vec == NULL || vec->length == 0) return NULL; \
+        BST(type)* nodes = (BST(type)*)malloc(sizeof(struct type##_bt) * vec->length); \
+        if (nodes == NULL) return NULL; \
+        BST(type)* res; \
+        type##_bst_from_sorted_rec(nodes, vec->data, vec->length, &res); \
+        return res; \
+    } \
+    static void type##_bst_into_vec_rec(BST(type)* tree, VEC(type)* vec) { \
+        while (tree != NULL) { \
+            type##_bst_into_vec_rec(tree->left, vec); \
+            vec->data[vec->length++] = tree->value; \
+            tree = tree->right; \
+        } \
+    } \
+    size_t type##_bst_into_vec(BST(type)* tree, VEC(type)* vec) { \
+        if (vec == NULL) return 0; \
+        size_t size = type##_bt_size(tree); \
+        if (vec->length + size > vec->capacity && type##_vec_resize(vec, vec->length + size) == 0) return 0; \
+        type##_bst_into_vec_rec(tree, vec); \
+        return vec->length; \
+    }
+
+/**
+    @def DEF_BST_VEC
+    @param type The type of the BST
+
+    Defines the BST-associated functions that allow conversion to/from vectors (VEC), ordering the values with the `<` and `>` operators.
+    Requires `DECL_BT(type)`, `DECL_BST(type)`, `DECL_VEC(type)`, `DECL_BST_VEC(type)`, `DEF_BT(type)` and `DEF_VEC(type)` to have been called beforehand.
+**/
+#define DEF_BST_VEC(type) DEF_BST_VEC_CMP(type, BST_DEFAULT_CMP)
+
+#define BST_BALANCED(type) type##_bbst_t
+
+/// The maximum height of a balanced BST; an AVL tree with 2^64 nodes is at most 93 levels deep
+#define BST_BALANCED_MAX_DEPTH 96
+
+/**
+    @def DECL_BST_BALANCED(type)
+    @param type The type of the balanced BST
+
+    Declares a self-balancing binary search tree (an AVL tree) and the associated functions.
+    This macro requires `DECL_BT(type)` to have been called beforehand.
+
+    The nodes are `struct TYPE_bt` nodes: the balance factor of each node is stored in the lowest bit of its `left` and `right` pointers.
+    Because of this, the nodes of a balanced tree must not be given to BT- or BST-associated functions; the tree is only reachable through the `BST_BALANCED(type)` handle, which also keeps track of its size.
+**/
+#define DECL_BST_BALANCED(type) struct type##_bbst { \
+        BT(type)* root; \
+        size_t size; \
+    }; \
+    typedef struct type##_bbst BST_BALANCED(type); \
+    BST_BALANCED(type)* type##_bbst_new(void); \
+    void type##_bbst_free(BST_BALANCED(type)* tree); \
+    size_t type##_bbst_size(const BST_BALANCED(type)* tree); \
+    size_t type##_bbst_depth(const BST_BALANCED(type)* tree); \
+    bool type##_bbst_insert(BST_BALANCED(type)* tree, type value); \
+    bool type##_bbst_erase(BST_BALANCED(type)* tree, type value); \
+    type* type##_bbst_find(BST_BALANCED(type)* tree, type value); \
+    type* type##_bbst_lower_bound(BST_BALANCED(type)* tree, type value); \
+    type* type##_bbst_upper_bound(BST_BALANCED(type)* tree, type value); \
+    type* type##_bbst_min(BST_BALANCED(type)* tree); \
+    type* type##_bbst_max(BST_BALANCED(type)* tree); \
+    size_t type##_bbst_for_each(BST_BALANCED(type)* tree, bool (*callback)(const type*, void*), void* callback_data);
+
+/**
+    @def DEF_BST_BALANCED(type, cmp)
+    @param type The type of the balanced BST
+    @param cmp A function or macro taking two values `a` and `b` and returning a negative value if `a < b`, a positive value if `a > b` and 0 if they are equal
+
+    Defines the functions associated with `BST_BALANCED(type)`.
+    Requires `DECL_BT(type)`, `DEF_BT(type)` and `DECL_BST_BALANCED(type)` to have been called beforehand.
+**/
+#define DEF_BST_BALANCED(type, cmp) \
+    static inline BT(type)* type##_bbst_left(const BT(type)* node) { \
+        return (BT(type)*)((uintptr_t)node->left & ~(uintptr_t)1); \
+    } \
+    static inline BT(type)* type##_bbst_right(const BT(type)* node) { \
+        return (BT(type)*)((uintptr_t)node->right & ~(uintptr_t)1); \
+    } \
+    /* height(right) - height(left), between -1 and 1 */ \
+    static inline int type##_bbst_balance(const BT(type)* node) { \
+        return (int)((uintptr_t)node->right & 1) - (int)((uintptr_t)node->left & 1); \
+    } \
+    static inline void type##_bbst_set(BT(type)* node, BT(type)* left, BT(type)* right, int balance) { \
+        node->left = (BT(type)*)((uintptr_t)left | (uintptr_t)(balance < 0)); \
+        node->right = (BT(type)*)((uintptr_t)right | (uintptr_t)(balance > 0)); \
+    } \
+    /* Rebalances `node`, whose left subtree `left` is two levels deeper than `right` */ \
+    static BT(type)* type##_bbst_fix_left(BT(type)* node, BT(type)* left, BT(type)* right, bool* shorter) { \
+        int balance = type##_bbst_balance(left); \
+        BT(type)* left_left = type##_bbst_left(left); \
+        BT(type)* left_right = type##_bbst_right(left); \
+        if (balance <= 0) { \
+            type##_bbst_set(node, left_right, right, balance == 0 ? -1 : 0); \
+            type##_bbst_set(left, left_left, node, balance == 0 ? 1 : 0); \
+            *shorter = balance != 0; \
+            return left; \
+        } \
+        int inner_balance = type##_bbst_balance(left_right); \
+        type##_bbst_set(left, left_left, type##_bbst_left(left_right), inner_balance > 0 ? -1 : 0); \
+        type##_bbst_set(node, type##_bbst_right(left_right), right, inner_balance < 0 ? 1 : 0); \
+        type##_bbst_set(left_right, left, node, 0); \
+        *shorter = true; \
+        return left_right; \
+    } \
+    /* Rebalances `node`, whose right subtree `right` is two levels deeper than `left` */ \
+    static BT(type)* type##_bbst_fix_right(BT(type)* node, BT(type)* left, BT(type)* right, bool* shorter) { \
+        int balance = type##_bbst_balance(right); \
+        BT(type)* right_left = type##_bbst_left(right); \
+        BT(type)* right_right = type##_bbst_right(right); \
+        if (balance >= 0) { \
+            type##_bbst_set(node, left, right_left, balance == 0 ? 1 : 0); \
+            type##_bbst_set(right, node, right_right, balance == 0 ? -1 : 0); \
+            *shorter = balance != 0; \
+            return right; \
+        } \
+        int inner_balance = type##_bbst_balance(right_left); \
+        type##_bbst_set(right, type##_bbst_right(right_left), right_right, inner_balance < 0 ? 1 : 0); \
+        type##_bbst_set(node, left, type##_bbst_left(right_left), inner_balance > 0 ? -1 : 0); \
+        type##_bbst_set(right_left, node, right, 0); \
+        *shorter = true; \
+        return right_left; \
+    } \
+    /* Called once the left subtree of `node` got one level shorter */ \
+    static BT(type)* type##_bbst_left_shrunk(BT(type)* node, BT(type)* left, BT(type)* right, int balance, bool* shorter) { \
+        if (balance < 0) { \
+            type##_bbst_set(node, left, right, 0); \
+            *shorter = true; \
+            return node; \
+        } else if (balance == 0) { \
+            type##_bbst_set(node, left, right, 1); \
+            *shorter = false; \
+            return node; \
+        } \
+        return type##_bbst_fix_right(node, left, right, shorter); \
+    } \
+    /* Called once the right subtree of `node` got one level shorter */ \
+    static BT(type)* type##_bbst_right_shrunk(BT(type)* node, BT(type)* left, BT(type)* right, int balance, bool* shorter) { \
+        if (balance > 0) { \
+            type##_bbst_set(node, left, right, 0); \
+            *shorter = true; \
+            return node; \
+        } else if (balance == 0) { \
+            type##_bbst_set(node, left, right, -1); \
+            *shorter = false; \
+            return node; \
+        } \
+        return type##_bbst_fix_left(node, left, right, shorter); \
+    } \
+    static BT(type)* type##_bbst_insert_rec(BT(type)* node, type value, bool* grew, bool* inserted) { \
+        if (node == NULL) { \
+            node = type##_bt_new(value); \
+            *grew = *inserted = node != NULL; \
+            return node; \
+        } \
+        int order = cmp(value, node->value); \
+        if (order == 0) { \
+            *grew = *inserted = false; \
+            return node; \
+        } \
+        BT(type)* left = type##_bbst_left(node); \
+        BT(type)* right = type##_bbst_right(node); \
+        int balance = type##_bbst_balance(node); \
+        bool shorter; \
+        if (order < 0) { \
+            left = type##_bbst_insert_rec(left, value, grew, inserted); \
+            if (*grew) { \
+                if (balance < 0) { \
+                    *grew = false; \
+                    return type##_bbst_fix_left(node, left, right, &shorter); \
+                } \
+                balance--; \
+                *grew = balance != 0; \
+            } \
+        } else { \
+            right = type##_bbst_insert_rec(right, value, grew, inserted); \
+            if (*grew) { \
+                if (balance > 0) { \
+                    *grew = false; \
+                    return type##_bbst_fix_right(node, left, right, &shorter); \
+                } \
+                balance++; \
+                *grew = balance != 0; \
+            } \
+        } \
+        type##_bbst_set(node, left, right, balance); \
+        return node; \
+    } \
+    /* Detaches the leftmost node of the subtree into `*min` */ \
+    static BT(type)* type##_bbst_remove_min(BT(type)* node, BT(type)** min, bool* shorter) { \
+        BT(type)* left = type##_bbst_left(node); \
+        BT(type)* right = type##_bbst_right(node); \
+        if (left == NULL) { \
+            *min = node; \
+            *shorter = true; \
+            return right; \
+        } \
+        int balance = type##_bbst_balance(node); \
+        left = type##_bbst_remove_min(left, min, shorter); \
+        if (*shorter) return type##_bbst_left_shrunk(node, left, right, balance, shorter); \
+        type##_bbst_set(node, left, right, balance); \
+        return node; \
+    } \
+    static BT(type)* type##_bbst_erase_rec(BT(type)* node, type value, bool* shorter, bool* erased) { \
+        if (node == NULL) { \
+            *shorter = *erased = false; \
+            return NULL; \
+        } \
+        int order = cmp(value, node->value); \
+        BT(type)* left = type##_bbst_left(node); \
+        BT(type)* right = type##_bbst_right(node); \
+        int balance = type##_bbst_balance(node); \
+        if (order < 0) { \
+            left = type##_bbst_erase_rec(left, value, shorter, erased); \
+            if (*shorter) return type##_bbst_left_shrunk(node, left, right, balance, shorter); \
+        } else if (order > 0) { \
+            right = type##_bbst_erase_rec(right, value, shorter, erased); \
+            if (*shorter) return type##_bbst_right_shrunk(node, left, right, balance, shorter); \
+        } else { \
+            *erased = true; \
+            free(node); \
+            *shorter = true; \
+            if (left == NULL) return right; \
+            if (right == NULL) return left; \
+            /* The successor of the removed node takes its place */ \
+            BT(type)* min; \
+            right = type##_bbst_remove_min(right, &min, shorter); \
+            if (*shorter) return type##_bbst_right_shrunk(min, left, right, balance, shorter); \
+            node = min; \
+        } \
+        type##_bbst_set(node, left, right, balance); \
+        return node; \
+    } \
+    static void type##_bbst_free_rec(BT(type)* node) { \
+        if (node == NULL) return; \
+        type##_bbst_free_rec(type##_bbst_left(node)); \
+        type##_bbst_free_rec(type##_bbst_right(node)); \
+        free(node); \
+    } \
+    static size_t type##_bbst_depth_rec(const BT(type)* node) { \
+        if (node == NULL) return 0; \
+        /* The balance factor tells which subtree is the deepest */ \
+        if (type##_bbst_balance(node) < 0) return 1 + type##_bbst_depth_rec(type##_bbst_left(node)); \
+        else return 1 + type##_bbst_depth_rec(type##_bbst_right(node)); \
+    } \
+    BST_BALANCED(type)* type##_bbst_new(void) { \
+        BST_BALANCED(type)* res = (BST_BALANCED(type)*)malloc(sizeof(struct type##_bbst)); \
+        if (res == NULL) return NULL; \
+        res->root = NULL; \
+        res->size = 0; \
+        return res; \
+    } \
+    void type##_bbst_free(BST_BALANCED(type)* tree) { \
+        if (tree == NULL) return; \
+        type##_bbst_free_rec(tree->root); \
+        free(tree); \
+    } \
+    size_t type##_bbst_size(const BST_BALANCED(type)* tree) { \
+        if (tree == NULL) return 0; \
+        return tree->size; \
+    } \
+    size_t type##_bbst_depth(const BST_BALANCED(type)* tree) { \
+        if (tree == NULL) return 0; \
+        return type##_bbst_depth_rec(tree->root); \
+    } \
+    bool type##_bbst_insert(BST_BALANCED(type)* tree, type value) { \
+        if (tree == NULL) return false; \
+        bool grew, inserted; \
+        tree->root = type##_bbst_insert_rec(tree->root, value, &grew, &inserted); \
+        if (inserted) tree->size++; \
+        return inserted; \
+    } \
+    bool type##_bbst_erase(BST_BALANCED(type)* tree, type value) { \
+        if (tree == NULL) return false; \
+        bool shorter, erased; \
+        tree->root = type##_bbst_erase_rec(tree->root, value, &shorter, &erased); \
+        if (erased) tree->size--; \
+        return erased; \
+    } \
+    type* type##_bbst_find(BST_BALANCED(type)* tree, type value) { \
+        if (tree == NULL) return NULL; \
+        BT(type)* node = tree->root; \
+        while (node != NULL) { \
+            int order = cmp(value, node->value); \
+            if (order == 0) return &node->value; \
+            node = order < 0 ? type##_bbst_left(node) : type##_bbst_right(node); \
+        } \
+        return NULL; \
+    } \
+    type* type##_bbst_lower_bound(BST_BALANCED(type)* tree, type value) { \
+        if (tree == NULL) return NULL; \
+        BT(type)* node = tree->root; \
+        type* res = NULL; \
+        while (node != NULL) { \
+            if (cmp(node->value, value) >= 0) { \
+                res = &node->value; \
+                node = type##_bbst_left(node); \
+            } else { \
+                node = type##_bbst_right(node); \
+            } \
+        } \
+        return res; \
+    } \
+    type* type##_bbst_upper_bound(BST_BALANCED(type)* tree, type value) { \
+        if (tree == NULL) return NULL; \
+        BT(type)* node = tree->root; \
+        type* res = NULL; \
+        while (node != NULL) { \
+            if (cmp(node->value, value) > 0) { \
+                res = &node->value; \
+                node = type##_bbst_left(node); \
+            } else { \
+                node = type##_bbst_right(node); \
+            } \
+        } \
+        return res; \
+    } \
+    type* type##_bbst_min(BST_BALANCED(type)* tree) { \
+        if (tree == NULL || tree->root == NULL) return NULL; \
+        BT(type)* node = tree->root; \
+        while (type##_bbst_left(node) != NULL) node = type##_bbst_left(node); \
+        return &node->value; \
+    } \
+    type* type##_bbst_max(BST_BALANCED(type)* tree) { \
+        if (tree == NULL || tree->root == NULL) return NULL; \
+        BT(type)* node = tree->root; \
+        while (type##_bbst_right(node) != NULL) node = type##_bbst_right(node); \
+        return &node->value; \
+    } \
+    size_t type##_bbst_for_each(BST_BALANCED(type)* tree, bool (*callback)(const type*, void*), void* callback_data) { \
+        if (tree == NULL) return 0; \
+        BT(type)* stack[BST_BALANCED_MAX_DEPTH]; \
+        size_t depth = 0; \
+        size_t res = 0; \
+        BT(type)* node = tree->root; \
+        while (node != NULL || depth > 0) { \
+            while (node != NULL) { \
+                stack[depth++] = node; \
+                node = type##_bbst_left(node); \
+            } \
+            node = stack[--depth]; \
+            res++; \
+            if (!callback(&node->value, callback_data)) break; \
+            node = type##_bbst_right(node); \
+        } \
+        return res; \
+    }
+
+#define BST_RANK(type) type##_ost_t
+
+/**
+    @def DECL_BST_RANK(type)
+    @param type The type of the order-statistic tree
+
+    Declares an order-statistic tree: a weight-balanced binary search tree whose nodes know the size of their subtree, and the associated functions.
+    Unlike `BST_BALANCED(type)`, it may hold several equal values.
+**/
+#define DECL_BST_RANK(type) struct type##_ost_node { \
+        type value; \
+        struct type##_ost_node* left; \
+        struct type##_ost_node* right; \
+        size_t size; \
+    }; \
+    struct type##_ost { \
+        struct type##_ost_node* root; \
+    }; \
+    typedef struct type##_ost BST_RANK(type); \
+    BST_RANK(type)* type##_ost_new(void); \
+    void type##_ost_free(BST_RANK(type)* tree); \
+    size_t type##_ost_size(const BST_RANK(type)* tree); \
+    size_t type##_ost_depth(const BST_RANK(type)* tree); \
+    bool type##_ost_insert(BST_RANK(type)* tree, type value); \
+    bool type##_ost_erase(BST_RANK(type)* tree, type value); \
+    type* type##_ost_find(BST_RANK(type)* tree, type value); \
+    type* type##_ost_select(BST_RANK(type)* tree, size_t index); \
+    size_t type##_ost_rank(const BST_RANK(type)* tree, type value);
+
+/**
+    @def DEF_BST_RANK(type, cmp)
+    @param type The type of the order-statistic tree
+    @param cmp A function or macro taking two values `a` and `b` and returning a negative value if `a < b`, a positive value if `a > b` and 0 if they are equal
+
+    Defines the functions associated with `BST_RANK(type)`.
+    Requires `DECL_BST_RANK(type)` to have been called beforehand.
+
+    The tree is kept balanced by weight rather than by height (with the parameters 3 and 2 of Hirai and Yamamoto), as the subtree sizes that rank and select need are then also all that balancing needs.
+**/
+#define DEF_BST_RANK(type, cmp) \
+    static inline size_t type##_ost_node_size(const struct type##_ost_node* node) { \
+        return node == NULL ? 0 : node->size; \
+    } \
+    static inline void type##_ost_update(struct type##_ost_node* node) { \
+        node->size = 1 + type##_ost_node_size(node->left) + type##_ost_node_size(node->right); \
+    } \
+    static struct type##_ost_node* type##_ost_rotate_left(struct type##_ost_node* node) { \
+        struct type##_ost_node* right = node->right; \
+        node->right = right->left; \
+        right->left = node; \
+        type##_ost_update(node); \
+        type##_ost_update(right); \
+        return right; \
+    } \
+    static struct type##_ost_node* type##_ost_rotate_right(struct type##_ost_node* node) { \
+        struct type##_ost_node* left = node->left; \
+        node->left = left->right; \
+        left->right = node; \
+        type##_ost_update(node); \
+        type##_ost_update(left); \
+        return left; \
+    } \
+    /* Updates the size of `node` and restores the weight balance, which one insertion or removal below it can only have broken by one step */ \
+    static struct type##_ost_node* type##_ost_balance(struct type##_ost_node* node) { \
+        size_t left = type##_ost_node_size(node->left) + 1; \
+        size_t right = type##_ost_node_size(node->right) + 1; \
+        if (3 * left < right) { \
+            if (type##_ost_node_size(node->right->left) + 1 >= 2 * (type##_ost_node_size(node->right->right) + 1)) { \
+                node->right = type##_ost_rotate_right(node->right); \
+            } \
+            return type##_ost_rotate_left(node); \
+        } \
+        if (3 * right < left) { \
+            if (type##_ost_node_size(node->left->right) + 1 >= 2 * (type##_ost_node_size(node->left->left) + 1)) { \
+                node->left = type##_ost_rotate_left(node->left); \
+            } \
+            return type##_ost_rotate_right(node); \
+        } \
+        type##_ost_update(node); \
+        return node; \
+    } \
+    static struct type##_ost_node* type##_ost_insert_rec(struct type##_ost_node* node, struct type##_ost_node* new_node) { \
+        if (node == NULL) return new_node; \
+        if (cmp(new_node->value, node->value) < 0) { \
+            node->left = type##_ost_insert_rec(node->left, new_node); \
+        } else { \
+            node->right = type##_ost_insert_rec(node->right, new_node); \
+        } \
+        return type##_ost_balance(node); \
+    } \
+    static struct type##_ost_node* type##_ost_remove_min(struct type##_ost_node* node, struct type##_ost_node** min) { \
+        if (node->left == NULL) { \
+            *min = node; \
+            return node->right; \
+        } \
+        node->left = type##_ost_remove_min(node->left, min); \
+        return type##_ost_balance(node); \
+    } \
+    static struct type##_ost_node* type##_ost_erase_rec(struct type##_ost_node* node, type value, bool* erased) { \
+        if (node == NULL) return NULL; \
+        int order = cmp(value, node->value); \
+        if (order < 0) { \
+            node->left = type##_ost_erase_rec(node->left, value, erased); \
+        } else if (order > 0) { \
+            node->right = type##_ost_erase_rec(node->right, value, erased); \
+        } else { \
+            *erased = true; \
+            struct type##_ost_node* res; \
+            if (node->left == NULL) { \
+                res = node->right; \
+            } else if (node->right == NULL) { \
+                res = node->left; \
+            } else { \
+                node->right = type##_ost_remove_min(node->right, &res); \
+                res->left = node->left; \
+                res->right = node->right; \
+                res = type##_ost_balance(res); \
+            } \
+            free(node); \
+            return res; \
+        } \
+        return *erased ? type##_ost_balance(node) : node; \
+    } \
+    static void type##_ost_free_rec(struct type##_ost_node* node) { \
+        if (node == NULL) return; \
+        type##_ost_free_rec(node->left); \
+        type##_ost_free_rec(node->right); \
+        free(node); \
+    } \
+    static size_t type##_ost_depth_rec(const struct type##_ost_node* node) { \
+        if (node == NULL) return 0; \
+        size_t left = type##_ost_depth_rec(node->left); \
+        size_t right = type##_ost_depth_rec(node->right); \
+        return 1 + (left > right ? left : right); \
+    } \
+    BST_RANK(type)* type##_ost_new(void) { \
+        BST_RANK(type)* res = (BST_RANK(type)*)malloc(sizeof(struct type##_ost)); \
+        if (res == NULL) return NULL; \
+        res->root = NULL; \
+        return res; \
+    } \
+    void type##_ost_free(BST_RANK(type)* tree) { \
+        if (tree == NULL) return; \
+        type##_ost_free_rec(tree->root); \
+        free(tree); \
+    } \
+    size_t type##_ost_size(const BST_RANK(type)* tree) { \
+        if (tree == NULL) return 0; \
+        return type##_ost_node_size(tree->root); \
+    } \
+    size_t type##_ost_depth(const BST_RANK(type)* tree) { \
+        if (tree == NULL) return 0; \
+        return type##_ost_depth_rec(tree->root); \
+    } \
+    bool type##_ost_insert(BST_RANK(type)* tree, type value) { \
+        if (tree == NULL) return false; \
+        struct type##_ost_node* node = (struct type##_ost_node*)malloc(sizeof(struct type##_ost_node)); \
+        if (node == NULL) return false; \
+        node->value = value; \
+        node->left = NULL; \
+        node->right = NULL; \
+        node->size = 1; \
+        tree->root = type##_ost_insert_rec(tree->root, node); \
+        return true; \
+    } \
+    bool type##_ost_erase(BST_RANK(type)* tree, type value) { \
+        if (tree == NULL) return false; \
+        bool erased = false; \
+        tree->root = type##_ost_erase_rec(tree->root, value, &erased); \
+        return erased; \
+    } \
+    type* type##_ost_find(BST_RANK(type)* tree, type value) { \
+        if (tree == NULL) return NULL; \
+        struct type##_ost_node* node = tree->root; \
+        while (node != NULL) { \
+            int order = cmp(value, node->value); \
+            if (order == 0) return &node->value; \
+            node = order < 0 ? node->left : node->right; \
+        } \
+        return NULL; \
+    } \
+    type* type##_ost_select(BST_RANK(type)* tree, size_t index) { \
+        if (tree == NULL) return NULL; \
+        struct type##_ost_node* node = tree->root; \
+        while (node != NULL) { \
+            size_t left = type##_ost_node_size(node->left); \
+            if (index == left) return &node->value; \
+            if (index < left) { \
+                node = node->left; \
+            } else { \
+                index -= left + 1; \
+                node = node->right; \
+            } \
+        } \
+        return NULL; \
+    } \
+    size_t type##_ost_rank(const BST_RANK(type)* tree, type value) { \
+        if (tree == NULL) return 0; \
+        size_t res = 0; \
+        const struct type##_ost_node* node = tree->root; \
+        while (node != NULL) { \
+            if (cmp(node->value, value) < 0) { \
+                res += type##_ost_node_size(node->left) + 1; \
+                node = node->right; \
+            } else { \
+                node = node->left; \
+            } \
+        } \
+        return res; \
+    }
+
 /** @typedef TYPE_bst_t
 
     Resolves to `struct TYPE_bt`; can also be accessed with `BST(TYPE)`.
@@ -101,6 +841,50 @@
     Behavior is undefined if the BST has been modified to contain a closed loop or if the node ordering invariant has not been respected.
 **/
 
+/** @fn TYPE_bst_erase(BST(TYPE)* tree, TYPE value)
+    @returns A pointer to the new, modified tree
+
+    Removes one node equal to `value` from the tree, if there is any.
+    A node with two children is replaced by the leftmost node of its right subtree.
+**/
+
+/** @fn TYPE_bst_find(BST(TYPE)* tree, TYPE value)
+    @returns A node equal to `value`, or NULL if there is none
+
+    Takes `O(depth)` time, rather than the `O(n)` of `TYPE_bt_prefix_find`.
+**/
+
+/** @fn TYPE_bst_lower_bound(BST(TYPE)* tree, TYPE value)
+    @returns The first node (in order) whose value is greater than or equal to `value`, or NULL if there is none
+**/
+
+/** @fn TYPE_bst_upper_bound(BST(TYPE)* tree, TYPE value)
+    @returns The first node (in order) whose value is strictly greater than `value`, or NULL if there is none
+**/
+
+/** @fn TYPE_bst_range_count(BST(TYPE)* tree, TYPE lo, TYPE hi)
+    @returns The number of values within `[lo, hi)`
+
+    Only descends into the subtrees that may hold values of the range, so it takes `O(depth + k)` time for `k` values in the range.
+**/
+
+/** @fn TYPE_bst_for_each_in_range(BST(TYPE)* tree, TYPE lo, TYPE hi, bool (*callback)(const TYPE*, void*), void* callback_data)
+    @param callback Called on each value within `[lo, hi)`, in order; returning false stops the iteration
+    @param callback_data A user-defined void pointer passed to `callback`
+    @returns The number of times `callback` was called
+
+    Like `TYPE_bst_range_count`, subtrees that lie outside of the range are never visited.
+**/
+
+/** @fn TYPE_bst_cursor_seek(BT_CURSOR(TYPE)* cursor, TYPE value)
+    @param cursor A cursor on a binary search tree
+    @param value The value to look for
+    @returns false if every value of the tree is smaller than `value`, true otherwise
+
+    Moves the cursor to the smallest value that is greater than or equal to `value`, in `O(depth)`.
+    The cursor can then be moved with `TYPE_bt_cursor_next` and `TYPE_bt_cursor_prev`, which makes it possible to resume an in-order walk from any value.
+**/
+
 /** @fn TYPE_bst_from_ll(LL(TYPE)* list)
     @returns A pointer to the new BST
 
@@ -130,9 +914,162 @@
 
     Behavior is undefined if `list` contains a closed loop.
 
-    Average time complexity of this sorting method is `O(logn)`
+    Average time complexity of this sorting method is `O(nlogn)`, but it degrades to `O(n²)` on sorted or reverse-sorted lists, and `list` is left untouched.
+    `TYPE_ll_sort` sorts a list in place in `O(nlogn)` without allocating and should be preferred.
 
     **Note:** only available if `DECL_BST_LL(TYPE)` and `DEF_BST_LL(TYPE)` have been called.
 **/
 
+/** @fn TYPE_bst_from_sorted_vec(const VEC(TYPE)* vec)
+    @param vec A vector sorted in increasing order
+    @returns A new binary search tree holding the values of `vec`, or NULL if `vec` is empty or on allocation failure
+
+    Builds the tree in `O(n)`; it is perfectly balanced if the values of `vec` are distinct.
+    All of its nodes are allocated in one block, in prefix order, and the root is the first node of the block:
+    the tree must be freed with `free(tree)` rather than `TYPE_bt_free`, and nodes must not be inserted into it nor erased from it.
+
+    **Note:** only available if `DECL_BST_VEC(TYPE)` and `DEF_BST_VEC(TYPE)` have been called.
+**/
+
+/** @fn TYPE_bst_into_vec(BST(TYPE)* tree, VEC(TYPE)* vec)
+    @param tree The binary search tree to read
+    @param vec The vector to append the values to
+    @returns The new length of `vec`, or 0 on allocation failure
+
+    Appends the values of `tree` to `vec` in increasing order, in `O(n)`, resizing `vec` at most once.
+
+    **Note:** only available if `DECL_BST_VEC(TYPE)` and `DEF_BST_VEC(TYPE)` have been called.
+**/
+
+/** @struct TYPE_bbst
+
+    A self-balancing binary search tree (AVL tree) holding distinct values of type `TYPE`, along with its size.
+    Insertion, removal, lookup and bound queries all take `O(log n)` time in the worst case.
+**/
+
+/** @typedef TYPE_bbst_t
+
+    Resolves to `struct TYPE_bbst`; can also be accessed with `BST_BALANCED(TYPE)`.
+**/
+
+/** @fn TYPE_bbst_new()
+    @returns A new, empty balanced BST, or NULL on allocation failure
+**/
+
+/** @fn TYPE_bbst_free(BST_BALANCED(TYPE)* tree)
+    @param tree The tree to free
+
+    Frees the tree and all of its nodes.
+**/
+
+/** @fn TYPE_bbst_size(const BST_BALANCED(TYPE)* tree)
+    @returns The number of values in `tree`, in `O(1)`
+**/
+
+/** @fn TYPE_bbst_depth(const BST_BALANCED(TYPE)* tree)
+    @returns The length of the longest branch of `tree`, in `O(log n)`
+**/
+
+/** @fn TYPE_bbst_insert(BST_BALANCED(TYPE)* tree, TYPE value)
+    @returns true if `value` was inserted, false if an equal value was already present or if the node could not be allocated
+
+    Inserts `value` into `tree`, then rebalances it.
+**/
+
+/** @fn TYPE_bbst_erase(BST_BALANCED(TYPE)* tree, TYPE value)
+    @returns true if a value equal to `value` was found and removed, false otherwise
+**/
+
+/** @fn TYPE_bbst_find(BST_BALANCED(TYPE)* tree, TYPE value)
+    @returns A pointer to the value of `tree` equal to `value`, or NULL if there is none
+
+    The returned value may be read, but must not be modified in a way that changes its ordering.
+**/
+
+/** @fn TYPE_bbst_lower_bound(BST_BALANCED(TYPE)* tree, TYPE value)
+    @returns A pointer to the smallest value of `tree` that is greater than or equal to `value`, or NULL if there is none
+**/
+
+/** @fn TYPE_bbst_upper_bound(BST_BALANCED(TYPE)* tree, TYPE value)
+    @returns A pointer to the smallest value of `tree` that is strictly greater than `value`, or NULL if there is none
+
+    Calling `TYPE_bbst_upper_bound` with the last value visited allows an in-order iteration to be resumed.
+**/
+
+/** @fn TYPE_bbst_min(BST_BALANCED(TYPE)* tree)
+    @returns A pointer to the smallest value of `tree`, or NULL if it is empty
+**/
+
+/** @fn TYPE_bbst_max(BST_BALANCED(TYPE)* tree)
+    @returns A pointer to the greatest value of `tree`, or NULL if it is empty
+**/
+
+/** @fn TYPE_bbst_for_each(BST_BALANCED(TYPE)* tree, bool (*callback)(const TYPE*, void*), void* callback_data)
+    @param callback Called on each value in increasing order; returning false stops the iteration
+    @param callback_data A user-defined void pointer passed to `callback`
+    @returns The number of times `callback` was called
+
+    Visits the values of `tree` in order, without recursion.
+**/
+
+/** @struct TYPE_ost
+
+    An order-statistic tree holding values of type `TYPE`, possibly several equal ones.
+    Insertion, removal, lookup, `TYPE_ost_select` and `TYPE_ost_rank` all take `O(log n)` time in the worst case.
+**/
+
+/** @typedef TYPE_ost_t
+
+    Resolves to `struct TYPE_ost`; can also be accessed with `BST_RANK(TYPE)`.
+**/
+
+/** @fn TYPE_ost_new()
+    @returns A new, empty order-statistic tree, or NULL on allocation failure
+**/
+
+/** @fn TYPE_ost_free(BST_RANK(TYPE)* tree)
+    @param tree The tree to free
+
+    Frees the tree and all of its nodes.
+**/
+
+/** @fn TYPE_ost_size(const BST_RANK(TYPE)* tree)
+    @returns The number of values in `tree`, in `O(1)`
+**/
+
+/** @fn TYPE_ost_depth(const BST_RANK(TYPE)* tree)
+    @returns The length of the longest branch of `tree`, in `O(n)`
+**/
+
+/** @fn TYPE_ost_insert(BST_RANK(TYPE)* tree, TYPE value)
+    @returns false if the node could not be allocated, true otherwise
+
+    Inserts `value` into `tree`, after the values that are equal to it, then rebalances it.
+**/
+
+/** @fn TYPE_ost_erase(BST_RANK(TYPE)* tree, TYPE value)
+    @returns true if a value equal to `value` was found and removed, false otherwise
+
+    Only removes one of the values equal to `value`.
+**/
+
+/** @fn TYPE_ost_find(BST_RANK(TYPE)* tree, TYPE value)
+    @returns A pointer to a value of `tree` equal to `value`, or NULL if there is none
+
+    The returned value may be read, but must not be modified in a way that changes its ordering.
+**/
+
+/** @fn TYPE_ost_select(BST_RANK(TYPE)* tree, size_t index)
+    @param index The rank of the value to get, starting from 0
+    @returns A pointer to the `index`-th smallest value of `tree`, or NULL if `index` is not smaller than its size
+
+    For instance, `TYPE_ost_select(tree, TYPE_ost_size(tree) * 99 / 100)` is the 99th percentile of the values of `tree`.
+**/
+
+/** @fn TYPE_ost_rank(const BST_RANK(TYPE)* tree, TYPE value)
+    @returns The number of values of `tree` that are strictly smaller than `value`
+
+    `value` does not need to be in `tree`; `TYPE_ost_select(tree, TYPE_ost_rank(tree, value))` is its lower bound.
+**/
+
 #endif // BSTREE_H
@@ -7,6 +7,12 @@
 #include <stdio.h>
 
 #define BT(type) type##_bt_t
+#define BT_CURSOR(type) type##_bt_cursor_t
+
+/// The number of ancestors a cursor can hold before its path has to grow; enough for any balanced tree of up to 2^32 nodes
+#ifndef BT_CURSOR_INITIAL_DEPTH
+#define BT_CURSOR_INITIAL_DEPTH 32
+#endif
 
 // Not yet supported!
 // #define BT_PTR(type) type##_bt_ptr_t
@@ -36,7 +42,22 @@
     BT(type)* type##_bt_get(BT(type)* tree, uintmax_t address); \
     BT(type)* type##_bt_prefix_find(BT(type)* tree, bool (*predicate)(const type, const void*), const void* predicate_data); \
     BT(type)* type##_bt_postfix_find(BT(type)* tree, bool (*predicate)(const type, const void*), const void* predicate_data); \
-    BT(type)* type##_bt_clone(BT(type)* node);
+    BT(type)* type##_bt_clone(BT(type)* node); \
+    struct type##_bt_cursor { \
+        BT(type)* root; \
+        BT(type)** path; \
+        size_t depth; \
+        size_t capacity; \
+    }; \
+    typedef struct type##_bt_cursor BT_CURSOR(type); \
+    BT_CURSOR(type)* type##_bt_cursor_new(BT(type)* tree); \
+    void type##_bt_cursor_free(BT_CURSOR(type)* cursor); \
+    bool type##_bt_cursor_first(BT_CURSOR(type)* cursor); \
+    bool type##_bt_cursor_last(BT_CURSOR(type)* cursor); \
+    bool type##_bt_cursor_next(BT_CURSOR(type)* cursor); \
+    bool type##_bt_cursor_prev(BT_CURSOR(type)* cursor); \
+    type* type##_bt_cursor_get(BT_CURSOR(type)* cursor); \
+    bool type##_bt_cursor_push(BT_CURSOR(type)* cursor, BT(type)* node);
 
 /** @def DEF_BT(type)
     @param type The type of the binary tree
@@ -124,6 +145,80 @@
     BT(type)* type##_bt_clone(BT(type)* node) { \
         if (node == NULL) return NULL; \
         return type##_bt_connect(type##_bt_clone(node->left), type##_bt_clone(node->right), node->value); \
+    } \
+    BT_CURSOR(type)* type##_bt_cursor_new(BT(type)* tree) { \
+        BT_CURSOR(type)* res = (BT_CURSOR(type)*)malloc(sizeof(struct type##_bt_cursor)); \
+        if (res == NULL) return NULL; \
+        res->path = (BT(type)**)malloc(sizeof(BT(type)*) * BT_CURSOR_INITIAL_DEPTH); \
+        if (res->path == NULL) { \
+            free(res); \
+            return NULL; \
+        } \
+        res->root = tree; \
+        res->depth = 0; \
+        res->capacity = BT_CURSOR_INITIAL_DEPTH; \
+        return res; \
+    } \
+    void type##_bt_cursor_free(BT_CURSOR(type)* cursor) { \
+        if (cursor == NULL) return; \
+        free(cursor->path); \
+        free(cursor); \
+    } \
+    bool type##_bt_cursor_push(BT_CURSOR(type)* cursor, BT(type)* node) { \
+        if (cursor->depth == cursor->capacity) { \
+            BT(type)** path = (BT(type)**)realloc(cursor->path, sizeof(BT(type)*) * cursor->capacity * 2); \
+            if (path == NULL) { \
+                cursor->depth = 0; \
+                return false; \
+            } \
+            cursor->path = path; \
+            cursor->capacity *= 2; \
+        } \
+        cursor->path[cursor->depth++] = node; \
+        return true; \
+    } \
+    /* Pushes `node` and its chain of left (or right) children, ending on the smallest (or greatest) node of its subtree */ \
+    static bool type##_bt_cursor_descend(BT_CURSOR(type)* cursor, BT(type)* node, bool leftmost) { \
+        while (node != NULL) { \
+            if (!type##_bt_cursor_push(cursor, node)) return false; \
+            node = leftmost ? node->left : node->right; \
+        } \
+        return cursor->depth > 0; \
+    } \
+    static bool type##_bt_cursor_step(BT_CURSOR(type)* cursor, bool forwards) { \
+        if (cursor == NULL || cursor->depth == 0) return false; \
+        BT(type)* node = cursor->path[cursor->depth - 1]; \
+        BT(type)* child = forwards ? node->right : node->left; \
+        if (child != NULL) return type##_bt_cursor_descend(cursor, child, forwards); \
+        /* Climb back up until we leave a left (or right) subtree: its parent is the next node */ \
+        cursor->depth--; \
+        while (cursor->depth > 0) { \
+            BT(type)* parent = cursor->path[cursor->depth - 1]; \
+            if ((forwards ? parent->right : parent->left) != node) return true; \
+            node = parent; \
+            cursor->depth--; \
+        } \
+        return false; \
+    } \
+    bool type##_bt_cursor_first(BT_CURSOR(type)* cursor) { \
+        if (cursor == NULL) return false; \
+        cursor->depth = 0; \
+        return type##_bt_cursor_descend(cursor, cursor->root, true); \
+    } \
+    bool type##_bt_cursor_last(BT_CURSOR(type)* cursor) { \
+        if (cursor == NULL) return false; \
+        cursor->depth = 0; \
+        return type##_bt_cursor_descend(cursor, cursor->root, false); \
+    } \
+    bool type##_bt_cursor_next(BT_CURSOR(type)* cursor) { \
+        return type##_bt_cursor_step(cursor, true); \
+    } \
+    bool type##_bt_cursor_prev(BT_CURSOR(type)* cursor) { \
+        return type##_bt_cursor_step(cursor, false); \
+    } \
+    type* type##_bt_cursor_get(BT_CURSOR(type)* cursor) { \
+        if (cursor == NULL || cursor->depth == 0) return NULL; \
+        return &cursor->path[cursor->depth - 1]->value; \
     }
 
 /**
@@ -290,4 +385,64 @@
     Returns NULL if no leaf was found (ie. the tree is empty).
 **/
 
+/** @struct TYPE_bt_cursor
+
+    A position in the in-order traversal of a binary tree, which can be moved in both directions and stopped at any time.
+    BT nodes have no parent pointer, so the cursor keeps the path from the root to the current node.
+    That path starts with room for `BT_CURSOR_INITIAL_DEPTH` nodes and grows when the tree is deeper, so that unbalanced trees are supported too.
+    A cursor is invalidated by any change to the shape of its tree.
+**/
+
+/** @fn TYPE_bt_cursor_new(BT(TYPE)* tree)
+    @param tree The tree to walk; may be NULL
+    @returns A new cursor on `tree`, placed past the end, or NULL on allocation failure
+**/
+
+/** @fn TYPE_bt_cursor_free(BT_CURSOR(TYPE)* cursor)
+    @param cursor The cursor to free; the tree is left untouched
+**/
+
+/** @fn TYPE_bt_cursor_first(BT_CURSOR(TYPE)* cursor)
+    @param cursor The cursor to move
+    @returns false if the tree is empty, true otherwise
+
+    Moves the cursor to the leftmost node of the tree.
+**/
+
+/** @fn TYPE_bt_cursor_last(BT_CURSOR(TYPE)* cursor)
+    @param cursor The cursor to move
+    @returns false if the tree is empty, true otherwise
+
+    Moves the cursor to the rightmost node of the tree.
+**/
+
+/** @fn TYPE_bt_cursor_next(BT_CURSOR(TYPE)* cursor)
+    @param cursor The cursor to move
+    @returns false if the cursor went past the end, true otherwise
+
+    Moves the cursor to the next node in in-order, in amortized `O(1)`.
+    Once past the end, the cursor stays there until `TYPE_bt_cursor_first`, `TYPE_bt_cursor_last` or `TYPE_bst_cursor_seek` is called.
+**/
+
+/** @fn TYPE_bt_cursor_prev(BT_CURSOR(TYPE)* cursor)
+    @param cursor The cursor to move
+    @returns false if the cursor went past the beginning, true otherwise
+
+    Moves the cursor to the previous node in in-order, in amortized `O(1)`.
+**/
+
+/** @fn TYPE_bt_cursor_get(BT_CURSOR(TYPE)* cursor)
+    @param cursor The cursor to read
+    @returns A pointer to the value of the current node, or NULL if the cursor is past either end
+**/
+
+/** @fn TYPE_bt_cursor_push(BT_CURSOR(TYPE)* cursor, BT(TYPE)* node)
+    @param cursor The cursor to extend
+    @param node A child of the current node, or the root if the cursor is past the end
+    @returns false if the path could not grow, in which case the cursor ends up past the end
+
+    Makes `node` the current node, keeping the current node as its parent on the path.
+    This is the building block of searches that place a cursor, like `TYPE_bst_cursor_seek`; they may be defined in another file than `DEF_BT(TYPE)`.
+**/
+
 #endif // BTREE_H
@@ -0,0 +1,259 @@
+#ifndef BTREE_ARENA_H
+#define BTREE_ARENA_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "btree.h"
+
+#define BT_ARENA(type) type##_bt_arena_t
+#define BT_ARENA_NODE(type) type##_bt_arena_node_t
+
+/// The index standing for the absence of a node, like NULL does for `BT(type)`
+#define BT_ARENA_NULL UINT32_MAX
+
+/** @def DECL_BT_ARENA(type)
+    @param type The type of the binary trees
+
+    Declares a node arena for binary trees, whose nodes refer to their children with 32-bit indices instead of pointers, and the associated functions.
+    This macro requires `DECL_BT(type)` to have been called beforehand.
+**/
+#define DECL_BT_ARENA(type) struct type##_bt_arena_node { \
+        type value; \
+        uint32_t left; \
+        uint32_t right; \
+    }; \
+    typedef struct type##_bt_arena_node BT_ARENA_NODE(type); \
+    struct type##_bt_arena { \
+        BT_ARENA_NODE(type)* nodes; \
+        uint32_t length; \
+        uint32_t capacity; \
+        uint32_t root; \
+    }; \
+    typedef struct type##_bt_arena BT_ARENA(type); \
+    BT_ARENA(type)* type##_bt_arena_new(uint32_t capacity); \
+    void type##_bt_arena_free(BT_ARENA(type)* arena); \
+    void type##_bt_arena_clear(BT_ARENA(type)* arena); \
+    uint32_t type##_bt_arena_length(const BT_ARENA(type)* arena); \
+    uint32_t type##_bt_arena_new_node(BT_ARENA(type)* arena, type element); \
+    uint32_t type##_bt_arena_connect(BT_ARENA(type)* arena, uint32_t left, uint32_t right, type element); \
+    BT_ARENA_NODE(type)* type##_bt_arena_get(BT_ARENA(type)* arena, uint32_t index); \
+    bool type##_bt_arena_relayout(BT_ARENA(type)* arena); \
+    BT_ARENA(type)* type##_bt_arena_from_bt(BT(type)* tree); \
+    BT(type)* type##_bt_arena_into_bt(const BT_ARENA(type)* arena);
+
+/** @def DEF_BT_ARENA(type)
+    @param type The type of the binary trees
+
+    Defines the functions associated with `BT_ARENA(type)`.
+    Requires `DECL_BT(type)`, `DEF_BT(type)` and `DECL_BT_ARENA(type)` to have been called beforehand.
+**/
+#define DEF_BT_ARENA(type) \
+    BT_ARENA(type)* type##_bt_arena_new(uint32_t capacity) { \
+        if (capacity == 0) capacity = 1; \
+        if (capacity >= BT_ARENA_NULL) return NULL; \
+        BT_ARENA(type)* res = (BT_ARENA(type)*)malloc(sizeof(struct type##_bt_arena)); \
+        if (res == NULL) return NULL; \
+        res->nodes = (BT_ARENA_NODE(type)*)malloc(sizeof(struct type##_bt_arena_node) * capacity); \
+        if (res->nodes == NULL) { \
+            free(res); \
+            return NULL; \
+        } \
+        res->length = 0; \
+        res->capacity = capacity; \
+        res->root = BT_ARENA_NULL; \
+        return res; \
+    } \
+    void type##_bt_arena_free(BT_ARENA(type)* arena) { \
+        if (arena == NULL) return; \
+        free(arena->nodes); \
+        free(arena); \
+    } \
+    void type##_bt_arena_clear(BT_ARENA(type)* arena) { \
+        if (arena == NULL) return; \
+        arena->length = 0; \
+        arena->root = BT_ARENA_NULL; \
+    } \
+    uint32_t type##_bt_arena_length(const BT_ARENA(type)* arena) { \
+        if (arena == NULL) return 0; \
+        return arena->length; \
+    } \
+    uint32_t type##_bt_arena_new_node(BT_ARENA(type)* arena, type element) { \
+        if (arena == NULL) return BT_ARENA_NULL; \
+        if (arena->length == arena->capacity) { \
+            if (arena->capacity >= BT_ARENA_NULL / 2) return BT_ARENA_NULL; \
+            BT_ARENA_NODE(type)* nodes = (BT_ARENA_NODE(type)*)realloc(arena->nodes, sizeof(struct type##_bt_arena_node) * arena->capacity * 2); \
+            if (nodes == NULL) return BT_ARENA_NULL; \
+            arena->nodes = nodes; \
+            arena->capacity *= 2; \
+        } \
+        BT_ARENA_NODE(type)* node = &arena->nodes[arena->length]; \
+        node->value = element; \
+        node->left = BT_ARENA_NULL; \
+        node->right = BT_ARENA_NULL; \
+        return arena->length++; \
+    } \
+    uint32_t type##_bt_arena_connect(BT_ARENA(type)* arena, uint32_t left, uint32_t right, type element) { \
+        uint32_t res = type##_bt_arena_new_node(arena, element); \
+        if (res == BT_ARENA_NULL) return BT_ARENA_NULL; \
+        arena->nodes[res].left = left; \
+        arena->nodes[res].right = right; \
+        return res; \
+    } \
+    BT_ARENA_NODE(type)* type##_bt_arena_get(BT_ARENA(type)* arena, uint32_t index) { \
+        if (arena == NULL || index >= arena->length) return NULL; \
+        return &arena->nodes[index]; \
+    } \
+    /* Copies the tree breadth-first into `nodes`, which then doubles as the queue: node n's children are appended once node n is reached */ \
+    /* A tree has at most `arena->length` nodes: visiting more means that nodes are shared or form a cycle, and BT_ARENA_NULL is returned */ \
+    static uint32_t type##_bt_arena_bfs_copy(const BT_ARENA(type)* arena, BT_ARENA_NODE(type)* nodes) { \
+        if (arena->root == BT_ARENA_NULL) return 0; \
+        if (arena->root >= arena->length) return BT_ARENA_NULL; \
+        uint32_t length = 1; \
+        nodes[0] = arena->nodes[arena->root]; \
+        for (uint32_t n = 0; n < length; n++) { \
+            if (nodes[n].left != BT_ARENA_NULL) { \
+                if (length == arena->length || nodes[n].left >= arena->length) return BT_ARENA_NULL; \
+                nodes[length] = arena->nodes[nodes[n].left]; \
+                nodes[n].left = length++; \
+            } \
+            if (nodes[n].right != BT_ARENA_NULL) { \
+                if (length == arena->length || nodes[n].right >= arena->length) return BT_ARENA_NULL; \
+                nodes[length] = arena->nodes[nodes[n].right]; \
+                nodes[n].right = length++; \
+            } \
+        } \
+        return length; \
+    } \
+    bool type##_bt_arena_relayout(BT_ARENA(type)* arena) { \
+        if (arena == NULL) return false; \
+        BT_ARENA_NODE(type)* nodes = (BT_ARENA_NODE(type)*)malloc(sizeof(struct type##_bt_arena_node) * arena->capacity); \
+        if (nodes == NULL) return false; \
+        uint32_t length = type##_bt_arena_bfs_copy(arena, nodes); \
+        if (length == BT_ARENA_NULL) { \
+            free(nodes); \
+            return false; \
+        } \
+        arena->length = length; \
+        arena->root = length > 0 ? 0 : BT_ARENA_NULL; \
+        free(arena->nodes); \
+        arena->nodes = nodes; \
+        return true; \
+    } \
+    BT_ARENA(type)* type##_bt_arena_from_bt(BT(type)* tree) { \
+        size_t size = type##_bt_size(tree); \
+        if (size >= BT_ARENA_NULL) return NULL; \
+        BT_ARENA(type)* res = type##_bt_arena_new((uint32_t)size); \
+        if (res == NULL || tree == NULL) return res; \
+        BT(type)** queue = (BT(type)**)malloc(sizeof(BT(type)*) * size); \
+        if (queue == NULL) { \
+            type##_bt_arena_free(res); \
+            return NULL; \
+        } \
+        /* Same breadth-first scheme as type##_bt_arena_bfs_copy, with `queue` remembering the original nodes */ \
+        queue[0] = tree; \
+        res->length = 1; \
+        for (uint32_t n = 0; n < res->length; n++) { \
+            BT_ARENA_NODE(type)* node = &res->nodes[n]; \
+            node->value = queue[n]->value; \
+            node->left = node->right = BT_ARENA_NULL; \
+            if (queue[n]->left != NULL) { \
+                queue[res->length] = queue[n]->left; \
+                node->left = res->length++; \
+            } \
+            if (queue[n]->right != NULL) { \
+                queue[res->length] = queue[n]->right; \
+                node->right = res->length++; \
+            } \
+        } \
+        free(queue); \
+        res->root = 0; \
+        return res; \
+    } \
+    static BT(type)* type##_bt_arena_into_bt_rec(const BT_ARENA(type)* arena, uint32_t index) { \
+        if (index == BT_ARENA_NULL) return NULL; \
+        const BT_ARENA_NODE(type)* node = &arena->nodes[index]; \
+        return type##_bt_connect(type##_bt_arena_into_bt_rec(arena, node->left), type##_bt_arena_into_bt_rec(arena, node->right), node->value); \
+    } \
+    BT(type)* type##_bt_arena_into_bt(const BT_ARENA(type)* arena) { \
+        if (arena == NULL) return NULL; \
+        return type##_bt_arena_into_bt_rec(arena, arena->root); \
+    }
+
+/** @struct TYPE_bt_arena
+
+    A contiguous, growable array of binary tree nodes, along with the index of the root of the tree they form (`root`, `BT_ARENA_NULL` for an empty tree).
+    Children are referred to by their index in `nodes`, so that an `int` node takes 12 bytes instead of 24 bytes plus the allocator's overhead,
+    and the whole array can be copied or written to a file as-is.
+
+    Nodes are never freed one by one: the whole arena is freed at once, in `O(1)`, and `TYPE_bt_arena_relayout` drops the nodes that are no longer part of the tree.
+**/
+
+/** @typedef TYPE_bt_arena_t
+
+    Resolves to `struct TYPE_bt_arena`; can also be accessed with `BT_ARENA(TYPE)`.
+**/
+
+/** @fn TYPE_bt_arena_new(uint32_t capacity)
+    @param capacity The number of nodes to make room for
+    @returns A new, empty arena, or NULL on allocation failure
+**/
+
+/** @fn TYPE_bt_arena_free(BT_ARENA(TYPE)* arena)
+    @param arena The arena to free
+
+    Frees the arena and every node in it.
+**/
+
+/** @fn TYPE_bt_arena_clear(BT_ARENA(TYPE)* arena)
+    @param arena The arena to empty
+
+    Drops every node of the arena, in `O(1)`; its memory is kept for the next nodes.
+**/
+
+/** @fn TYPE_bt_arena_length(const BT_ARENA(TYPE)* arena)
+    @returns The number of nodes allocated in `arena`, including those that are not reachable from its root
+**/
+
+/** @fn TYPE_bt_arena_new_node(BT_ARENA(TYPE)* arena, TYPE element)
+    @param arena The arena to allocate the node in
+    @param element The value of the new node
+    @returns The index of the new node, which has no children, or `BT_ARENA_NULL` on allocation failure
+
+    The array of nodes doubles in size when it is full, which moves it: pointers returned by `TYPE_bt_arena_get` are invalidated, but indices are not.
+**/
+
+/** @fn TYPE_bt_arena_connect(BT_ARENA(TYPE)* arena, uint32_t left, uint32_t right, TYPE element)
+    @param left The index of the left child, or `BT_ARENA_NULL`
+    @param right The index of the right child, or `BT_ARENA_NULL`
+    @returns The index of the new node, or `BT_ARENA_NULL` on allocation failure
+
+    The counterpart of `TYPE_bt_connect`; `arena->root` must be set by the caller once the tree is complete.
+**/
+
+/** @fn TYPE_bt_arena_get(BT_ARENA(TYPE)* arena, uint32_t index)
+    @returns A pointer to the node at `index`, or NULL if `index` is out of bounds; it is valid until the next node is allocated
+**/
+
+/** @fn TYPE_bt_arena_relayout(BT_ARENA(TYPE)* arena)
+    @returns false on allocation failure, or if the root reaches more nodes than the arena holds; true otherwise
+
+    The nodes are expected to form a tree. If they do not, a shared node is copied once per path that reaches it; a cycle, or sharing that would
+    copy more nodes than the arena holds, makes the relayout fail rather than write past the new array.
+
+    Moves the nodes of the tree in breadth-first order, with the root at index 0, and drops the nodes that are not reachable from the root.
+    The top levels of the tree are then packed together at the start of the array, which speeds up searches.
+    All indices are invalidated, unless it fails, in which case the arena is left untouched.
+**/
+
+/** @fn TYPE_bt_arena_from_bt(BT(TYPE)* tree)
+    @param tree The tree to copy
+    @returns A new arena holding a copy of `tree` in breadth-first order, or NULL on allocation failure
+**/
+
+/** @fn TYPE_bt_arena_into_bt(const BT_ARENA(TYPE)* arena)
+    @param arena The arena to copy
+    @returns A copy of the tree of `arena` made of `BT(TYPE)` nodes
+**/
+
+#endif // BTREE_ARENA_H
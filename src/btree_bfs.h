@@ -0,0 +1,194 @@
+#ifndef BTREE_BFS_H
+#define BTREE_BFS_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include "btree.h"
+#include "ring.h"
+
+#define BT_BFS(type) type##_bt_bfs_t
+
+/// The initial capacity of the queues used by the breadth-first walks
+#define BT_BFS_INITIAL_CAPACITY 16
+
+/** @def DECL_BT_BFS(type)
+    @param type The type of the binary tree
+
+    Declares the breadth-first (level-order) walks of binary trees, and the associated iterator.
+    This macro requires `DECL_BT(type)` to have been called beforehand.
+
+    The walks never recurse: they queue the nodes to visit in a `RING(TYPE_bt_ptr)`, which this macro declares along with the `TYPE_bt_ptr` type (a pointer to `BT(type)`).
+**/
+#define DECL_BT_BFS(type) typedef BT(type)* type##_bt_ptr; \
+    DECL_RING(type##_bt_ptr); \
+    struct type##_bt_bfs { \
+        RING(type##_bt_ptr)* queue; \
+        size_t depth; \
+        size_t level_left; \
+        size_t next_level; \
+    }; \
+    typedef struct type##_bt_bfs BT_BFS(type); \
+    BT(type)* type##_bt_bfs_find(BT(type)* tree, bool (*predicate)(const type, const void*), const void* predicate_data); \
+    BT_BFS(type)* type##_bt_bfs_new(BT(type)* tree); \
+    void type##_bt_bfs_free(BT_BFS(type)* iterator); \
+    BT(type)* type##_bt_bfs_next(BT_BFS(type)* iterator); \
+    size_t type##_bt_bfs_depth(const BT_BFS(type)* iterator); \
+    size_t* type##_bt_level_widths(BT(type)* tree, size_t* depth);
+
+/** @def DEF_BT_BFS(type)
+    @param type The type of the binary tree
+
+    Defines the functions declared by `DECL_BT_BFS(type)`, including those of `RING(TYPE_bt_ptr)`.
+    Requires `DECL_BT(type)`, `DEF_BT(type)` and `DECL_BT_BFS(type)` to have been called beforehand.
+**/
+#define DEF_BT_BFS(type) \
+    DEF_RING(type##_bt_ptr); \
+    /* Queues the children of `node`; returns how many were queued, or -1 if the queue could not grow */ \
+    static int type##_bt_bfs_push_children(RING(type##_bt_ptr)* queue, BT(type)* node) { \
+        int res = 0; \
+        if (node->left != NULL) { \
+            if (type##_bt_ptr_ring_push_head(queue, node->left) == 0) return -1; \
+            res++; \
+        } \
+        if (node->right != NULL) { \
+            if (type##_bt_ptr_ring_push_head(queue, node->right) == 0) return -1; \
+            res++; \
+        } \
+        return res; \
+    } \
+    BT(type)* type##_bt_bfs_find(BT(type)* tree, bool (*predicate)(const type, const void*), const void* predicate_data) { \
+        if (tree == NULL) return NULL; \
+        RING(type##_bt_ptr)* queue = type##_bt_ptr_ring_new(BT_BFS_INITIAL_CAPACITY); \
+        if (queue == NULL) return NULL; \
+        type##_bt_ptr_ring_push_head(queue, tree); \
+        BT(type)* res = NULL; \
+        while (type##_bt_ptr_ring_length(queue) > 0) { \
+            BT(type)* node = type##_bt_ptr_ring_pop_tail(queue); \
+            if (predicate(node->value, predicate_data)) { \
+                res = node; \
+                break; \
+            } \
+            if (type##_bt_bfs_push_children(queue, node) < 0) break; \
+        } \
+        type##_bt_ptr_ring_free(queue); \
+        return res; \
+    } \
+    BT_BFS(type)* type##_bt_bfs_new(BT(type)* tree) { \
+        BT_BFS(type)* res = (BT_BFS(type)*)malloc(sizeof(struct type##_bt_bfs)); \
+        if (res == NULL) return NULL; \
+        res->queue = type##_bt_ptr_ring_new(BT_BFS_INITIAL_CAPACITY); \
+        if (res->queue == NULL) { \
+            free(res); \
+            return NULL; \
+        } \
+        res->depth = 0; \
+        res->level_left = 0; \
+        res->next_level = 0; \
+        if (tree != NULL) { \
+            type##_bt_ptr_ring_push_head(res->queue, tree); \
+            res->level_left = 1; \
+        } \
+        return res; \
+    } \
+    void type##_bt_bfs_free(BT_BFS(type)* iterator) { \
+        if (iterator == NULL) return; \
+        type##_bt_ptr_ring_free(iterator->queue); \
+        free(iterator); \
+    } \
+    BT(type)* type##_bt_bfs_next(BT_BFS(type)* iterator) { \
+        if (iterator == NULL || type##_bt_ptr_ring_length(iterator->queue) == 0) return NULL; \
+        if (iterator->level_left == 0) { \
+            iterator->depth++; \
+            iterator->level_left = iterator->next_level; \
+            iterator->next_level = 0; \
+        } \
+        BT(type)* node = type##_bt_ptr_ring_pop_tail(iterator->queue); \
+        iterator->level_left--; \
+        int children = type##_bt_bfs_push_children(iterator->queue, node); \
+        if (children < 0) { \
+            iterator->queue->length = 0; \
+            return NULL; \
+        } \
+        iterator->next_level += (size_t)children; \
+        return node; \
+    } \
+    size_t type##_bt_bfs_depth(const BT_BFS(type)* iterator) { \
+        if (iterator == NULL) return 0; \
+        return iterator->depth; \
+    } \
+    size_t* type##_bt_level_widths(BT(type)* tree, size_t* depth) { \
+        *depth = 0; \
+        if (tree == NULL) return NULL; \
+        RING(type##_bt_ptr)* queue = type##_bt_ptr_ring_new(BT_BFS_INITIAL_CAPACITY); \
+        size_t capacity = 16; \
+        size_t* res = (size_t*)malloc(sizeof(size_t) * capacity); \
+        if (queue == NULL || res == NULL) goto fail; \
+        type##_bt_ptr_ring_push_head(queue, tree); \
+        while (type##_bt_ptr_ring_length(queue) > 0) { \
+            size_t width = type##_bt_ptr_ring_length(queue); \
+            if (*depth == capacity) { \
+                size_t* new_res = (size_t*)realloc(res, sizeof(size_t) * capacity * 2); \
+                if (new_res == NULL) goto fail; \
+                res = new_res; \
+                capacity *= 2; \
+            } \
+            res[(*depth)++] = width; \
+            for (size_t n = 0; n < width; n++) { \
+                if (type##_bt_bfs_push_children(queue, type##_bt_ptr_ring_pop_tail(queue)) < 0) goto fail; \
+            } \
+        } \
+        type##_bt_ptr_ring_free(queue); \
+        return res; \
+    fail: \
+        type##_bt_ptr_ring_free(queue); \
+        free(res); \
+        *depth = 0; \
+        return NULL; \
+    }
+
+/** @struct TYPE_bt_bfs
+
+    An iterator visiting the nodes of a binary tree level by level, from left to right.
+    It holds the nodes that remain to be visited in a queue, whose size is at most the width of the tree.
+**/
+
+/** @typedef TYPE_bt_bfs_t
+
+    Resolves to `struct TYPE_bt_bfs`; can also be accessed with `BT_BFS(TYPE)`.
+**/
+
+/** @fn TYPE_bt_bfs_find(BT(TYPE)* tree, bool (*predicate)(const TYPE, const void*), const void* predicate_data)
+    @param tree The tree to search
+    @param predicate The predicate to match the values against
+    @param predicate_data Passed to `predicate`
+    @returns The shallowest node (the leftmost one among equally shallow nodes) whose value matches `predicate`, or NULL if there is none or on allocation failure
+
+    Unlike `TYPE_bt_prefix_find`, nodes close to the root are visited first, however deep the other subtrees are.
+**/
+
+/** @fn TYPE_bt_bfs_new(BT(TYPE)* tree)
+    @param tree The tree to walk; may be NULL
+    @returns A new iterator on `tree`, or NULL on allocation failure
+**/
+
+/** @fn TYPE_bt_bfs_free(BT_BFS(TYPE)* iterator)
+    @param iterator The iterator to free; the tree is left untouched
+**/
+
+/** @fn TYPE_bt_bfs_next(BT_BFS(TYPE)* iterator)
+    @returns The next node in level order, or NULL once every node has been visited or on allocation failure
+
+    The iteration may be stopped at any point.
+**/
+
+/** @fn TYPE_bt_bfs_depth(const BT_BFS(TYPE)* iterator)
+    @returns The level of the last node returned by `TYPE_bt_bfs_next`, the root being at level 0
+**/
+
+/** @fn TYPE_bt_level_widths(BT(TYPE)* tree, size_t* depth)
+    @param tree The tree to measure
+    @param depth Where to write the number of levels of `tree`
+    @returns A `malloc`-ed array holding the number of nodes of each level of `tree`, or NULL if it is empty or on allocation failure
+**/
+
+#endif // BTREE_BFS_H
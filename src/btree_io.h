@@ -0,0 +1,296 @@
+#ifndef BTREE_IO_H
+#define BTREE_IO_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include "btree.h"
+
+#define BT_VIEW(type) type##_bt_view_t
+
+/// The first four bytes of a serialized tree
+#define BT_IO_MAGIC "LCBT"
+
+/// The size of the header of a serialized tree: the magic, the size of a value (uint32) and the number of nodes (uint64)
+#define BT_IO_HEADER_SIZE 16
+
+/// The offset of the values in a serialized tree of `length` nodes; they are aligned on 16 bytes, so that a page-aligned mapping of the file can be read in place
+#define BT_IO_VALUES_OFFSET(length) ((BT_IO_HEADER_SIZE + ((size_t)(length) + 3) / 4 + 15) & ~(size_t)15)
+
+/// How many bytes `TYPE_bt_deserialize_file` allocates before it has read anything past the header; the buffer then doubles as needed
+#define BT_IO_READ_CHUNK ((size_t)1 << 16)
+
+/** @def DECL_BT_IO(type)
+    @param type The type of the binary tree
+
+    Declares the functions that serialize binary trees to a compact binary format and load them back, and a read-only view on serialized trees.
+    This macro requires `DECL_BT(type)` to have been called beforehand.
+
+    A serialized tree is made of a header, two bits per node telling whether it has a left and a right child, in prefix order, and the raw bytes of the values, in prefix order.
+    Values are written as they are in memory, so they must not contain pointers, and trees must be read back on a machine with the same byte order.
+**/
+#define DECL_BT_IO(type) struct type##_bt_view { \
+        const uint8_t* structure; \
+        const uint8_t* values; \
+        size_t length; \
+    }; \
+    typedef struct type##_bt_view BT_VIEW(type); \
+    size_t type##_bt_serialized_size(BT(type)* tree); \
+    size_t type##_bt_serialize(BT(type)* tree, void* buffer, size_t capacity); \
+    bool type##_bt_serialize_file(BT(type)* tree, FILE* file); \
+    BT(type)* type##_bt_deserialize(const void* buffer, size_t size); \
+    BT(type)* type##_bt_deserialize_file(FILE* file); \
+    bool type##_bt_view_open(BT_VIEW(type)* view, const void* buffer, size_t size); \
+    size_t type##_bt_view_length(const BT_VIEW(type)* view); \
+    type type##_bt_view_get(const BT_VIEW(type)* view, size_t index); \
+    size_t type##_bt_view_prefix_find(const BT_VIEW(type)* view, bool (*predicate)(const type, const void*), const void* predicate_data);
+
+/** @def DEF_BT_IO(type)
+    @param type The type of the binary tree
+
+    Defines the functions declared by `DECL_BT_IO(type)`.
+    Requires `DECL_BT(type)`, `DEF_BT(type)` and `DECL_BT_IO(type)` to have been called beforehand.
+**/
+#define DEF_BT_IO(type) \
+    /* Walks the tree in prefix order with an explicit stack, so that degenerate trees cannot overflow the stack, counting the nodes in `length`; */ \
+    /* if `structure` is not NULL, also writes their bits and values; false if the stack could not be allocated */ \
+    static bool type##_bt_io_walk(BT(type)* tree, uint8_t* structure, uint8_t* values, size_t* length) { \
+        /* The right children still to visit once the left subtree of their parent is done */ \
+        BT(type)** pending = NULL; \
+        size_t count = 0; \
+        size_t capacity = 0; \
+        size_t n = 0; \
+        while (tree != NULL) { \
+            if (structure != NULL) { \
+                structure[n / 4] |= (uint8_t)(((tree->left != NULL) | (tree->right != NULL) << 1) << (n % 4 * 2)); \
+                memcpy(values + n * sizeof(type), &tree->value, sizeof(type)); \
+            } \
+            n++; \
+            if (tree->left != NULL) { \
+                if (tree->right != NULL) { \
+                    if (count == capacity) { \
+                        capacity = capacity == 0 ? 16 : capacity * 2; \
+                        BT(type)** grown = (BT(type)**)realloc(pending, sizeof(BT(type)*) * capacity); \
+                        if (grown == NULL) { \
+                            free(pending); \
+                            return false; \
+                        } \
+                        pending = grown; \
+                    } \
+                    pending[count++] = tree->right; \
+                } \
+                tree = tree->left; \
+            } else if (tree->right != NULL) { \
+                tree = tree->right; \
+            } else { \
+                tree = count > 0 ? pending[--count] : NULL; \
+            } \
+        } \
+        free(pending); \
+        *length = n; \
+        return true; \
+    } \
+    size_t type##_bt_serialized_size(BT(type)* tree) { \
+        size_t length; \
+        if (!type##_bt_io_walk(tree, NULL, NULL, &length)) return 0; \
+        return BT_IO_VALUES_OFFSET(length) + length * sizeof(type); \
+    } \
+    size_t type##_bt_serialize(BT(type)* tree, void* buffer, size_t capacity) { \
+        size_t length; \
+        if (buffer == NULL || !type##_bt_io_walk(tree, NULL, NULL, &length)) return 0; \
+        size_t offset = BT_IO_VALUES_OFFSET(length); \
+        size_t size = offset + length * sizeof(type); \
+        if (capacity < size) return 0; \
+        uint8_t* bytes = (uint8_t*)buffer; \
+        uint32_t value_size = (uint32_t)sizeof(type); \
+        uint64_t length64 = (uint64_t)length; \
+        memcpy(bytes, BT_IO_MAGIC, 4); \
+        memcpy(bytes + 4, &value_size, 4); \
+        memcpy(bytes + 8, &length64, 8); \
+        memset(bytes + BT_IO_HEADER_SIZE, 0, offset - BT_IO_HEADER_SIZE); \
+        if (!type##_bt_io_walk(tree, bytes + BT_IO_HEADER_SIZE, bytes + offset, &length)) return 0; \
+        return size; \
+    } \
+    bool type##_bt_serialize_file(BT(type)* tree, FILE* file) { \
+        if (file == NULL) return false; \
+        size_t size = type##_bt_serialized_size(tree); \
+        if (size == 0) return false; \
+        void* buffer = malloc(size); \
+        if (buffer == NULL) return false; \
+        bool res = type##_bt_serialize(tree, buffer, size) == size && fwrite(buffer, 1, size, file) == size; \
+        free(buffer); \
+        return res; \
+    } \
+    /* Checks the magic and the value size of a header, and returns the size of the whole serialized tree in `size`; false if the header is not one of a tree of `type` */ \
+    static bool type##_bt_io_header(const uint8_t* header, uint64_t* length, size_t* size) { \
+        uint32_t value_size; \
+        memcpy(&value_size, header + 4, 4); \
+        memcpy(length, header + 8, 8); \
+        if (memcmp(header, BT_IO_MAGIC, 4) != 0 || value_size != sizeof(type)) return false; \
+        if (*length > (SIZE_MAX - BT_IO_HEADER_SIZE) / sizeof(type) / 2) return false; \
+        *size = BT_IO_VALUES_OFFSET(*length) + (size_t)*length * sizeof(type); \
+        return true; \
+    } \
+    bool type##_bt_view_open(BT_VIEW(type)* view, const void* buffer, size_t size) { \
+        if (view == NULL || buffer == NULL || size < BT_IO_HEADER_SIZE) return false; \
+        const uint8_t* bytes = (const uint8_t*)buffer; \
+        uint64_t length; \
+        size_t expected; \
+        if (!type##_bt_io_header(bytes, &length, &expected) || size < expected) return false; \
+        view->structure = bytes + BT_IO_HEADER_SIZE; \
+        view->values = bytes + BT_IO_VALUES_OFFSET(length); \
+        view->length = (size_t)length; \
+        return true; \
+    } \
+    size_t type##_bt_view_length(const BT_VIEW(type)* view) { \
+        if (view == NULL) return 0; \
+        return view->length; \
+    } \
+    type type##_bt_view_get(const BT_VIEW(type)* view, size_t index) { \
+        type res; \
+        memcpy(&res, view->values + index * sizeof(type), sizeof(type)); \
+        return res; \
+    } \
+    size_t type##_bt_view_prefix_find(const BT_VIEW(type)* view, bool (*predicate)(const type, const void*), const void* predicate_data) { \
+        if (view == NULL) return 0; \
+        for (size_t n = 0; n < view->length; n++) { \
+            if (predicate(type##_bt_view_get(view, n), predicate_data)) return n; \
+        } \
+        return view->length; \
+    } \
+    /* Links the nodes in prefix order, without recursing, so that degenerate trees cannot overflow the stack; */ \
+    /* fails unless the structure asks for exactly as many nodes as there are */ \
+    static bool type##_bt_deserialize_links(const BT_VIEW(type)* view, BT(type)* nodes, BT(type)** root) { \
+        /* The nodes whose right child comes after their left subtree, chained through their (still unused) right pointer */ \
+        BT(type)* pending = NULL; \
+        BT(type)** link = root; \
+        for (size_t n = 0; n < view->length; n++) { \
+            BT(type)* node = &nodes[n]; \
+            *link = node; \
+            node->value = type##_bt_view_get(view, n); \
+            node->left = NULL; \
+            node->right = NULL; \
+            unsigned children = view->structure[n / 4] >> (n % 4 * 2) & 3; \
+            if (children & 1) { \
+                if (children & 2) { \
+                    node->right = pending; \
+                    pending = node; \
+                } \
+                link = &node->left; \
+            } else if (children & 2) { \
+                link = &node->right; \
+            } else if (pending != NULL) { \
+                BT(type)* parent = pending; \
+                pending = parent->right; \
+                parent->right = NULL; \
+                link = &parent->right; \
+            } else { \
+                /* The tree is complete */ \
+                return n + 1 == view->length; \
+            } \
+        } \
+        return false; \
+    } \
+    BT(type)* type##_bt_deserialize(const void* buffer, size_t size) { \
+        BT_VIEW(type) view; \
+        if (!type##_bt_view_open(&view, buffer, size) || view.length == 0) return NULL; \
+        BT(type)* nodes = (BT(type)*)malloc(sizeof(struct type##_bt) * view.length); \
+        if (nodes == NULL) return NULL; \
+        BT(type)* res = NULL; \
+        if (!type##_bt_deserialize_links(&view, nodes, &res)) { \
+            free(nodes); \
+            return NULL; \
+        } \
+        return res; \
+    } \
+    BT(type)* type##_bt_deserialize_file(FILE* file) { \
+        if (file == NULL) return NULL; \
+        uint8_t header[BT_IO_HEADER_SIZE]; \
+        if (fread(header, 1, BT_IO_HEADER_SIZE, file) != BT_IO_HEADER_SIZE) return NULL; \
+        uint64_t length; \
+        size_t size; \
+        if (!type##_bt_io_header(header, &length, &size)) return NULL; \
+        /* The buffer grows as the data comes in, so that a forged length cannot make it much larger than the file */ \
+        size_t capacity = size < BT_IO_READ_CHUNK ? size : BT_IO_READ_CHUNK; \
+        uint8_t* buffer = (uint8_t*)malloc(capacity); \
+        if (buffer == NULL) return NULL; \
+        memcpy(buffer, header, BT_IO_HEADER_SIZE); \
+        size_t read = BT_IO_HEADER_SIZE; \
+        while (read < size) { \
+            if (read == capacity) { \
+                capacity = capacity <= size / 2 ? capacity * 2 : size; \
+                uint8_t* grown = (uint8_t*)realloc(buffer, capacity); \
+                if (grown == NULL) break; \
+                buffer = grown; \
+            } \
+            size_t count = fread(buffer + read, 1, capacity - read, file); \
+            if (count == 0) break; \
+            read += count; \
+        } \
+        BT(type)* res = read == size ? type##_bt_deserialize(buffer, size) : NULL; \
+        free(buffer); \
+        return res; \
+    }
+
+/** @struct TYPE_bt_view
+
+    A read-only view on a serialized tree, which reads it where it lies (for instance in a memory-mapped file) without allocating.
+    Nodes are designated by their index in prefix order: the root is at index 0, and the left child of a node, if any, directly follows it.
+**/
+
+/** @fn TYPE_bt_serialized_size(BT(TYPE)* tree)
+    @returns The number of bytes `TYPE_bt_serialize` needs to serialize `tree`, or 0 on allocation failure
+
+    Counts the nodes without recursing, so that degenerate trees cannot overflow the stack.
+**/
+
+/** @fn TYPE_bt_serialize(BT(TYPE)* tree, void* buffer, size_t capacity)
+    @param tree The tree to serialize; may be NULL
+    @param buffer Where to write the serialized tree
+    @param capacity The size of `buffer`
+    @returns The number of bytes written, or 0 if `buffer` is too small or on allocation failure
+**/
+
+/** @fn TYPE_bt_serialize_file(BT(TYPE)* tree, FILE* file)
+    @returns true if the whole tree was written to `file`, false otherwise
+**/
+
+/** @fn TYPE_bt_deserialize(const void* buffer, size_t size)
+    @param buffer A tree serialized by `TYPE_bt_serialize`
+    @param size The size of `buffer`
+    @returns The deserialized tree, or NULL if it is empty, if `buffer` does not hold a valid tree of `TYPE` or on allocation failure
+
+    All of the nodes are allocated in one block, in prefix order, and the root is the first node of the block:
+    the tree must be freed with `free(tree)` rather than `TYPE_bt_free`, and nodes must not be removed from it.
+**/
+
+/** @fn TYPE_bt_deserialize_file(FILE* file)
+    @returns The tree read from `file`, allocated like in `TYPE_bt_deserialize`, or NULL on failure
+
+    The header is checked before anything else is allocated, and the buffer only grows as the rest of the file is read.
+**/
+
+/** @fn TYPE_bt_view_open(BT_VIEW(TYPE)* view, const void* buffer, size_t size)
+    @param view The view to initialize
+    @param buffer A tree serialized by `TYPE_bt_serialize`; it must outlive the view
+    @param size The size of `buffer`
+    @returns false if `buffer` does not hold a tree of `TYPE`, true otherwise
+**/
+
+/** @fn TYPE_bt_view_length(const BT_VIEW(TYPE)* view)
+    @returns The number of nodes of the viewed tree
+**/
+
+/** @fn TYPE_bt_view_get(const BT_VIEW(TYPE)* view, size_t index)
+    @returns The value of the node at `index`, which must be smaller than the number of nodes
+**/
+
+/** @fn TYPE_bt_view_prefix_find(const BT_VIEW(TYPE)* view, bool (*predicate)(const TYPE, const void*), const void* predicate_data)
+    @returns The index of the first node in prefix order whose value matches `predicate`, or the number of nodes if there is none
+
+    This finds the same node as `TYPE_bt_prefix_find`, with a plain scan of the values.
+**/
+
+#endif // BTREE_IO_H
@@ -0,0 +1,226 @@
+#ifndef BTREE_PAR_H
+#define BTREE_PAR_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "btree.h"
+#include "threadpool.h"
+
+/** @def DECL_BT_PAR(type)
+    @param type The type of the binary tree
+
+    Declares the parallel variants of the BT walks, which run on the built-in thread pool (see `threadpool.h`).
+    This macro requires `DECL_BT(type)` to have been called beforehand.
+**/
+#define DECL_BT_PAR(type) \
+    size_t type##_bt_par_size(BT(type)* tree); \
+    size_t type##_bt_par_depth(BT(type)* tree); \
+    size_t type##_bt_par_leaves(BT(type)* tree); \
+    void type##_bt_par_free(BT(type)* tree); \
+    BT(type)* type##_bt_par_clone(BT(type)* tree); \
+    BT(type)* type##_bt_par_prefix_find(BT(type)* tree, bool (*predicate)(const type, const void*), const void* predicate_data);
+
+/** @def DEF_BT_PAR(type)
+    @param type The type of the binary tree
+
+    Defines the functions declared by `DECL_BT_PAR(type)`.
+    Requires `DECL_BT(type)`, `DEF_BT(type)` and `DECL_BT_PAR(type)` to have been called beforehand.
+
+    The nodes of the first `lists_pool_split_depth()` levels hand their left subtree, if they have one, to the thread pool and walk their right subtree themselves;
+    below these levels, subtrees are walked with the serial functions.
+**/
+#define DEF_BT_PAR(type) \
+    struct type##_bt_par_task { \
+        BT(type)* tree; \
+        size_t depth; \
+        size_t split; \
+        size_t count; \
+        BT(type)* result; \
+        bool (*predicate)(const type, const void*); \
+        const void* predicate_data; \
+        _Atomic(BT(type)*)* found; \
+    }; \
+    static size_t type##_bt_par_size_rec(BT(type)* tree, size_t depth, size_t split); \
+    static void type##_bt_par_size_task(void* data) { \
+        struct type##_bt_par_task* task = (struct type##_bt_par_task*)data; \
+        task->count = type##_bt_par_size_rec(task->tree, task->depth, task->split); \
+    } \
+    static size_t type##_bt_par_size_rec(BT(type)* tree, size_t depth, size_t split) { \
+        if (tree == NULL) return 0; \
+        if (depth >= split) return type##_bt_size(tree); \
+        struct lists_pool_group group = LISTS_POOL_GROUP_INIT; \
+        struct type##_bt_par_task left = {.tree = tree->left, .depth = depth + 1, .split = split}; \
+        if (tree->left != NULL) lists_pool_spawn(&group, type##_bt_par_size_task, &left); \
+        size_t right = type##_bt_par_size_rec(tree->right, depth + 1, split); \
+        lists_pool_wait(&group); \
+        return 1 + left.count + right; \
+    } \
+    size_t type##_bt_par_size(BT(type)* tree) { \
+        return type##_bt_par_size_rec(tree, 0, lists_pool_split_depth()); \
+    } \
+    static size_t type##_bt_par_depth_rec(BT(type)* tree, size_t depth, size_t split); \
+    static void type##_bt_par_depth_task(void* data) { \
+        struct type##_bt_par_task* task = (struct type##_bt_par_task*)data; \
+        task->count = type##_bt_par_depth_rec(task->tree, task->depth, task->split); \
+    } \
+    static size_t type##_bt_par_depth_rec(BT(type)* tree, size_t depth, size_t split) { \
+        if (tree == NULL) return 0; \
+        if (depth >= split) return type##_bt_depth(tree); \
+        struct lists_pool_group group = LISTS_POOL_GROUP_INIT; \
+        struct type##_bt_par_task left = {.tree = tree->left, .depth = depth + 1, .split = split}; \
+        if (tree->left != NULL) lists_pool_spawn(&group, type##_bt_par_depth_task, &left); \
+        size_t right = type##_bt_par_depth_rec(tree->right, depth + 1, split); \
+        lists_pool_wait(&group); \
+        return 1 + (left.count > right ? left.count : right); \
+    } \
+    size_t type##_bt_par_depth(BT(type)* tree) { \
+        return type##_bt_par_depth_rec(tree, 0, lists_pool_split_depth()); \
+    } \
+    static size_t type##_bt_par_leaves_rec(BT(type)* tree, size_t depth, size_t split); \
+    static void type##_bt_par_leaves_task(void* data) { \
+        struct type##_bt_par_task* task = (struct type##_bt_par_task*)data; \
+        task->count = type##_bt_par_leaves_rec(task->tree, task->depth, task->split); \
+    } \
+    static size_t type##_bt_par_leaves_rec(BT(type)* tree, size_t depth, size_t split) { \
+        if (tree == NULL) return 0; \
+        if (depth >= split || (tree->left == NULL && tree->right == NULL)) return type##_bt_leaves(tree); \
+        struct lists_pool_group group = LISTS_POOL_GROUP_INIT; \
+        struct type##_bt_par_task left = {.tree = tree->left, .depth = depth + 1, .split = split}; \
+        if (tree->left != NULL) lists_pool_spawn(&group, type##_bt_par_leaves_task, &left); \
+        size_t right = type##_bt_par_leaves_rec(tree->right, depth + 1, split); \
+        lists_pool_wait(&group); \
+        return left.count + right; \
+    } \
+    size_t type##_bt_par_leaves(BT(type)* tree) { \
+        return type##_bt_par_leaves_rec(tree, 0, lists_pool_split_depth()); \
+    } \
+    static void type##_bt_par_free_rec(BT(type)* tree, size_t depth, size_t split); \
+    static void type##_bt_par_free_task(void* data) { \
+        struct type##_bt_par_task* task = (struct type##_bt_par_task*)data; \
+        type##_bt_par_free_rec(task->tree, task->depth, task->split); \
+    } \
+    static void type##_bt_par_free_rec(BT(type)* tree, size_t depth, size_t split) { \
+        if (tree == NULL) return; \
+        if (depth >= split) { \
+            type##_bt_free(tree); \
+            return; \
+        } \
+        struct lists_pool_group group = LISTS_POOL_GROUP_INIT; \
+        struct type##_bt_par_task left = {.tree = tree->left, .depth = depth + 1, .split = split}; \
+        if (tree->left != NULL) lists_pool_spawn(&group, type##_bt_par_free_task, &left); \
+        type##_bt_par_free_rec(tree->right, depth + 1, split); \
+        lists_pool_wait(&group); \
+        free(tree); \
+    } \
+    void type##_bt_par_free(BT(type)* tree) { \
+        type##_bt_par_free_rec(tree, 0, lists_pool_split_depth()); \
+    } \
+    static BT(type)* type##_bt_par_clone_rec(BT(type)* tree, size_t depth, size_t split); \
+    static void type##_bt_par_clone_task(void* data) { \
+        struct type##_bt_par_task* task = (struct type##_bt_par_task*)data; \
+        task->result = type##_bt_par_clone_rec(task->tree, task->depth, task->split); \
+    } \
+    static BT(type)* type##_bt_par_clone_rec(BT(type)* tree, size_t depth, size_t split) { \
+        if (tree == NULL) return NULL; \
+        if (depth >= split) return type##_bt_clone(tree); \
+        struct lists_pool_group group = LISTS_POOL_GROUP_INIT; \
+        struct type##_bt_par_task left = {.tree = tree->left, .depth = depth + 1, .split = split}; \
+        if (tree->left != NULL) lists_pool_spawn(&group, type##_bt_par_clone_task, &left); \
+        BT(type)* right = type##_bt_par_clone_rec(tree->right, depth + 1, split); \
+        lists_pool_wait(&group); \
+        return type##_bt_connect(left.result, right, tree->value); \
+    } \
+    BT(type)* type##_bt_par_clone(BT(type)* tree) { \
+        return type##_bt_par_clone_rec(tree, 0, lists_pool_split_depth()); \
+    } \
+    /* Serial prefix search that gives up as soon as any task has found a match */ \
+    static void type##_bt_par_prefix_find_serial(BT(type)* tree, struct type##_bt_par_task* task) { \
+        while (tree != NULL) { \
+            if (atomic_load_explicit(task->found, memory_order_relaxed) != NULL) return; \
+            if (task->predicate(tree->value, task->predicate_data)) { \
+                BT(type)* expected = NULL; \
+                atomic_compare_exchange_strong(task->found, &expected, tree); \
+                return; \
+            } \
+            type##_bt_par_prefix_find_serial(tree->left, task); \
+            tree = tree->right; \
+        } \
+    } \
+    static void type##_bt_par_prefix_find_rec(BT(type)* tree, struct type##_bt_par_task* task); \
+    static void type##_bt_par_prefix_find_task(void* data) { \
+        struct type##_bt_par_task* task = (struct type##_bt_par_task*)data; \
+        type##_bt_par_prefix_find_rec(task->tree, task); \
+    } \
+    static void type##_bt_par_prefix_find_rec(BT(type)* tree, struct type##_bt_par_task* task) { \
+        if (tree == NULL || atomic_load_explicit(task->found, memory_order_relaxed) != NULL) return; \
+        if (task->depth >= task->split) { \
+            type##_bt_par_prefix_find_serial(tree, task); \
+            return; \
+        } \
+        if (task->predicate(tree->value, task->predicate_data)) { \
+            BT(type)* expected = NULL; \
+            atomic_compare_exchange_strong(task->found, &expected, tree); \
+            return; \
+        } \
+        struct lists_pool_group group = LISTS_POOL_GROUP_INIT; \
+        struct type##_bt_par_task left = *task; \
+        left.tree = tree->left; \
+        left.depth++; \
+        if (tree->left != NULL) lists_pool_spawn(&group, type##_bt_par_prefix_find_task, &left); \
+        struct type##_bt_par_task right = *task; \
+        right.depth++; \
+        type##_bt_par_prefix_find_rec(tree->right, &right); \
+        lists_pool_wait(&group); \
+    } \
+    BT(type)* type##_bt_par_prefix_find(BT(type)* tree, bool (*predicate)(const type, const void*), const void* predicate_data) { \
+        _Atomic(BT(type)*) found; \
+        atomic_init(&found, NULL); \
+        struct type##_bt_par_task task = { \
+            .depth = 0, \
+            .split = lists_pool_split_depth(), \
+            .predicate = predicate, \
+            .predicate_data = predicate_data, \
+            .found = &found \
+        }; \
+        type##_bt_par_prefix_find_rec(tree, &task); \
+        return atomic_load(&found); \
+    }
+
+/** @fn TYPE_bt_par_size(BT(TYPE)* tree)
+    @param tree The tree to measure
+    @returns The number of nodes in `tree`, like `TYPE_bt_size`
+**/
+
+/** @fn TYPE_bt_par_depth(BT(TYPE)* tree)
+    @param tree The tree to measure
+    @returns The depth of `tree`, like `TYPE_bt_depth`
+**/
+
+/** @fn TYPE_bt_par_leaves(BT(TYPE)* tree)
+    @param tree The tree to measure
+    @returns The number of leaves in `tree`, like `TYPE_bt_leaves`
+**/
+
+/** @fn TYPE_bt_par_free(BT(TYPE)* tree)
+    @param tree The tree to free
+
+    Frees every node of `tree`, like `TYPE_bt_free`.
+**/
+
+/** @fn TYPE_bt_par_clone(BT(TYPE)* tree)
+    @param tree The tree to copy
+    @returns A deep copy of `tree`, like `TYPE_bt_clone`
+**/
+
+/** @fn TYPE_bt_par_prefix_find(BT(TYPE)* tree, bool (*predicate)(const TYPE, const void*), const void* predicate_data)
+    @param tree The tree to search
+    @param predicate The predicate to match the values against; it is called from several threads at once
+    @param predicate_data Passed to `predicate`
+    @returns A node whose value matches `predicate`, or NULL if there is none
+
+    Unlike `TYPE_bt_prefix_find`, the returned node is not necessarily the first match in prefix order, but any match:
+    once a task finds one, the other tasks stop searching.
+**/
+
+#endif // BTREE_PAR_H
@@ -0,0 +1,587 @@
+#ifndef BTREEMAP_H
+#define BTREEMAP_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "vec.h"
+
+#define BTREE_MAP(key_type, value_type) key_type##_##value_type##_btree_map_t
+#define BTREE_MAP_ITER(key_type, value_type) key_type##_##value_type##_btree_map_iter_t
+
+#ifndef BTREE_MAP_NODE_BYTES
+/// The size taken by the keys of a B-tree node; may be defined before including this file. The default spans four cache lines.
+#define BTREE_MAP_NODE_BYTES 256
+#endif
+
+/// The maximum number of keys in a node of a B-tree whose keys are of type `key_type`
+#define BTREE_MAP_CAPACITY(key_type) (BTREE_MAP_NODE_BYTES / sizeof(key_type) < 4 ? 4 : BTREE_MAP_NODE_BYTES / sizeof(key_type))
+
+/** @def DECL_BTREE_MAP(key_type, value_type)
+    @param key_type The type of the keys
+    @param value_type The type of the values
+
+    Declares an ordered map (BTREE_MAP) from `key_type` to `value_type`, backed by a B+ tree, and the BTREE_MAP-associated functions.
+    Every node holds up to `BTREE_MAP_CAPACITY(key_type)` keys, so that a lookup in a map of 10^6 integers only visits 4 nodes.
+    The values are stored in the leaves, which are linked together for range iteration.
+**/
+#define DECL_BTREE_MAP(key_type, value_type) struct key_type##_##value_type##_btree_map_node { \
+        size_t length; \
+        bool leaf; \
+        key_type keys[BTREE_MAP_CAPACITY(key_type)]; \
+    }; \
+    struct key_type##_##value_type##_btree_map_leaf { \
+        struct key_type##_##value_type##_btree_map_node node; \
+        value_type values[BTREE_MAP_CAPACITY(key_type)]; \
+        struct key_type##_##value_type##_btree_map_leaf* next; \
+    }; \
+    struct key_type##_##value_type##_btree_map_inner { \
+        struct key_type##_##value_type##_btree_map_node node; \
+        struct key_type##_##value_type##_btree_map_node* children[BTREE_MAP_CAPACITY(key_type) + 1]; \
+    }; \
+    struct key_type##_##value_type##_btree_map { \
+        struct key_type##_##value_type##_btree_map_node* root; \
+        struct key_type##_##value_type##_btree_map_leaf* first; \
+        size_t length; \
+    }; \
+    typedef struct key_type##_##value_type##_btree_map BTREE_MAP(key_type, value_type); \
+    struct key_type##_##value_type##_btree_map_iter { \
+        struct key_type##_##value_type##_btree_map_leaf* leaf; \
+        size_t index; \
+        const key_type* key; \
+        value_type* value; \
+    }; \
+    typedef struct key_type##_##value_type##_btree_map_iter BTREE_MAP_ITER(key_type, value_type); \
+    BTREE_MAP(key_type, value_type)* key_type##_##value_type##_btree_map_new(void); \
+    void key_type##_##value_type##_btree_map_free(BTREE_MAP(key_type, value_type)* map); \
+    size_t key_type##_##value_type##_btree_map_length(const BTREE_MAP(key_type, value_type)* map); \
+    bool key_type##_##value_type##_btree_map_insert(BTREE_MAP(key_type, value_type)* map, key_type key, value_type value); \
+    value_type* key_type##_##value_type##_btree_map_find(BTREE_MAP(key_type, value_type)* map, key_type key); \
+    bool key_type##_##value_type##_btree_map_erase(BTREE_MAP(key_type, value_type)* map, key_type key); \
+    BTREE_MAP_ITER(key_type, value_type) key_type##_##value_type##_btree_map_first(BTREE_MAP(key_type, value_type)* map); \
+    BTREE_MAP_ITER(key_type, value_type) key_type##_##value_type##_btree_map_lower_bound(BTREE_MAP(key_type, value_type)* map, key_type key); \
+    void key_type##_##value_type##_btree_map_iter_next(BTREE_MAP_ITER(key_type, value_type)* iter); \
+    size_t key_type##_##value_type##_btree_map_for_each_range(BTREE_MAP(key_type, value_type)* map, key_type lo, key_type hi, bool (*callback)(const key_type*, value_type*, void*), void* callback_data);
+
+/** @def DEF_BTREE_MAP(key_type, value_type, cmp)
+    @param key_type The type of the keys
+    @param value_type The type of the values
+    @param cmp A function or macro taking two keys `a` and `b` and returning a negative value if `a < b`, a positive value if `a > b` and 0 if they are equal
+
+    Defines the BTREE_MAP-associated functions.
+    Requires `DECL_BTREE_MAP(key_type, value_type)` to have been called beforehand.
+    `cmp` is expanded inline; the search within a node does not branch on its result, so that it can be auto-vectorized (e.g. at -O3) for arithmetic keys.
+**/
+#define DEF_BTREE_MAP(key_type, value_type, cmp) \
+    /* Both searches scan the whole node without branching, so that they can be auto-vectorized (e.g. at -O3) for arithmetic keys */ \
+    static inline size_t key_type##_##value_type##_btree_map_lower_index(const struct key_type##_##value_type##_btree_map_node* node, key_type key) { \
+        size_t res = 0; \
+        for (size_t n = 0; n < node->length; n++) res += cmp(node->keys[n], key) < 0; \
+        return res; \
+    } \
+    static inline size_t key_type##_##value_type##_btree_map_child_index(const struct key_type##_##value_type##_btree_map_node* node, key_type key) { \
+        size_t res = 0; \
+        for (size_t n = 0; n < node->length; n++) res += cmp(node->keys[n], key) <= 0; \
+        return res; \
+    } \
+    static struct key_type##_##value_type##_btree_map_leaf* key_type##_##value_type##_btree_map_leaf_new(void) { \
+        struct key_type##_##value_type##_btree_map_leaf* res = (struct key_type##_##value_type##_btree_map_leaf*)malloc(sizeof(struct key_type##_##value_type##_btree_map_leaf)); \
+        if (res == NULL) return NULL; \
+        res->node.length = 0; \
+        res->node.leaf = true; \
+        res->next = NULL; \
+        return res; \
+    } \
+    static struct key_type##_##value_type##_btree_map_inner* key_type##_##value_type##_btree_map_inner_new(void) { \
+        struct key_type##_##value_type##_btree_map_inner* res = (struct key_type##_##value_type##_btree_map_inner*)malloc(sizeof(struct key_type##_##value_type##_btree_map_inner)); \
+        if (res == NULL) return NULL; \
+        res->node.length = 0; \
+        res->node.leaf = false; \
+        return res; \
+    } \
+    static void key_type##_##value_type##_btree_map_node_free(struct key_type##_##value_type##_btree_map_node* node) { \
+        if (!node->leaf) { \
+            for (size_t n = 0; n <= node->length; n++) key_type##_##value_type##_btree_map_node_free(((struct key_type##_##value_type##_btree_map_inner*)node)->children[n]); \
+        } \
+        free(node); \
+    } \
+    BTREE_MAP(key_type, value_type)* key_type##_##value_type##_btree_map_new(void) { \
+        BTREE_MAP(key_type, value_type)* res = (BTREE_MAP(key_type, value_type)*)malloc(sizeof(struct key_type##_##value_type##_btree_map)); \
+        if (res == NULL) return NULL; \
+        res->root = NULL; \
+        res->first = NULL; \
+        res->length = 0; \
+        return res; \
+    } \
+    void key_type##_##value_type##_btree_map_free(BTREE_MAP(key_type, value_type)* map) { \
+        if (map == NULL) return; \
+        if (map->root != NULL) key_type##_##value_type##_btree_map_node_free(map->root); \
+        free(map); \
+    } \
+    size_t key_type##_##value_type##_btree_map_length(const BTREE_MAP(key_type, value_type)* map) { \
+        if (map == NULL) return 0; \
+        return map->length; \
+    } \
+    value_type* key_type##_##value_type##_btree_map_find(BTREE_MAP(key_type, value_type)* map, key_type key) { \
+        if (map == NULL || map->root == NULL) return NULL; \
+        struct key_type##_##value_type##_btree_map_node* node = map->root; \
+        while (!node->leaf) node = ((struct key_type##_##value_type##_btree_map_inner*)node)->children[key_type##_##value_type##_btree_map_child_index(node, key)]; \
+        size_t index = key_type##_##value_type##_btree_map_lower_index(node, key); \
+        if (index < node->length && cmp(node->keys[index], key) == 0) return &((struct key_type##_##value_type##_btree_map_leaf*)node)->values[index]; \
+        return NULL; \
+    } \
+    /* Returns 0 if `key` was already present, 1 if it was inserted and 2 if it was inserted and `node` had to be split */ \
+    /* The nodes that splitting needs are taken from `spare_leaf` and `spare_inners` (chained through their first child), which hold exactly as many as needed */ \
+    static int key_type##_##value_type##_btree_map_insert_rec(struct key_type##_##value_type##_btree_map_node* node, key_type key, value_type value, key_type* split_key, struct key_type##_##value_type##_btree_map_node** split_node, struct key_type##_##value_type##_btree_map_leaf** spare_leaf, struct key_type##_##value_type##_btree_map_inner** spare_inners) { \
+        const size_t capacity = BTREE_MAP_CAPACITY(key_type); \
+        const size_t left_length = (capacity + 1) / 2; \
+        if (node->leaf) { \
+            struct key_type##_##value_type##_btree_map_leaf* leaf = (struct key_type##_##value_type##_btree_map_leaf*)node; \
+            size_t index = key_type##_##value_type##_btree_map_lower_index(node, key); \
+            if (index < node->length && cmp(node->keys[index], key) == 0) { \
+                leaf->values[index] = value; \
+                return 0; \
+            } \
+            if (node->length < capacity) { \
+                memmove(&node->keys[index + 1], &node->keys[index], sizeof(key_type) * (node->length - index)); \
+                memmove(&leaf->values[index + 1], &leaf->values[index], sizeof(value_type) * (node->length - index)); \
+                node->keys[index] = key; \
+                leaf->values[index] = value; \
+                node->length++; \
+                return 1; \
+            } \
+            struct key_type##_##value_type##_btree_map_leaf* right = *spare_leaf; \
+            *spare_leaf = NULL; \
+            if (index < left_length) { \
+                size_t moved = capacity - (left_length - 1); \
+                memcpy(right->node.keys, &node->keys[left_length - 1], sizeof(key_type) * moved); \
+                memcpy(right->values, &leaf->values[left_length - 1], sizeof(value_type) * moved); \
+                right->node.length = moved; \
+                memmove(&node->keys[index + 1], &node->keys[index], sizeof(key_type) * (left_length - 1 - index)); \
+                memmove(&leaf->values[index + 1], &leaf->values[index], sizeof(value_type) * (left_length - 1 - index)); \
+                node->keys[index] = key; \
+                leaf->values[index] = value; \
+            } else { \
+                size_t right_index = index - left_length; \
+                memcpy(right->node.keys, &node->keys[left_length], sizeof(key_type) * right_index); \
+                memcpy(right->values, &leaf->values[left_length], sizeof(value_type) * right_index); \
+                right->node.keys[right_index] = key; \
+                right->values[right_index] = value; \
+                memcpy(&right->node.keys[right_index + 1], &node->keys[index], sizeof(key_type) * (capacity - index)); \
+                memcpy(&right->values[right_index + 1], &leaf->values[index], sizeof(value_type) * (capacity - index)); \
+                right->node.length = capacity - left_length + 1; \
+            } \
+            node->length = left_length; \
+            right->next = leaf->next; \
+            leaf->next = right; \
+            *split_key = right->node.keys[0]; \
+            *split_node = &right->node; \
+            return 2; \
+        } \
+        struct key_type##_##value_type##_btree_map_inner* inner = (struct key_type##_##value_type##_btree_map_inner*)node; \
+        size_t index = key_type##_##value_type##_btree_map_child_index(node, key); \
+        key_type child_key; \
+        struct key_type##_##value_type##_btree_map_node* child_split; \
+        int res = key_type##_##value_type##_btree_map_insert_rec(inner->children[index], key, value, &child_key, &child_split, spare_leaf, spare_inners); \
+        if (res != 2) return res; \
+        if (node->length < capacity) { \
+            memmove(&node->keys[index + 1], &node->keys[index], sizeof(key_type) * (node->length - index)); \
+            memmove(&inner->children[index + 2], &inner->children[index + 1], sizeof(struct key_type##_##value_type##_btree_map_node*) * (node->length - index)); \
+            node->keys[index] = child_key; \
+            inner->children[index + 1] = child_split; \
+            node->length++; \
+            return 1; \
+        } \
+        struct key_type##_##value_type##_btree_map_inner* right = *spare_inners; \
+        *spare_inners = (struct key_type##_##value_type##_btree_map_inner*)right->children[0]; \
+        key_type keys[BTREE_MAP_CAPACITY(key_type) + 1]; \
+        struct key_type##_##value_type##_btree_map_node* children[BTREE_MAP_CAPACITY(key_type) + 2]; \
+        memcpy(keys, node->keys, sizeof(key_type) * index); \
+        keys[index] = child_key; \
+        memcpy(&keys[index + 1], &node->keys[index], sizeof(key_type) * (capacity - index)); \
+        memcpy(children, inner->children, sizeof(struct key_type##_##value_type##_btree_map_node*) * (index + 1)); \
+        children[index + 1] = child_split; \
+        memcpy(&children[index + 2], &inner->children[index + 1], sizeof(struct key_type##_##value_type##_btree_map_node*) * (capacity - index)); \
+        size_t right_length = capacity - left_length; \
+        memcpy(node->keys, keys, sizeof(key_type) * left_length); \
+        memcpy(inner->children, children, sizeof(struct key_type##_##value_type##_btree_map_node*) * (left_length + 1)); \
+        node->length = left_length; \
+        memcpy(right->node.keys, &keys[left_length + 1], sizeof(key_type) * right_length); \
+        memcpy(right->children, &children[left_length + 1], sizeof(struct key_type##_##value_type##_btree_map_node*) * (right_length + 1)); \
+        right->node.length = right_length; \
+        *split_key = keys[left_length]; \
+        *split_node = &right->node; \
+        return 2; \
+    } \
+    bool key_type##_##value_type##_btree_map_insert(BTREE_MAP(key_type, value_type)* map, key_type key, value_type value) { \
+        if (map == NULL) return false; \
+        if (map->root == NULL) { \
+            struct key_type##_##value_type##_btree_map_leaf* leaf = key_type##_##value_type##_btree_map_leaf_new(); \
+            if (leaf == NULL) return false; \
+            map->root = &leaf->node; \
+            map->first = leaf; \
+        } \
+        /* Walks the path once to find out which nodes will split, so that the nodes this needs are allocated before anything changes, */ \
+        /* and so that inserts that do not split do not allocate at all: splits start at a full leaf and climb through the full inner nodes right above it */ \
+        const size_t capacity = BTREE_MAP_CAPACITY(key_type); \
+        struct key_type##_##value_type##_btree_map_node* node = map->root; \
+        size_t depth = 0, full = 0; \
+        while (!node->leaf) { \
+            depth++; \
+            full = node->length == capacity ? full + 1 : 0; \
+            node = ((struct key_type##_##value_type##_btree_map_inner*)node)->children[key_type##_##value_type##_btree_map_child_index(node, key)]; \
+        } \
+        size_t index = key_type##_##value_type##_btree_map_lower_index(node, key); \
+        if (index < node->length && cmp(node->keys[index], key) == 0) { \
+            ((struct key_type##_##value_type##_btree_map_leaf*)node)->values[index] = value; \
+            return false; \
+        } \
+        struct key_type##_##value_type##_btree_map_leaf* spare_leaf = NULL; \
+        struct key_type##_##value_type##_btree_map_inner* spare_inners = NULL; \
+        if (node->length == capacity) { \
+            /* When the root splits too, a new root is needed */ \
+            size_t inners = full == depth ? full + 1 : full; \
+            spare_leaf = key_type##_##value_type##_btree_map_leaf_new(); \
+            bool failed = spare_leaf == NULL; \
+            for (size_t n = 0; n < inners && !failed; n++) { \
+                struct key_type##_##value_type##_btree_map_inner* inner = key_type##_##value_type##_btree_map_inner_new(); \
+                if (inner == NULL) { \
+                    failed = true; \
+                } else { \
+                    inner->children[0] = (struct key_type##_##value_type##_btree_map_node*)spare_inners; \
+                    spare_inners = inner; \
+                } \
+            } \
+            if (failed) { \
+                free(spare_leaf); \
+                while (spare_inners != NULL) { \
+                    struct key_type##_##value_type##_btree_map_inner* next = (struct key_type##_##value_type##_btree_map_inner*)spare_inners->children[0]; \
+                    free(spare_inners); \
+                    spare_inners = next; \
+                } \
+                return false; \
+            } \
+        } \
+        key_type split_key; \
+        struct key_type##_##value_type##_btree_map_node* split_node; \
+        int res = key_type##_##value_type##_btree_map_insert_rec(map->root, key, value, &split_key, &split_node, &spare_leaf, &spare_inners); \
+        if (res == 2) { \
+            struct key_type##_##value_type##_btree_map_inner* root = spare_inners; \
+            spare_inners = NULL; \
+            root->node.keys[0] = split_key; \
+            root->children[0] = map->root; \
+            root->children[1] = split_node; \
+            root->node.length = 1; \
+            map->root = &root->node; \
+        } \
+        map->length++; \
+        return true; \
+    } \
+    /* Merges the children `index` and `index + 1` of `inner` */ \
+    static void key_type##_##value_type##_btree_map_merge(struct key_type##_##value_type##_btree_map_inner* inner, size_t index) { \
+        struct key_type##_##value_type##_btree_map_node* left = inner->children[index]; \
+        struct key_type##_##value_type##_btree_map_node* right = inner->children[index + 1]; \
+        if (left->leaf) { \
+            memcpy(&left->keys[left->length], right->keys, sizeof(key_type) * right->length); \
+            memcpy(&((struct key_type##_##value_type##_btree_map_leaf*)left)->values[left->length], ((struct key_type##_##value_type##_btree_map_leaf*)right)->values, sizeof(value_type) * right->length); \
+            left->length += right->length; \
+            ((struct key_type##_##value_type##_btree_map_leaf*)left)->next = ((struct key_type##_##value_type##_btree_map_leaf*)right)->next; \
+        } else { \
+            left->keys[left->length] = inner->node.keys[index]; \
+            memcpy(&left->keys[left->length + 1], right->keys, sizeof(key_type) * right->length); \
+            memcpy(&((struct key_type##_##value_type##_btree_map_inner*)left)->children[left->length + 1], ((struct key_type##_##value_type##_btree_map_inner*)right)->children, sizeof(struct key_type##_##value_type##_btree_map_node*) * (right->length + 1)); \
+            left->length += right->length + 1; \
+        } \
+        free(right); \
+        memmove(&inner->node.keys[index], &inner->node.keys[index + 1], sizeof(key_type) * (inner->node.length - index - 1)); \
+        memmove(&inner->children[index + 1], &inner->children[index + 2], sizeof(struct key_type##_##value_type##_btree_map_node*) * (inner->node.length - index - 1)); \
+        inner->node.length--; \
+    } \
+    /* Moves the last entry of the child `index - 1` of `inner` to the front of the child `index` */ \
+    static void key_type##_##value_type##_btree_map_borrow_left(struct key_type##_##value_type##_btree_map_inner* inner, size_t index) { \
+        struct key_type##_##value_type##_btree_map_node* left = inner->children[index - 1]; \
+        struct key_type##_##value_type##_btree_map_node* child = inner->children[index]; \
+        memmove(&child->keys[1], child->keys, sizeof(key_type) * child->length); \
+        if (child->leaf) { \
+            struct key_type##_##value_type##_btree_map_leaf* child_leaf = (struct key_type##_##value_type##_btree_map_leaf*)child; \
+            memmove(&child_leaf->values[1], child_leaf->values, sizeof(value_type) * child->length); \
+            child->keys[0] = left->keys[left->length - 1]; \
+            child_leaf->values[0] = ((struct key_type##_##value_type##_btree_map_leaf*)left)->values[left->length - 1]; \
+            inner->node.keys[index - 1] = child->keys[0]; \
+        } else { \
+            struct key_type##_##value_type##_btree_map_inner* child_inner = (struct key_type##_##value_type##_btree_map_inner*)child; \
+            memmove(&child_inner->children[1], child_inner->children, sizeof(struct key_type##_##value_type##_btree_map_node*) * (child->length + 1)); \
+            child->keys[0] = inner->node.keys[index - 1]; \
+            child_inner->children[0] = ((struct key_type##_##value_type##_btree_map_inner*)left)->children[left->length]; \
+            inner->node.keys[index - 1] = left->keys[left->length - 1]; \
+        } \
+        left->length--; \
+        child->length++; \
+    } \
+    /* Moves the first entry of the child `index + 1` of `inner` to the back of the child `index` */ \
+    static void key_type##_##value_type##_btree_map_borrow_right(struct key_type##_##value_type##_btree_map_inner* inner, size_t index) { \
+        struct key_type##_##value_type##_btree_map_node* child = inner->children[index]; \
+        struct key_type##_##value_type##_btree_map_node* right = inner->children[index + 1]; \
+        if (child->leaf) { \
+            struct key_type##_##value_type##_btree_map_leaf* right_leaf = (struct key_type##_##value_type##_btree_map_leaf*)right; \
+            child->keys[child->length] = right->keys[0]; \
+            ((struct key_type##_##value_type##_btree_map_leaf*)child)->values[child->length] = right_leaf->values[0]; \
+            memmove(right->keys, &right->keys[1], sizeof(key_type) * (right->length - 1)); \
+            memmove(right_leaf->values, &right_leaf->values[1], sizeof(value_type) * (right->length - 1)); \
+            inner->node.keys[index] = right->keys[0]; \
+        } else { \
+            struct key_type##_##value_type##_btree_map_inner* right_inner = (struct key_type##_##value_type##_btree_map_inner*)right; \
+            child->keys[child->length] = inner->node.keys[index]; \
+            ((struct key_type##_##value_type##_btree_map_inner*)child)->children[child->length + 1] = right_inner->children[0]; \
+            inner->node.keys[index] = right->keys[0]; \
+            memmove(right->keys, &right->keys[1], sizeof(key_type) * (right->length - 1)); \
+            memmove(right_inner->children, &right_inner->children[1], sizeof(struct key_type##_##value_type##_btree_map_node*) * right->length); \
+        } \
+        right->length--; \
+        child->length++; \
+    } \
+    static bool key_type##_##value_type##_btree_map_erase_rec(struct key_type##_##value_type##_btree_map_node* node, key_type key) { \
+        if (node->leaf) { \
+            struct key_type##_##value_type##_btree_map_leaf* leaf = (struct key_type##_##value_type##_btree_map_leaf*)node; \
+            size_t index = key_type##_##value_type##_btree_map_lower_index(node, key); \
+            if (index >= node->length || cmp(node->keys[index], key) != 0) return false; \
+            memmove(&node->keys[index], &node->keys[index + 1], sizeof(key_type) * (node->length - index - 1)); \
+            memmove(&leaf->values[index], &leaf->values[index + 1], sizeof(value_type) * (node->length - index - 1)); \
+            node->length--; \
+            return true; \
+        } \
+        struct key_type##_##value_type##_btree_map_inner* inner = (struct key_type##_##value_type##_btree_map_inner*)node; \
+        size_t index = key_type##_##value_type##_btree_map_child_index(node, key); \
+        if (!key_type##_##value_type##_btree_map_erase_rec(inner->children[index], key)) return false; \
+        if (inner->children[index]->length < (BTREE_MAP_CAPACITY(key_type) / 2)) { \
+            if (index > 0 && inner->children[index - 1]->length > (BTREE_MAP_CAPACITY(key_type) / 2)) key_type##_##value_type##_btree_map_borrow_left(inner, index); \
+            else if (index < node->length && inner->children[index + 1]->length > (BTREE_MAP_CAPACITY(key_type) / 2)) key_type##_##value_type##_btree_map_borrow_right(inner, index); \
+            else if (index > 0) key_type##_##value_type##_btree_map_merge(inner, index - 1); \
+            else key_type##_##value_type##_btree_map_merge(inner, index); \
+        } \
+        return true; \
+    } \
+    bool key_type##_##value_type##_btree_map_erase(BTREE_MAP(key_type, value_type)* map, key_type key) { \
+        if (map == NULL || map->root == NULL) return false; \
+        if (!key_type##_##value_type##_btree_map_erase_rec(map->root, key)) return false; \
+        map->length--; \
+        struct key_type##_##value_type##_btree_map_node* root = map->root; \
+        if (root->leaf && root->length == 0) { \
+            free(root); \
+            map->root = NULL; \
+            map->first = NULL; \
+        } else if (!root->leaf && root->length == 0) { \
+            map->root = ((struct key_type##_##value_type##_btree_map_inner*)root)->children[0]; \
+            free(root); \
+        } \
+        return true; \
+    } \
+    static void key_type##_##value_type##_btree_map_iter_load(BTREE_MAP_ITER(key_type, value_type)* iter) { \
+        while (iter->leaf != NULL && iter->index >= iter->leaf->node.length) { \
+            iter->leaf = iter->leaf->next; \
+            iter->index = 0; \
+        } \
+        if (iter->leaf != NULL) { \
+            iter->key = &iter->leaf->node.keys[iter->index]; \
+            iter->value = &iter->leaf->values[iter->index]; \
+        } else { \
+            iter->key = NULL; \
+            iter->value = NULL; \
+        } \
+    } \
+    BTREE_MAP_ITER(key_type, value_type) key_type##_##value_type##_btree_map_first(BTREE_MAP(key_type, value_type)* map) { \
+        BTREE_MAP_ITER(key_type, value_type) res = {map == NULL ? NULL : map->first, 0, NULL, NULL}; \
+        key_type##_##value_type##_btree_map_iter_load(&res); \
+        return res; \
+    } \
+    BTREE_MAP_ITER(key_type, value_type) key_type##_##value_type##_btree_map_lower_bound(BTREE_MAP(key_type, value_type)* map, key_type key) { \
+        BTREE_MAP_ITER(key_type, value_type) res = {NULL, 0, NULL, NULL}; \
+        if (map == NULL || map->root == NULL) return res; \
+        struct key_type##_##value_type##_btree_map_node* node = map->root; \
+        while (!node->leaf) node = ((struct key_type##_##value_type##_btree_map_inner*)node)->children[key_type##_##value_type##_btree_map_child_index(node, key)]; \
+        res.leaf = (struct key_type##_##value_type##_btree_map_leaf*)node; \
+        res.index = key_type##_##value_type##_btree_map_lower_index(node, key); \
+        key_type##_##value_type##_btree_map_iter_load(&res); \
+        return res; \
+    } \
+    void key_type##_##value_type##_btree_map_iter_next(BTREE_MAP_ITER(key_type, value_type)* iter) { \
+        if (iter == NULL || iter->leaf == NULL) return; \
+        iter->index++; \
+        key_type##_##value_type##_btree_map_iter_load(iter); \
+    } \
+    size_t key_type##_##value_type##_btree_map_for_each_range(BTREE_MAP(key_type, value_type)* map, key_type lo, key_type hi, bool (*callback)(const key_type*, value_type*, void*), void* callback_data) { \
+        size_t res = 0; \
+        BTREE_MAP_ITER(key_type, value_type) iter = key_type##_##value_type##_btree_map_lower_bound(map, lo); \
+        while (iter.key != NULL && cmp(*iter.key, hi) < 0) { \
+            res++; \
+            if (!callback(iter.key, iter.value, callback_data)) break; \
+            key_type##_##value_type##_btree_map_iter_next(&iter); \
+        } \
+        return res; \
+    }
+
+/** @def DECL_BTREE_MAP_VEC(key_type, value_type)
+
+    Declares the BTREE_MAP-associated functions that build a map out of vectors (VEC).
+    This macro requires `DECL_BTREE_MAP(key_type, value_type)`, `DECL_VEC(key_type)` and `DECL_VEC(value_type)` to have been called beforehand.
+**/
+#define DECL_BTREE_MAP_VEC(key_type, value_type) \
+    BTREE_MAP(key_type, value_type)* key_type##_##value_type##_btree_map_from_sorted_vecs(const VEC(key_type)* keys, const VEC(value_type)* values);
+
+/** @def DEF_BTREE_MAP_VEC(key_type, value_type)
+
+    Defines the BTREE_MAP-associated functions that build a map out of vectors (VEC).
+    Requires `DECL_BTREE_MAP(key_type, value_type)`, `DEF_BTREE_MAP(key_type, value_type, cmp)`, `DECL_VEC(key_type)`, `DECL_VEC(value_type)` and `DECL_BTREE_MAP_VEC(key_type, value_type)` to have been called beforehand.
+**/
+#define DEF_BTREE_MAP_VEC(key_type, value_type) \
+    BTREE_MAP(key_type, value_type)* key_type##_##value_type##_btree_map_from_sorted_vecs(const VEC(key_type)* keys, const VEC(value_type)* values) { \
+        const size_t capacity = BTREE_MAP_CAPACITY(key_type); \
+        BTREE_MAP(key_type, value_type)* res = key_type##_##value_type##_btree_map_new(); \
+        if (res == NULL) return NULL; \
+        size_t length = keys->length < values->length ? keys->length : values->length; \
+        if (length == 0) return res; \
+        /* Spreading the entries evenly keeps every node at least half full */ \
+        size_t count = (length + capacity - 1) / capacity; \
+        struct key_type##_##value_type##_btree_map_node** level = (struct key_type##_##value_type##_btree_map_node**)malloc(sizeof(struct key_type##_##value_type##_btree_map_node*) * count); \
+        key_type* mins = (key_type*)malloc(sizeof(key_type) * count); \
+        if (level == NULL || mins == NULL) { \
+            free(level); \
+            free(mins); \
+            free(res); \
+            return NULL; \
+        } \
+        size_t offset = 0; \
+        struct key_type##_##value_type##_btree_map_leaf* previous = NULL; \
+        for (size_t n = 0; n < count; n++) { \
+            size_t size = length / count + (n < length % count); \
+            struct key_type##_##value_type##_btree_map_leaf* leaf = key_type##_##value_type##_btree_map_leaf_new(); \
+            if (leaf == NULL) { \
+                for (size_t m = 0; m < n; m++) free(level[m]); \
+                free(level); \
+                free(mins); \
+                free(res); \
+                return NULL; \
+            } \
+            memcpy(leaf->node.keys, &keys->data[offset], sizeof(key_type) * size); \
+            memcpy(leaf->values, &values->data[offset], sizeof(value_type) * size); \
+            leaf->node.length = size; \
+            if (previous != NULL) previous->next = leaf; \
+            else res->first = leaf; \
+            previous = leaf; \
+            level[n] = &leaf->node; \
+            mins[n] = keys->data[offset]; \
+            offset += size; \
+        } \
+        while (count > 1) { \
+            size_t parents = (count + capacity) / (capacity + 1); \
+            offset = 0; \
+            for (size_t n = 0; n < parents; n++) { \
+                size_t size = count / parents + (n < count % parents); \
+                struct key_type##_##value_type##_btree_map_inner* inner = key_type##_##value_type##_btree_map_inner_new(); \
+                if (inner == NULL) { \
+                    for (size_t m = 0; m < n; m++) key_type##_##value_type##_btree_map_node_free(level[m]); \
+                    for (size_t m = offset; m < count; m++) key_type##_##value_type##_btree_map_node_free(level[m]); \
+                    free(level); \
+                    free(mins); \
+                    free(res); \
+                    return NULL; \
+                } \
+                memcpy(inner->children, &level[offset], sizeof(struct key_type##_##value_type##_btree_map_node*) * size); \
+                for (size_t m = 1; m < size; m++) inner->node.keys[m - 1] = mins[offset + m]; \
+                inner->node.length = size - 1; \
+                level[n] = &inner->node; \
+                mins[n] = mins[offset]; \
+                offset += size; \
+            } \
+            count = parents; \
+        } \
+        res->root = level[0]; \
+        res->length = length; \
+        free(level); \
+        free(mins); \
+        return res; \
+    }
+
+/** @struct KEY_VALUE_btree_map
+
+    An ordered map from keys of type `KEY` to values of type `VALUE`, implemented as a B+ tree with high fan-out nodes.
+    Insertion, lookup and removal take `O(log n)` time in the worst case.
+**/
+
+/** @typedef KEY_VALUE_btree_map_t
+
+    Resolves to `struct KEY_VALUE_btree_map`; can also be accessed with BTREE_MAP(KEY, VALUE)
+**/
+
+/** @typedef KEY_VALUE_btree_map_iter_t
+
+    Resolves to `struct KEY_VALUE_btree_map_iter`, a position within the map; can also be accessed with BTREE_MAP_ITER(KEY, VALUE).
+    Its `key` and `value` fields point to the current entry, and are NULL once the end of the map is reached.
+    An iterator is invalidated by any insertion into or removal from the map.
+**/
+
+/** @fn KEY_VALUE_btree_map_new()
+    @returns A new, empty map, or NULL on allocation failure
+**/
+
+/** @fn KEY_VALUE_btree_map_free(BTREE_MAP(KEY, VALUE)* map)
+    @param map The map to free
+
+    Frees all of the memory used by `map`.
+**/
+
+/** @fn KEY_VALUE_btree_map_insert(BTREE_MAP(KEY, VALUE)* map, KEY key, VALUE value)
+    @returns true if `key` was added, false if it was already present (in which case its value is replaced) or on allocation failure
+
+    On allocation failure, the map is left unchanged.
+**/
+
+/** @fn KEY_VALUE_btree_map_find(BTREE_MAP(KEY, VALUE)* map, KEY key)
+    @returns A pointer to the value associated with `key`, or NULL if there is none
+**/
+
+/** @fn KEY_VALUE_btree_map_erase(BTREE_MAP(KEY, VALUE)* map, KEY key)
+    @returns true if `key` was found and removed, false otherwise
+
+    Nodes that become less than half full borrow an entry from a sibling or are merged with it.
+**/
+
+/** @fn KEY_VALUE_btree_map_first(BTREE_MAP(KEY, VALUE)* map)
+    @returns An iterator to the smallest key of `map`
+**/
+
+/** @fn KEY_VALUE_btree_map_lower_bound(BTREE_MAP(KEY, VALUE)* map, KEY key)
+    @returns An iterator to the first key that is greater than or equal to `key`
+**/
+
+/** @fn KEY_VALUE_btree_map_iter_next(BTREE_MAP_ITER(KEY, VALUE)* iter)
+
+    Moves `iter` to the next key, in increasing order.
+
+    ## Example
+
+    ```c
+    for (BTREE_MAP_ITER(int, float) iter = int_float_btree_map_first(map); iter.key != NULL; int_float_btree_map_iter_next(&iter)) {
+        printf("%d: %f\n", *iter.key, *iter.value);
+    }
+    ```
+**/
+
+/** @fn KEY_VALUE_btree_map_for_each_range(BTREE_MAP(KEY, VALUE)* map, KEY lo, KEY hi, bool (*callback)(const KEY*, VALUE*, void*), void* callback_data)
+    @param callback Called for each key in `[lo, hi)`, in order; returning false stops the iteration
+    @param callback_data A user-defined pointer passed to `callback`
+    @returns The number of times `callback` was called
+**/
+
+/** @fn KEY_VALUE_btree_map_from_sorted_vecs(const VEC(KEY)* keys, const VEC(VALUE)* values)
+    @param keys The keys, in strictly increasing order
+    @param values The values, `values[n]` being associated with `keys[n]`
+    @returns A new map holding these entries, or NULL on allocation failure
+
+    Builds a map bottom-up in `O(n)`, filling the nodes evenly instead of inserting the entries one by one.
+    If both vectors do not have the same length, the extra elements of the longest one are ignored.
+
+    **Note:** only available if `DECL_BTREE_MAP_VEC(KEY, VALUE)` and `DEF_BTREE_MAP_VEC(KEY, VALUE)` have been called.
+**/
+
+#endif // BTREEMAP_H
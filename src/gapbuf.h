@@ -0,0 +1,261 @@
+#ifndef GAPBUF_H
+#define GAPBUF_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define GAPBUF(type) type##_gapbuf_t
+
+/** @def DECL_GAPBUF(type)
+    @param type The type of the elements of the buffer
+
+    Declares a gap buffer (GAPBUF) type and GAPBUF-associated functions.
+    A gap buffer is an array with a hole (the gap) at the position of its cursor: values are inserted into the gap and removed by widening it,
+    so that edits at the cursor take `O(1)`, and moving the cursor moves the values that lie between its old and new positions.
+**/
+#define DECL_GAPBUF(type) struct type##_gapbuf { \
+        type* data; \
+        size_t capacity; \
+        size_t gap_start; \
+        size_t gap_end; \
+    }; \
+    typedef struct type##_gapbuf GAPBUF(type); \
+    GAPBUF(type)* type##_gapbuf_new(const size_t capacity); \
+    void type##_gapbuf_free(GAPBUF(type)* buffer); \
+    size_t type##_gapbuf_length(const GAPBUF(type)* buffer); \
+    size_t type##_gapbuf_capacity(const GAPBUF(type)* buffer); \
+    size_t type##_gapbuf_resize(GAPBUF(type)* buffer, size_t new_capacity); \
+    size_t type##_gapbuf_cursor(const GAPBUF(type)* buffer); \
+    size_t type##_gapbuf_move_to(GAPBUF(type)* buffer, size_t position); \
+    size_t type##_gapbuf_insert(GAPBUF(type)* buffer, type value); \
+    size_t type##_gapbuf_insert_n(GAPBUF(type)* buffer, const type* values, size_t count); \
+    size_t type##_gapbuf_erase_before(GAPBUF(type)* buffer, size_t count); \
+    size_t type##_gapbuf_erase_after(GAPBUF(type)* buffer, size_t count); \
+    type* type##_gapbuf_get(GAPBUF(type)* buffer, size_t index); \
+    void type##_gapbuf_slices(const GAPBUF(type)* buffer, const type** before, size_t* before_length, const type** after, size_t* after_length); \
+    const type* type##_gapbuf_contiguous(GAPBUF(type)* buffer);
+
+/** @def DEF_GAPBUF(type)
+    @param type The type of the elements of the buffer
+
+    Defines the GAPBUF-associated functions.
+    Requires `DECL_GAPBUF(type)` to have been called beforehand.
+**/
+#define DEF_GAPBUF(type) \
+    GAPBUF(type)* type##_gapbuf_new(const size_t capacity) { \
+        GAPBUF(type)* res = (GAPBUF(type)*)malloc(sizeof(struct type##_gapbuf)); \
+        if (res == NULL) return NULL; \
+        res->data = (type*)malloc(sizeof(type) * capacity); \
+        if (res->data == NULL && capacity > 0) { \
+            free(res); \
+            return NULL; \
+        } \
+        res->capacity = capacity; \
+        res->gap_start = 0; \
+        res->gap_end = capacity; \
+        return res; \
+    } \
+    void type##_gapbuf_free(GAPBUF(type)* buffer) { \
+        if (buffer == NULL) return; \
+        free(buffer->data); \
+        free(buffer); \
+    } \
+    size_t type##_gapbuf_length(const GAPBUF(type)* buffer) { \
+        if (buffer == NULL) return 0; \
+        return buffer->capacity - (buffer->gap_end - buffer->gap_start); \
+    } \
+    size_t type##_gapbuf_capacity(const GAPBUF(type)* buffer) { \
+        if (buffer == NULL) return 0; \
+        return buffer->capacity; \
+    } \
+    size_t type##_gapbuf_resize(GAPBUF(type)* buffer, size_t new_capacity) { \
+        if (buffer == NULL) return 0; \
+        if (new_capacity == 0) return buffer->capacity; \
+        size_t length = type##_gapbuf_length(buffer); \
+        if (new_capacity < length) new_capacity = length; \
+        if (new_capacity == 0) return 0; /* zero reallocation are deprecated as of C11 DR 400 */ \
+        size_t after = buffer->capacity - buffer->gap_end; \
+        if (new_capacity < buffer->capacity) { \
+            /* Shrinking: the values after the gap must be moved before the end of the array is cut */ \
+            memmove(buffer->data + new_capacity - after, buffer->data + buffer->gap_end, sizeof(type) * after); \
+            type* new_data = (type*)realloc((void*)buffer->data, sizeof(type) * new_capacity); \
+            if (new_data != NULL) buffer->data = new_data; \
+        } else { \
+            type* new_data = (type*)realloc((void*)buffer->data, sizeof(type) * new_capacity); \
+            if (new_data == NULL) return 0; \
+            buffer->data = new_data; \
+            memmove(buffer->data + new_capacity - after, buffer->data + buffer->gap_end, sizeof(type) * after); \
+        } \
+        buffer->gap_end = new_capacity - after; \
+        buffer->capacity = new_capacity; \
+        return new_capacity; \
+    } \
+    size_t type##_gapbuf_cursor(const GAPBUF(type)* buffer) { \
+        if (buffer == NULL) return 0; \
+        return buffer->gap_start; \
+    } \
+    size_t type##_gapbuf_move_to(GAPBUF(type)* buffer, size_t position) { \
+        if (buffer == NULL) return 0; \
+        size_t length = type##_gapbuf_length(buffer); \
+        if (position > length) position = length; \
+        if (position < buffer->gap_start) { \
+            size_t count = buffer->gap_start - position; \
+            memmove(buffer->data + buffer->gap_end - count, buffer->data + position, sizeof(type) * count); \
+            buffer->gap_start -= count; \
+            buffer->gap_end -= count; \
+        } else if (position > buffer->gap_start) { \
+            size_t count = position - buffer->gap_start; \
+            memmove(buffer->data + buffer->gap_start, buffer->data + buffer->gap_end, sizeof(type) * count); \
+            buffer->gap_start += count; \
+            buffer->gap_end += count; \
+        } \
+        return position; \
+    } \
+    /* Makes sure that the gap can hold `count` values, doubling the capacity as many times as needed */ \
+    static bool type##_gapbuf_reserve(GAPBUF(type)* buffer, size_t count) { \
+        if (buffer->gap_end - buffer->gap_start >= count) return true; \
+        size_t needed = type##_gapbuf_length(buffer) + count; \
+        size_t capacity = buffer->capacity; \
+        if (capacity == 0) return false; \
+        while (capacity < needed) capacity *= 2; \
+        return type##_gapbuf_resize(buffer, capacity) != 0; \
+    } \
+    size_t type##_gapbuf_insert(GAPBUF(type)* buffer, type value) { \
+        if (buffer == NULL || !type##_gapbuf_reserve(buffer, 1)) return 0; \
+        buffer->data[buffer->gap_start++] = value; \
+        return type##_gapbuf_length(buffer); \
+    } \
+    size_t type##_gapbuf_insert_n(GAPBUF(type)* buffer, const type* values, size_t count) { \
+        if (buffer == NULL || !type##_gapbuf_reserve(buffer, count)) return 0; \
+        if (count > 0) memcpy(buffer->data + buffer->gap_start, values, sizeof(type) * count); \
+        buffer->gap_start += count; \
+        return type##_gapbuf_length(buffer); \
+    } \
+    size_t type##_gapbuf_erase_before(GAPBUF(type)* buffer, size_t count) { \
+        if (buffer == NULL) return 0; \
+        if (count > buffer->gap_start) count = buffer->gap_start; \
+        buffer->gap_start -= count; \
+        return count; \
+    } \
+    size_t type##_gapbuf_erase_after(GAPBUF(type)* buffer, size_t count) { \
+        if (buffer == NULL) return 0; \
+        if (count > buffer->capacity - buffer->gap_end) count = buffer->capacity - buffer->gap_end; \
+        buffer->gap_end += count; \
+        return count; \
+    } \
+    type* type##_gapbuf_get(GAPBUF(type)* buffer, size_t index) { \
+        if (buffer == NULL || index >= type##_gapbuf_length(buffer)) return NULL; \
+        if (index < buffer->gap_start) return &buffer->data[index]; \
+        return &buffer->data[index + buffer->gap_end - buffer->gap_start]; \
+    } \
+    void type##_gapbuf_slices(const GAPBUF(type)* buffer, const type** before, size_t* before_length, const type** after, size_t* after_length) { \
+        if (buffer == NULL) { \
+            *before = *after = NULL; \
+            *before_length = *after_length = 0; \
+            return; \
+        } \
+        *before = buffer->data; \
+        *before_length = buffer->gap_start; \
+        *after = buffer->data + buffer->gap_end; \
+        *after_length = buffer->capacity - buffer->gap_end; \
+    } \
+    const type* type##_gapbuf_contiguous(GAPBUF(type)* buffer) { \
+        if (buffer == NULL) return NULL; \
+        type##_gapbuf_move_to(buffer, type##_gapbuf_length(buffer)); \
+        return buffer->data; \
+    }
+
+/** @struct TYPE_gapbuf
+
+    A scalable array with a gap, of values of type `TYPE`: the values are stored in `data[0 .. gap_start]` and `data[gap_end .. capacity]`,
+    and the cursor, where values are inserted and removed, is at `gap_start`.
+**/
+
+/** @typedef TYPE_gapbuf_t
+
+    Resolves to `struct TYPE_gapbuf`; can also be accessed with `GAPBUF(TYPE)`.
+**/
+
+/** @fn TYPE_gapbuf_new(const size_t capacity)
+    @param capacity The capacity in number of elements
+    @returns A new, empty gap buffer whose cursor is at 0, or NULL on allocation failure
+
+    Like `TYPE_vec_new`, inserting into a buffer of null capacity will not work until it is resized.
+**/
+
+/** @fn TYPE_gapbuf_free(GAPBUF(TYPE)* buffer)
+    @param buffer The gap buffer to free
+**/
+
+/** @fn TYPE_gapbuf_length(const GAPBUF(TYPE)* buffer)
+    @returns The number of values of `buffer`, 0 if NULL
+**/
+
+/** @fn TYPE_gapbuf_capacity(const GAPBUF(TYPE)* buffer)
+    @returns The number of values `buffer` can hold without being resized, 0 if NULL
+**/
+
+/** @fn TYPE_gapbuf_resize(GAPBUF(TYPE)* buffer, size_t new_capacity)
+    @param new_capacity The new capacity. Must be non-null, or else nothing is done.
+    @returns The new capacity, or 0 on allocation failure
+
+    Behaves like `TYPE_vec_resize`: the capacity is never shrunk below the length. The cursor does not move; the gap grows or shrinks.
+**/
+
+/** @fn TYPE_gapbuf_cursor(const GAPBUF(TYPE)* buffer)
+    @returns The position of the cursor, ie. the number of values before it
+**/
+
+/** @fn TYPE_gapbuf_move_to(GAPBUF(TYPE)* buffer, size_t position)
+    @param position The new position of the cursor; it is clamped to the length of `buffer`
+    @returns The new position of the cursor
+
+    Moves the values between the old and the new position of the cursor to the other side of the gap, with a single `memmove`.
+**/
+
+/** @fn TYPE_gapbuf_insert(GAPBUF(TYPE)* buffer, TYPE value)
+    @returns The new length, or 0 if the buffer could not grow
+
+    Inserts `value` at the cursor, which ends up after it. When the gap is full, the capacity is doubled, like with `TYPE_vec_push`.
+**/
+
+/** @fn TYPE_gapbuf_insert_n(GAPBUF(TYPE)* buffer, const TYPE* values, size_t count)
+    @returns The new length, or 0 if the buffer could not grow
+
+    Inserts `count` values at the cursor, which ends up after them; the buffer grows at most once.
+**/
+
+/** @fn TYPE_gapbuf_erase_before(GAPBUF(TYPE)* buffer, size_t count)
+    @returns The number of values removed
+
+    Removes up to `count` values before the cursor, like the backspace key does, in `O(1)`.
+**/
+
+/** @fn TYPE_gapbuf_erase_after(GAPBUF(TYPE)* buffer, size_t count)
+    @returns The number of values removed
+
+    Removes up to `count` values after the cursor, like the delete key does, in `O(1)`.
+**/
+
+/** @fn TYPE_gapbuf_get(GAPBUF(TYPE)* buffer, size_t index)
+    @returns A pointer to the value at `index`, skipping over the gap, or NULL if `index` is out of bounds; it is invalidated by the next edit
+**/
+
+/** @fn TYPE_gapbuf_slices(const GAPBUF(TYPE)* buffer, const TYPE** before, size_t* before_length, const TYPE** after, size_t* after_length)
+    @param before Where to write a pointer to the values before the cursor
+    @param before_length Where to write their number
+    @param after Where to write a pointer to the values after the cursor
+    @param after_length Where to write their number
+
+    Exposes the content of `buffer` as two contiguous arrays, which can be written out with two calls to `fwrite` for instance, without moving anything.
+    If `buffer` is NULL, both pointers are set to NULL and both lengths to 0.
+**/
+
+/** @fn TYPE_gapbuf_contiguous(GAPBUF(TYPE)* buffer)
+    @returns A pointer to all of the values of `buffer`, in order, or NULL if `buffer` is NULL
+
+    Moves the cursor to the end of `buffer`, so that its values are contiguous.
+**/
+
+#endif // GAPBUF_H
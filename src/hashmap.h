@@ -0,0 +1,362 @@
+#ifndef HASHMAP_H
+#define HASHMAP_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define HASHMAP(key_type, value_type) key_type##_##value_type##_hashmap_t
+#define HASHMAP_ENTRY(key_type, value_type) key_type##_##value_type##_hashmap_entry_t
+
+/// The number of control bytes looked at in one probe; a full SSE2 register
+#define HASHMAP_GROUP_WIDTH 16
+
+/// Control byte of a slot that was never used; full slots have the 7 low bits of their hash as control byte, with the top bit cleared
+#define HASHMAP_EMPTY ((int8_t)-128)
+/// Control byte of a slot whose entry was removed, and that probes must skip over
+#define HASHMAP_DELETED ((int8_t)-2)
+
+/// A hash function for integer keys, to be given to `DEF_HASHMAP`; hashes are mixed by the map, so the identity is good enough
+#define HASHMAP_HASH_INT(key) ((uint64_t)(key))
+
+/// A hash function for keys without padding bytes, like structs of integers, to be given to `DEF_HASHMAP`
+#define HASHMAP_HASH_BYTES(key) hashmap_hash_bytes(&(key), sizeof(key))
+
+/// An equality function for keys that can be compared with `==`, to be given to `DEF_HASHMAP`
+#define HASHMAP_EQ(a, b) ((a) == (b))
+
+/// FNV-1a, for `HASHMAP_HASH_BYTES`
+static inline uint64_t hashmap_hash_bytes(const void* key, size_t size) {
+    const uint8_t* bytes = (const uint8_t*)key;
+    uint64_t hash = 0xcbf29ce484222325;
+    for (size_t n = 0; n < size; n++) {
+        hash = (hash ^ bytes[n]) * 0x100000001b3;
+    }
+    return hash;
+}
+
+/// Spreads the entropy of `hash` over all of its bits, so that weak hashes (like the identity) are usable
+static inline uint64_t hashmap_mix(uint64_t hash) {
+    hash ^= hash >> 32;
+    hash *= 0x9e3779b97f4a7c15;
+    return hash ^ (hash >> 29);
+}
+
+static inline unsigned hashmap_trailing_zeros(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctz(mask);
+#else
+    unsigned res = 0;
+    while (!(mask & 1)) {
+        mask >>= 1;
+        res++;
+    }
+    return res;
+#endif
+}
+
+static inline unsigned hashmap_leading_zeros(uint32_t mask) {
+    unsigned res = 0;
+    for (uint32_t bit = (uint32_t)1 << (HASHMAP_GROUP_WIDTH - 1); bit != 0 && !(mask & bit); bit >>= 1) res++;
+    return res;
+}
+
+/* Each of the following returns a bitmask of the slots of the group starting at `ctrl` that satisfy a condition */
+#if defined(__SSE2__)
+static inline uint32_t hashmap_group_match(const int8_t* ctrl, int8_t h2) {
+    __m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(h2)));
+}
+
+static inline uint32_t hashmap_group_match_empty(const int8_t* ctrl) {
+    __m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(HASHMAP_EMPTY)));
+}
+
+/* Empty and deleted slots are exactly the ones whose control byte has its top bit set */
+static inline uint32_t hashmap_group_match_free(const int8_t* ctrl) {
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)ctrl));
+}
+#else
+static inline uint32_t hashmap_group_match(const int8_t* ctrl, int8_t h2) {
+    uint32_t res = 0;
+    for (unsigned n = 0; n < HASHMAP_GROUP_WIDTH; n++) res |= (uint32_t)(ctrl[n] == h2) << n;
+    return res;
+}
+
+static inline uint32_t hashmap_group_match_empty(const int8_t* ctrl) {
+    return hashmap_group_match(ctrl, HASHMAP_EMPTY);
+}
+
+static inline uint32_t hashmap_group_match_free(const int8_t* ctrl) {
+    uint32_t res = 0;
+    for (unsigned n = 0; n < HASHMAP_GROUP_WIDTH; n++) res |= (uint32_t)(ctrl[n] < 0) << n;
+    return res;
+}
+#endif
+
+/** @def DECL_HASHMAP(key_type, value_type)
+    @param key_type The type of the keys
+    @param value_type The type of the values
+
+    Declares a hash map (HASHMAP) from `key_type` to `value_type`, and the HASHMAP-associated functions.
+
+    The map uses open addressing, in the manner of Abseil's "Swiss tables": next to the array of entries lies an array of control bytes, one per slot,
+    which hold 7 bits of the hash of full slots. Lookups compare a whole group of 16 control bytes at once (with SSE2 when it is available),
+    and only look at the entries whose control byte matches.
+**/
+#define DECL_HASHMAP(key_type, value_type) struct key_type##_##value_type##_hashmap_entry { \
+        key_type key; \
+        value_type value; \
+    }; \
+    typedef struct key_type##_##value_type##_hashmap_entry HASHMAP_ENTRY(key_type, value_type); \
+    struct key_type##_##value_type##_hashmap { \
+        int8_t* ctrl; \
+        HASHMAP_ENTRY(key_type, value_type)* entries; \
+        size_t capacity; \
+        size_t length; \
+        size_t growth_left; \
+    }; \
+    typedef struct key_type##_##value_type##_hashmap HASHMAP(key_type, value_type); \
+    HASHMAP(key_type, value_type)* key_type##_##value_type##_hashmap_new(void); \
+    void key_type##_##value_type##_hashmap_free(HASHMAP(key_type, value_type)* map); \
+    size_t key_type##_##value_type##_hashmap_length(const HASHMAP(key_type, value_type)* map); \
+    size_t key_type##_##value_type##_hashmap_capacity(const HASHMAP(key_type, value_type)* map); \
+    bool key_type##_##value_type##_hashmap_reserve(HASHMAP(key_type, value_type)* map, size_t length); \
+    bool key_type##_##value_type##_hashmap_insert(HASHMAP(key_type, value_type)* map, key_type key, value_type value); \
+    value_type* key_type##_##value_type##_hashmap_find(HASHMAP(key_type, value_type)* map, key_type key); \
+    bool key_type##_##value_type##_hashmap_erase(HASHMAP(key_type, value_type)* map, key_type key); \
+    void key_type##_##value_type##_hashmap_clear(HASHMAP(key_type, value_type)* map); \
+    size_t key_type##_##value_type##_hashmap_for_each(HASHMAP(key_type, value_type)* map, bool (*callback)(const key_type*, value_type*, void*), void* callback_data);
+
+/** @def DEF_HASHMAP(key_type, value_type, hash, eq)
+    @param key_type The type of the keys
+    @param value_type The type of the values
+    @param hash A function or macro taking a key and returning its hash as an unsigned integer, like `HASHMAP_HASH_INT` or `HASHMAP_HASH_BYTES`
+    @param eq A function or macro taking two keys and returning whether they are equal, like `HASHMAP_EQ`
+
+    Defines the functions associated with `HASHMAP(key_type, value_type)`.
+    Requires `DECL_HASHMAP(key_type, value_type)` to have been called beforehand.
+**/
+#define DEF_HASHMAP(key_type, value_type, hash, eq) \
+    /* Writes a control byte, and its copy after the end of the array, which lets groups that start near the end be loaded in one go */ \
+    static inline void key_type##_##value_type##_hashmap_set_ctrl(HASHMAP(key_type, value_type)* map, size_t index, int8_t ctrl) { \
+        map->ctrl[index] = ctrl; \
+        if (index < HASHMAP_GROUP_WIDTH) map->ctrl[map->capacity + index] = ctrl; \
+    } \
+    /* Finds the first empty or deleted slot on the probe sequence of `mixed` */ \
+    static size_t key_type##_##value_type##_hashmap_find_free(const HASHMAP(key_type, value_type)* map, uint64_t mixed) { \
+        size_t mask = map->capacity - 1; \
+        size_t position = (size_t)(mixed >> 7) & mask; \
+        for (size_t step = HASHMAP_GROUP_WIDTH;; step += HASHMAP_GROUP_WIDTH) { \
+            uint32_t free_slots = hashmap_group_match_free(map->ctrl + position); \
+            if (free_slots) return (position + hashmap_trailing_zeros(free_slots)) & mask; \
+            position = (position + step) & mask; \
+        } \
+    } \
+    /* Moves every entry into new arrays of `capacity` slots, which also drops the tombstones */ \
+    static bool key_type##_##value_type##_hashmap_rehash(HASHMAP(key_type, value_type)* map, size_t capacity) { \
+        HASHMAP(key_type, value_type) res = {NULL, NULL, capacity, map->length, capacity - capacity / 8 - map->length}; \
+        res.ctrl = (int8_t*)malloc(capacity + HASHMAP_GROUP_WIDTH); \
+        res.entries = (HASHMAP_ENTRY(key_type, value_type)*)malloc(sizeof(HASHMAP_ENTRY(key_type, value_type)) * capacity); \
+        if (res.ctrl == NULL || res.entries == NULL) { \
+            free(res.ctrl); \
+            free(res.entries); \
+            return false; \
+        } \
+        memset(res.ctrl, (uint8_t)HASHMAP_EMPTY, capacity + HASHMAP_GROUP_WIDTH); \
+        for (size_t n = 0; n < map->capacity; n++) { \
+            if (map->ctrl[n] < 0) continue; \
+            uint64_t mixed = hashmap_mix((uint64_t)(hash(map->entries[n].key))); \
+            size_t index = key_type##_##value_type##_hashmap_find_free(&res, mixed); \
+            key_type##_##value_type##_hashmap_set_ctrl(&res, index, (int8_t)(mixed & 0x7f)); \
+            res.entries[index] = map->entries[n]; \
+        } \
+        free(map->ctrl); \
+        free(map->entries); \
+        *map = res; \
+        return true; \
+    } \
+    HASHMAP(key_type, value_type)* key_type##_##value_type##_hashmap_new(void) { \
+        HASHMAP(key_type, value_type)* res = (HASHMAP(key_type, value_type)*)malloc(sizeof(struct key_type##_##value_type##_hashmap)); \
+        if (res == NULL) return NULL; \
+        res->ctrl = NULL; \
+        res->entries = NULL; \
+        res->capacity = 0; \
+        res->length = 0; \
+        if (!key_type##_##value_type##_hashmap_rehash(res, HASHMAP_GROUP_WIDTH)) { \
+            free(res); \
+            return NULL; \
+        } \
+        return res; \
+    } \
+    void key_type##_##value_type##_hashmap_free(HASHMAP(key_type, value_type)* map) { \
+        if (map == NULL) return; \
+        free(map->ctrl); \
+        free(map->entries); \
+        free(map); \
+    } \
+    size_t key_type##_##value_type##_hashmap_length(const HASHMAP(key_type, value_type)* map) { \
+        if (map == NULL) return 0; \
+        return map->length; \
+    } \
+    size_t key_type##_##value_type##_hashmap_capacity(const HASHMAP(key_type, value_type)* map) { \
+        if (map == NULL) return 0; \
+        return map->capacity; \
+    } \
+    bool key_type##_##value_type##_hashmap_reserve(HASHMAP(key_type, value_type)* map, size_t length) { \
+        if (map == NULL) return false; \
+        size_t capacity = map->capacity; \
+        while (capacity - capacity / 8 < length) { \
+            if (capacity > SIZE_MAX / 2 / sizeof(HASHMAP_ENTRY(key_type, value_type))) return false; \
+            capacity *= 2; \
+        } \
+        if (capacity == map->capacity) return true; \
+        return key_type##_##value_type##_hashmap_rehash(map, capacity); \
+    } \
+    /* Returns the slot holding `key`, whose mixed hash is `mixed`, or SIZE_MAX if there is none */ \
+    static size_t key_type##_##value_type##_hashmap_find_index(const HASHMAP(key_type, value_type)* map, key_type key, uint64_t mixed) { \
+        int8_t h2 = (int8_t)(mixed & 0x7f); \
+        size_t mask = map->capacity - 1; \
+        size_t position = (size_t)(mixed >> 7) & mask; \
+        for (size_t step = HASHMAP_GROUP_WIDTH;; step += HASHMAP_GROUP_WIDTH) { \
+            for (uint32_t match = hashmap_group_match(map->ctrl + position, h2); match; match &= match - 1) { \
+                size_t index = (position + hashmap_trailing_zeros(match)) & mask; \
+                if (eq(map->entries[index].key, key)) return index; \
+            } \
+            /* The key would have been put in this empty slot, had it been inserted */ \
+            if (hashmap_group_match_empty(map->ctrl + position)) return SIZE_MAX; \
+            position = (position + step) & mask; \
+        } \
+    } \
+    value_type* key_type##_##value_type##_hashmap_find(HASHMAP(key_type, value_type)* map, key_type key) { \
+        if (map == NULL) return NULL; \
+        size_t index = key_type##_##value_type##_hashmap_find_index(map, key, hashmap_mix((uint64_t)(hash(key)))); \
+        return index == SIZE_MAX ? NULL : &map->entries[index].value; \
+    } \
+    bool key_type##_##value_type##_hashmap_insert(HASHMAP(key_type, value_type)* map, key_type key, value_type value) { \
+        if (map == NULL) return false; \
+        uint64_t mixed = hashmap_mix((uint64_t)(hash(key))); \
+        size_t index = key_type##_##value_type##_hashmap_find_index(map, key, mixed); \
+        if (index != SIZE_MAX) { \
+            map->entries[index].value = value; \
+            return false; \
+        } \
+        index = key_type##_##value_type##_hashmap_find_free(map, mixed); \
+        if (map->growth_left == 0 && map->ctrl[index] == HASHMAP_EMPTY) { \
+            /* Full of entries and tombstones: drop the tombstones if they take a lot of room, grow otherwise */ \
+            size_t capacity = map->length < map->capacity * 7 / 16 ? map->capacity : map->capacity * 2; \
+            if (!key_type##_##value_type##_hashmap_rehash(map, capacity)) return false; \
+            index = key_type##_##value_type##_hashmap_find_free(map, mixed); \
+        } \
+        map->growth_left -= map->ctrl[index] == HASHMAP_EMPTY; \
+        key_type##_##value_type##_hashmap_set_ctrl(map, index, (int8_t)(mixed & 0x7f)); \
+        map->entries[index].key = key; \
+        map->entries[index].value = value; \
+        map->length++; \
+        return true; \
+    } \
+    bool key_type##_##value_type##_hashmap_erase(HASHMAP(key_type, value_type)* map, key_type key) { \
+        if (map == NULL) return false; \
+        size_t index = key_type##_##value_type##_hashmap_find_index(map, key, hashmap_mix((uint64_t)(hash(key)))); \
+        if (index == SIZE_MAX) return false; \
+        /* If no group containing this slot was ever full, no probe went past it, and it can go back to being empty */ \
+        size_t mask = map->capacity - 1; \
+        uint32_t empty_before = hashmap_group_match_empty(map->ctrl + ((index - HASHMAP_GROUP_WIDTH) & mask)); \
+        uint32_t empty_after = hashmap_group_match_empty(map->ctrl + index); \
+        bool never_full = empty_before && empty_after && hashmap_trailing_zeros(empty_after) + hashmap_leading_zeros(empty_before) < HASHMAP_GROUP_WIDTH; \
+        key_type##_##value_type##_hashmap_set_ctrl(map, index, never_full ? HASHMAP_EMPTY : HASHMAP_DELETED); \
+        map->growth_left += never_full; \
+        map->length--; \
+        return true; \
+    } \
+    void key_type##_##value_type##_hashmap_clear(HASHMAP(key_type, value_type)* map) { \
+        if (map == NULL) return; \
+        memset(map->ctrl, (uint8_t)HASHMAP_EMPTY, map->capacity + HASHMAP_GROUP_WIDTH); \
+        map->length = 0; \
+        map->growth_left = map->capacity - map->capacity / 8; \
+    } \
+    size_t key_type##_##value_type##_hashmap_for_each(HASHMAP(key_type, value_type)* map, bool (*callback)(const key_type*, value_type*, void*), void* callback_data) { \
+        if (map == NULL) return 0; \
+        size_t res = 0; \
+        for (size_t position = 0; position < map->capacity; position += HASHMAP_GROUP_WIDTH) { \
+            uint32_t full = ~hashmap_group_match_free(map->ctrl + position) & (((uint32_t)1 << HASHMAP_GROUP_WIDTH) - 1); \
+            for (; full; full &= full - 1) { \
+                HASHMAP_ENTRY(key_type, value_type)* entry = &map->entries[position + hashmap_trailing_zeros(full)]; \
+                res++; \
+                if (!callback(&entry->key, &entry->value, callback_data)) return res; \
+            } \
+        } \
+        return res; \
+    }
+
+/** @struct KEY_VALUE_hashmap
+
+    An unordered map from keys of type `KEY` to values of type `VALUE`.
+    Its capacity is a power of two, and at most 7/8 of its slots are used; insertion, lookup and removal take `O(1)` expected time.
+**/
+
+/** @typedef KEY_VALUE_hashmap_t
+
+    Resolves to `struct KEY_VALUE_hashmap`; can also be accessed with `HASHMAP(KEY, VALUE)`.
+**/
+
+/** @fn KEY_VALUE_hashmap_new()
+    @returns A new, empty hash map, or NULL on allocation failure
+**/
+
+/** @fn KEY_VALUE_hashmap_free(HASHMAP(KEY, VALUE)* map)
+    @param map The hash map to free
+**/
+
+/** @fn KEY_VALUE_hashmap_length(const HASHMAP(KEY, VALUE)* map)
+    @returns The number of entries in `map`
+**/
+
+/** @fn KEY_VALUE_hashmap_capacity(const HASHMAP(KEY, VALUE)* map)
+    @returns The number of slots of `map`
+**/
+
+/** @fn KEY_VALUE_hashmap_reserve(HASHMAP(KEY, VALUE)* map, size_t length)
+    @param map The hash map to grow
+    @param length The number of entries to make room for
+    @returns false on allocation failure, true otherwise
+
+    Grows `map` so that it can hold `length` entries without rehashing; this avoids the successive rehashes of a map that is filled one entry at a time.
+**/
+
+/** @fn KEY_VALUE_hashmap_insert(HASHMAP(KEY, VALUE)* map, KEY key, VALUE value)
+    @returns true if `key` was added, false if it was already present (in which case its value is replaced) or on allocation failure
+
+    May rehash the map, which invalidates the pointers returned by `KEY_VALUE_hashmap_find`.
+**/
+
+/** @fn KEY_VALUE_hashmap_find(HASHMAP(KEY, VALUE)* map, KEY key)
+    @returns A pointer to the value associated with `key`, or NULL if there is none
+**/
+
+/** @fn KEY_VALUE_hashmap_erase(HASHMAP(KEY, VALUE)* map, KEY key)
+    @returns true if `key` was found and removed, false otherwise
+
+    The slot is marked as deleted only if a probe may have gone past it; otherwise it becomes empty again, so that maps with many removals do not fill up with tombstones.
+**/
+
+/** @fn KEY_VALUE_hashmap_clear(HASHMAP(KEY, VALUE)* map)
+    @param map The hash map to empty
+
+    Removes every entry of `map`, keeping its capacity.
+**/
+
+/** @fn KEY_VALUE_hashmap_for_each(HASHMAP(KEY, VALUE)* map, bool (*callback)(const KEY*, VALUE*, void*), void* callback_data)
+    @param callback Called on each entry, in no particular order; returning false stops the iteration
+    @param callback_data A user-defined void pointer passed to `callback`
+    @returns The number of times `callback` was called
+
+    The map must not be modified by `callback`.
+**/
+
+#endif // HASHMAP_H
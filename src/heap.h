@@ -0,0 +1,158 @@
+#ifndef HEAP_H
+#define HEAP_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "vec.h"
+
+/// The number of children of each node of the heaps, when unsure; a node's children then span a single cache line for types of up to 16 bytes
+#define HEAP_DEFAULT_ARITY 4
+
+/** @def DECL_HEAP(type)
+    @param type The type of the values of the heap
+
+    Declares the functions that use a `VEC(type)` as a priority queue, in the form of an implicit d-ary heap.
+    This macro requires `DECL_VEC(type)` to have been called beforehand.
+**/
+#define DECL_HEAP(type) \
+    size_t type##_heap_push(VEC(type)* heap, type value); \
+    size_t type##_heap_push_n(VEC(type)* heap, const type* values, size_t count); \
+    bool type##_heap_pop(VEC(type)* heap, type* out); \
+    type* type##_heap_peek(VEC(type)* heap); \
+    bool type##_heap_replace_top(VEC(type)* heap, type value, type* out); \
+    void type##_heap_heapify(VEC(type)* heap);
+
+/** @def DEF_HEAP(type, cmp, D)
+    @param type The type of the values of the heap
+    @param cmp A function or macro taking two values `a` and `b` and returning a negative value if `a < b`, a positive value if `a > b` and 0 if they are equal
+    @param D The number of children of each node, like `HEAP_DEFAULT_ARITY`; must be at least 2
+
+    Defines the functions declared by `DECL_HEAP(type)`; the top of the heaps is their smallest value according to `cmp`.
+    Requires `DECL_VEC(type)`, `DEF_VEC(type)` and `DECL_HEAP(type)` to have been called beforehand.
+
+    A greater `D` makes the heap shallower, so that pushes compare fewer values, while pops compare more values per level, which lie next to each other in memory.
+**/
+#define DEF_HEAP(type, cmp, D) \
+    /* Moves the value at `index` up until its parent is not greater; values are shifted into the hole rather than swapped */ \
+    static void type##_heap_sift_up(type* data, size_t index) { \
+        type value = data[index]; \
+        while (index > 0) { \
+            size_t parent = (index - 1) / (D); \
+            if (cmp(data[parent], value) <= 0) break; \
+            data[index] = data[parent]; \
+            index = parent; \
+        } \
+        data[index] = value; \
+    } \
+    /* Moves `value`, which goes at `index`, down until none of its children are smaller */ \
+    static void type##_heap_sift_down(type* data, size_t length, size_t index, type value) { \
+        while (true) { \
+            size_t first = index * (D) + 1; \
+            if (first >= length) break; \
+            size_t last = first + (D) < length ? first + (D) : length; \
+            size_t smallest = first; \
+            for (size_t child = first + 1; child < last; child++) { \
+                if (cmp(data[child], data[smallest]) < 0) smallest = child; \
+            } \
+            if (cmp(value, data[smallest]) <= 0) break; \
+            data[index] = data[smallest]; \
+            index = smallest; \
+        } \
+        data[index] = value; \
+    } \
+    size_t type##_heap_push(VEC(type)* heap, type value) { \
+        if (type##_vec_push(heap, value) == 0) return 0; \
+        type##_heap_sift_up(heap->data, heap->length - 1); \
+        return heap->length; \
+    } \
+    size_t type##_heap_push_n(VEC(type)* heap, const type* values, size_t count) { \
+        if (heap == NULL) return 0; \
+        if (count > SIZE_MAX / sizeof(type) - heap->length) return 0; \
+        if (heap->length + count > heap->capacity) { \
+            /* Grows geometrically, like TYPE_vec_push, so that a series of small batches stays amortized O(1) per value */ \
+            size_t capacity = heap->capacity <= SIZE_MAX / sizeof(type) / 2 ? heap->capacity * 2 : SIZE_MAX / sizeof(type); \
+            if (capacity < heap->length + count) capacity = heap->length + count; \
+            if (type##_vec_resize(heap, capacity) == 0) return 0; \
+        } \
+        size_t length = heap->length; \
+        for (size_t n = 0; n < count; n++) heap->data[length + n] = values[n]; \
+        heap->length += count; \
+        /* Rebuilding the whole heap costs O(n + k), sifting each value up O(k log n): pick the cheapest */ \
+        if (count > length / 2) { \
+            type##_heap_heapify(heap); \
+        } else { \
+            for (size_t n = length; n < heap->length; n++) type##_heap_sift_up(heap->data, n); \
+        } \
+        return heap->length; \
+    } \
+    bool type##_heap_pop(VEC(type)* heap, type* out) { \
+        if (heap == NULL || heap->length == 0) return false; \
+        if (out != NULL) *out = heap->data[0]; \
+        heap->length--; \
+        if (heap->length > 0) type##_heap_sift_down(heap->data, heap->length, 0, heap->data[heap->length]); \
+        return true; \
+    } \
+    type* type##_heap_peek(VEC(type)* heap) { \
+        if (heap == NULL || heap->length == 0) return NULL; \
+        return &heap->data[0]; \
+    } \
+    bool type##_heap_replace_top(VEC(type)* heap, type value, type* out) { \
+        if (heap == NULL || heap->length == 0) return false; \
+        if (out != NULL) *out = heap->data[0]; \
+        type##_heap_sift_down(heap->data, heap->length, 0, value); \
+        return true; \
+    } \
+    void type##_heap_heapify(VEC(type)* heap) { \
+        if (heap == NULL || heap->length < 2) return; \
+        /* Sift down every node that has children, starting from the last one */ \
+        for (size_t n = (heap->length - 2) / (D) + 1; n-- > 0;) { \
+            type##_heap_sift_down(heap->data, heap->length, n, heap->data[n]); \
+        } \
+    }
+
+/** @fn TYPE_heap_push(VEC(TYPE)* heap, TYPE value)
+    @param heap The heap to push the value to
+    @param value The value to push
+    @returns The new length, or 0 if the vector could not grow (see `TYPE_vec_push`)
+
+    Inserts `value` in `O(log n)`.
+**/
+
+/** @fn TYPE_heap_push_n(VEC(TYPE)* heap, const TYPE* values, size_t count)
+    @param heap The heap to push the values to
+    @param values The values to push
+    @param count The number of values in `values`
+    @returns The new length, or 0 if the vector could not grow
+
+    Inserts `count` values at once; the vector grows at most once, at least doubling its capacity, and the heap is rebuilt from scratch when this is cheaper than inserting the values one by one.
+**/
+
+/** @fn TYPE_heap_pop(VEC(TYPE)* heap, TYPE* out)
+    @param heap The heap to pop the top value from
+    @param out Where to write the popped value; may be NULL
+    @returns false if the heap is empty, true otherwise
+
+    Removes the smallest value of `heap` in `O(D log n)`.
+**/
+
+/** @fn TYPE_heap_peek(VEC(TYPE)* heap)
+    @returns A pointer to the smallest value of `heap`, or NULL if it is empty; it must not be modified in a way that changes its order
+**/
+
+/** @fn TYPE_heap_replace_top(VEC(TYPE)* heap, TYPE value, TYPE* out)
+    @param heap The heap whose top value is to be replaced
+    @param value The value to insert
+    @param out Where to write the previous top value; may be NULL
+    @returns false if the heap is empty, in which case `value` is not inserted, true otherwise
+
+    Equivalent to a pop followed by a push, with a single pass down the heap; this is the usual operation of timer queues, which reschedule the event they just fired.
+**/
+
+/** @fn TYPE_heap_heapify(VEC(TYPE)* heap)
+    @param heap A vector holding values in any order
+
+    Reorders the values of `heap` into a heap in `O(n)`.
+**/
+
+#endif // HEAP_H
@@ -62,3 +62,16 @@ size_t void_ll_ptr_length(LL_PTR(void)* list) {
     }
     return res;
 }
+
+void* void_ll_ptr_find(LL_PTR(void)* list, bool (*predicate)(const void*, const void*), const void* predicate_data) {
+    while (list != NULL) {
+        LL_PTR(void)* next = list->next;
+        if (next != NULL) {
+            LL_PREFETCH(next->next);
+            LL_PREFETCH(next->value);
+        }
+        if (predicate(list->value, predicate_data)) return list->value;
+        list = next;
+    }
+    return NULL;
+}
@@ -8,6 +8,15 @@
 #define LL(type) type##_ll_t
 #define LL_PTR(type) type##_ll_ptr_t
 
+#if defined(__GNUC__) || defined(__clang__)
+#define LL_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define LL_PREFETCH(address) ((void)(address))
+#endif
+
+/// The number of lists that `TYPE_ll_for_each_multi` walks through simultaneously
+#define LL_MULTI_WIDTH 16
+
 /** @def DECL_LL(type)
     @param type The type of linked list
 
@@ -28,7 +37,14 @@
     bool type##_ll_is_empty(LL(type)* list); \
     LL(type)* type##_ll_push_tail(LL(type)* list, type element); \
     LL(type)* type##_ll_push_head(LL(type)* list, type element); \
+    LL(type)* type##_ll_pop_tail(LL(type)* list); \
+    LL(type)* type##_ll_pop_head(LL(type)* list); \
     LL(type)* type##_ll_concat(LL(type)* list_a, LL(type)* list_b); \
+    LL(type)* type##_ll_merge(LL(type)* list_a, LL(type)* list_b, int (*cmp)(const type*, const type*)); \
+    LL(type)* type##_ll_sort(LL(type)* list, int (*cmp)(const type*, const type*)); \
+    LL(type)* type##_ll_find(LL(type)* list, bool (*predicate)(const type*, const void*), const void* predicate_data); \
+    void type##_ll_for_each(LL(type)* list, void (*callback)(type*, void*), void* callback_data); \
+    void type##_ll_for_each_multi(LL(type)** lists, size_t count, void (*callback)(type*, void*), void* callback_data); \
     void type##_ll_printf(LL(type)* list); /* Note: only available if DEF_LL_PRINTF* has been called */ \
     void type##_ll_free(LL(type)* list); \
     LL(type)* type##_ll_clone(LL(type)* list);
@@ -119,7 +135,9 @@
     } \
     LL(type)* type##_ll_pop_head(LL(type)* list) { \
         if (list == NULL) return NULL; \
-        return list->next; \
+        LL(type)* res = list->next; \
+        free(list); \
+        return res; \
     } \
     void type##_ll_free(LL(type)* list) { \
         if (list == NULL) return; \
@@ -140,6 +158,102 @@
     LL(type)* type##_ll_clone(LL(type)* list) { \
         if (list == NULL) return NULL; \
         return type##_ll_push_head(type##_ll_clone(list->next), list->value); \
+    } \
+    LL(type)* type##_ll_merge(LL(type)* list_a, LL(type)* list_b, int (*cmp)(const type*, const type*)) { \
+        LL(type)* res = NULL; \
+        LL(type)** tail = &res; \
+        while (list_a != NULL && list_b != NULL) { \
+            if (cmp(&list_b->value, &list_a->value) < 0) { \
+                *tail = list_b; \
+                list_b = list_b->next; \
+            } else { \
+                *tail = list_a; \
+                list_a = list_a->next; \
+            } \
+            tail = &(*tail)->next; \
+        } \
+        *tail = list_a != NULL ? list_a : list_b; \
+        return res; \
+    } \
+    LL(type)* type##_ll_sort(LL(type)* list, int (*cmp)(const type*, const type*)) { \
+        /* pending[n] holds the merge of 2^n runs, like the digits of a binary counter */ \
+        LL(type)* pending[sizeof(size_t) * 8] = {NULL}; \
+        const size_t max_pending = sizeof(size_t) * 8; \
+        while (list != NULL) { \
+            LL(type)* run = list; \
+            list = list->next; \
+            if (list != NULL && cmp(&list->value, &run->value) < 0) { \
+                /* Strictly descending run: reverse it while detaching it */ \
+                run->next = NULL; \
+                while (list != NULL && cmp(&list->value, &run->value) < 0) { \
+                    LL(type)* next = list->next; \
+                    list->next = run; \
+                    run = list; \
+                    list = next; \
+                } \
+            } else { \
+                LL(type)* last = run; \
+                while (list != NULL && cmp(&list->value, &last->value) >= 0) { \
+                    last = list; \
+                    list = list->next; \
+                } \
+                last->next = NULL; \
+            } \
+            size_t n = 0; \
+            while (n < max_pending - 1 && pending[n] != NULL) { \
+                run = type##_ll_merge(pending[n], run, cmp); \
+                pending[n] = NULL; \
+                n++; \
+            } \
+            if (pending[n] != NULL) run = type##_ll_merge(pending[n], run, cmp); \
+            pending[n] = run; \
+        } \
+        LL(type)* res = NULL; \
+        for (size_t n = 0; n < max_pending; n++) { \
+            if (pending[n] != NULL) res = type##_ll_merge(pending[n], res, cmp); \
+        } \
+        return res; \
+    } \
+    LL(type)* type##_ll_find(LL(type)* list, bool (*predicate)(const type*, const void*), const void* predicate_data) { \
+        while (list != NULL) { \
+            LL(type)* next = list->next; \
+            if (next != NULL) LL_PREFETCH(next->next); \
+            if (predicate(&list->value, predicate_data)) return list; \
+            list = next; \
+        } \
+        return NULL; \
+    } \
+    void type##_ll_for_each(LL(type)* list, void (*callback)(type*, void*), void* callback_data) { \
+        while (list != NULL) { \
+            LL(type)* next = list->next; \
+            if (next != NULL) LL_PREFETCH(next->next); \
+            callback(&list->value, callback_data); \
+            list = next; \
+        } \
+    } \
+    void type##_ll_for_each_multi(LL(type)** lists, size_t count, void (*callback)(type*, void*), void* callback_data) { \
+        LL(type)* cursors[LL_MULTI_WIDTH]; \
+        for (size_t start = 0; start < count; start += LL_MULTI_WIDTH) { \
+            size_t width = count - start < LL_MULTI_WIDTH ? count - start : LL_MULTI_WIDTH; \
+            size_t active = 0; \
+            for (size_t n = 0; n < width; n++) { \
+                if (lists[start + n] != NULL) cursors[active++] = lists[start + n]; \
+            } \
+            /* Advance every chain by one node per round, so that their cache misses overlap */ \
+            while (active > 0) { \
+                for (size_t n = 0; n < active;) { \
+                    LL(type)* node = cursors[n]; \
+                    LL(type)* next = node->next; \
+                    if (next != NULL) LL_PREFETCH(next); \
+                    callback(&node->value, callback_data); \
+                    if (next != NULL) { \
+                        cursors[n++] = next; \
+                    } else { \
+                        cursors[n] = cursors[--active]; \
+                    } \
+                } \
+            } \
+        } \
     }
 
 /**
@@ -208,6 +322,64 @@
 #define DEF_LL_PRINTF(type, printf_format) \
     DEF_LL_PRINTF_CUSTOM(type, printf(printf_format, value))
 
+/** @fn TYPE_ll_merge(LL(TYPE)* list_a, LL(TYPE)* list_b, int (*cmp)(const TYPE*, const TYPE*))
+    @param list_a A list sorted according to `cmp`
+    @param list_b Another list sorted according to `cmp`
+    @param cmp A comparison function, returning a negative value if its first argument comes first, a positive value if it comes last and 0 if both are equal
+    @returns The merged, sorted list
+
+    Merges two sorted lists into one by relinking their nodes; no allocation is made and both lists are consumed.
+    The merge is stable: on ties, the elements of `list_a` come first.
+**/
+
+/** @fn TYPE_ll_sort(LL(TYPE)* list, int (*cmp)(const TYPE*, const TYPE*))
+    @param list The list to sort; its nodes are reused
+    @param cmp A comparison function, see `TYPE_ll_merge`
+    @returns The sorted list
+
+    Sorts a list in place with a bottom-up natural merge sort: the list is cut into its already-sorted runs (descending runs are reversed), which are then merged pairwise.
+    No allocation is made and the sort is stable.
+    Time complexity is `O(n log r)` for `r` runs, which is `O(n)` on sorted or reverse-sorted lists and `O(n log n)` in the worst case.
+
+    ## Example
+
+    ```c
+    int int_cmp(const int* a, const int* b) {
+        return (*a > *b) - (*a < *b);
+    }
+
+    list = int_ll_sort(list, int_cmp);
+    ```
+**/
+
+/** @fn TYPE_ll_find(LL(TYPE)* list, bool (*predicate)(const TYPE*, const void*), const void* predicate_data)
+    @param list The list to search through
+    @param predicate The predicate; a function that takes as input a pointer to a value of `list` and a user-defined void pointer
+    @param predicate_data A user-defined void pointer to data that the predicate can use
+    @returns The first node for which `predicate` yields true, or NULL
+
+    While the predicate runs on a node, the node after the next one is prefetched, so that the walk does not stall on every cache miss.
+**/
+
+/** @fn TYPE_ll_for_each(LL(TYPE)* list, void (*callback)(TYPE*, void*), void* callback_data)
+    @param list The list to walk through
+    @param callback Called on each value of `list`, in order
+    @param callback_data A user-defined void pointer passed to `callback`
+
+    Calls `callback` on every value of `list`, prefetching ahead like `TYPE_ll_find`.
+**/
+
+/** @fn TYPE_ll_for_each_multi(LL(TYPE)** lists, size_t count, void (*callback)(TYPE*, void*), void* callback_data)
+    @param lists An array of `count` lists; NULL entries are skipped
+    @param count The number of lists
+    @param callback Called on each value of each list
+    @param callback_data A user-defined void pointer passed to `callback`
+
+    Walks through up to `LL_MULTI_WIDTH` independent lists at once, advancing each of them by one node in turn.
+    The cache misses of the different chains then overlap instead of being paid one after the other.
+    The values of a single list are visited in order, but the values of different lists are interleaved.
+**/
+
 DECL_LL_PTR(void)
 
 LL_PTR(void)* void_ll_ptr_new(void* element);
@@ -268,4 +440,32 @@ void* void_ll_ptr_get(LL_PTR(void)* list, size_t index);
 size_t void_ll_ptr_length(LL_PTR(void)* list);
 #define LL_PTR_LENGTH(type, list) void_ll_ptr_length((LL_PTR(void)*)(list))
 
+/** @fn void_ll_ptr_find(LL_PTR(void)* list, bool (*predicate)(const void*, const void*), const void* predicate_data)
+    @returns The first element for which `predicate(element, predicate_data)` yields true, or NULL
+
+    While the predicate runs on an element, the next element and the node after the next one are prefetched.
+**/
+void* void_ll_ptr_find(LL_PTR(void)* list, bool (*predicate)(const void*, const void*), const void* predicate_data);
+#define LL_PTR_FIND(type, list, predicate, predicate_data) (type*)void_ll_ptr_find((LL_PTR(void)*)(list), (predicate), (predicate_data))
+
+/** @def LL_PTR_FOR_EACH(type, list, callback)
+
+    Executes `callback` for every element of `list`; the current element can be accessed through the symbol `element`.
+    The other locals of the macro have reserved-looking names, so that `list` and `callback` may use any name of the caller.
+    The next element and the node after the next one are prefetched while `callback` runs.
+**/
+#define LL_PTR_FOR_EACH(type, list, callback) { \
+    LL_PTR(type)* ll_for_each_node_ = (list); \
+    while (ll_for_each_node_ != NULL) { \
+        LL_PTR(type)* ll_for_each_next_ = ll_for_each_node_->next; \
+        if (ll_for_each_next_ != NULL) { \
+            LL_PREFETCH(ll_for_each_next_->next); \
+            LL_PREFETCH(ll_for_each_next_->value); \
+        } \
+        type* element = ll_for_each_node_->value; \
+        callback; \
+        ll_for_each_node_ = ll_for_each_next_; \
+    } \
+}
+
 #endif // LINKEDLIST_H
@@ -0,0 +1,210 @@
+#ifndef LLSTACK_H
+#define LLSTACK_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "linkedlist.h"
+
+#define LL_ATOMIC_STACK(type) type##_ll_atomic_stack_t
+
+/** @def DECL_LL_ATOMIC_STACK(type)
+    @param type The type of the elements in the stack
+
+    Declares a lock-free stack (Treiber stack) whose nodes are the nodes of `LL(type)`, and the associated functions.
+    This macro requires `DECL_LL(type)` to have been called beforehand.
+
+    The head of the stack is a `(node, tag)` pair updated with a double-width compare-and-swap; the tag is bumped on every update, which protects the stack against the ABA problem.
+**/
+#define DECL_LL_ATOMIC_STACK(type) struct type##_ll_atomic_stack_head { \
+        LL(type)* node; \
+        uintptr_t tag; \
+    }; \
+    struct type##_ll_atomic_stack { \
+        _Atomic(struct type##_ll_atomic_stack_head) head; \
+        _Atomic(LL(type)*) pending; \
+        atomic_size_t poppers; \
+    }; \
+    typedef struct type##_ll_atomic_stack LL_ATOMIC_STACK(type); \
+    LL_ATOMIC_STACK(type)* type##_ll_atomic_stack_new(void); \
+    void type##_ll_atomic_stack_free(LL_ATOMIC_STACK(type)* stack); \
+    bool type##_ll_atomic_stack_push(LL_ATOMIC_STACK(type)* stack, type element); \
+    void type##_ll_atomic_stack_push_list(LL_ATOMIC_STACK(type)* stack, LL(type)* list); \
+    bool type##_ll_atomic_stack_pop(LL_ATOMIC_STACK(type)* stack, type* element); \
+    LL(type)* type##_ll_atomic_stack_pop_all(LL_ATOMIC_STACK(type)* stack); \
+    void type##_ll_atomic_stack_release(LL_ATOMIC_STACK(type)* stack, LL(type)* list); \
+    bool type##_ll_atomic_stack_is_empty(LL_ATOMIC_STACK(type)* stack);
+
+/** @def DEF_LL_ATOMIC_STACK(type)
+    @param type The type of the elements in the stack
+
+    Defines the functions associated with `LL_ATOMIC_STACK(type)`.
+    Requires `DECL_LL(type)`, `DEF_LL(type)` and `DECL_LL_ATOMIC_STACK(type)` to have been called beforehand.
+**/
+#define DEF_LL_ATOMIC_STACK(type) \
+    LL_ATOMIC_STACK(type)* type##_ll_atomic_stack_new(void) { \
+        LL_ATOMIC_STACK(type)* res = (LL_ATOMIC_STACK(type)*)malloc(sizeof(struct type##_ll_atomic_stack)); \
+        if (res == NULL) return NULL; \
+        struct type##_ll_atomic_stack_head head = {NULL, 0}; \
+        atomic_init(&res->head, head); \
+        atomic_init(&res->pending, NULL); \
+        atomic_init(&res->poppers, 0); \
+        return res; \
+    } \
+    void type##_ll_atomic_stack_free(LL_ATOMIC_STACK(type)* stack) { \
+        if (stack == NULL) return; \
+        type##_ll_free(atomic_load(&stack->head).node); \
+        type##_ll_free(atomic_load(&stack->pending)); \
+        free(stack); \
+    } \
+    static void type##_ll_atomic_stack_push_chain(LL_ATOMIC_STACK(type)* stack, LL(type)* first, LL(type)* last) { \
+        struct type##_ll_atomic_stack_head old = atomic_load(&stack->head); \
+        struct type##_ll_atomic_stack_head new; \
+        do { \
+            __atomic_store_n(&last->next, old.node, __ATOMIC_RELAXED); \
+            new.node = first; \
+            new.tag = old.tag + 1; \
+        } while (!atomic_compare_exchange_weak(&stack->head, &old, new)); \
+    } \
+    static void type##_ll_atomic_stack_chain_pending(LL_ATOMIC_STACK(type)* stack, LL(type)* first, LL(type)* last) { \
+        LL(type)* old = atomic_load(&stack->pending); \
+        do { \
+            __atomic_store_n(&last->next, old, __ATOMIC_RELAXED); \
+        } while (!atomic_compare_exchange_weak(&stack->pending, &old, first)); \
+    } \
+    /* Frees the chain [first, last] if no other thread is popping, otherwise defers it; the caller must have incremented `poppers` */ \
+    static void type##_ll_atomic_stack_reclaim(LL_ATOMIC_STACK(type)* stack, LL(type)* first, LL(type)* last) { \
+        if (atomic_load(&stack->poppers) == 1) { \
+            LL(type)* pending = atomic_exchange(&stack->pending, NULL); \
+            if (atomic_fetch_sub(&stack->poppers, 1) == 1) { \
+                type##_ll_free(pending); \
+            } else if (pending != NULL) { \
+                LL(type)* pending_last = pending; \
+                while (pending_last->next != NULL) pending_last = pending_last->next; \
+                type##_ll_atomic_stack_chain_pending(stack, pending, pending_last); \
+            } \
+            type##_ll_free(first); \
+        } else { \
+            type##_ll_atomic_stack_chain_pending(stack, first, last); \
+            atomic_fetch_sub(&stack->poppers, 1); \
+        } \
+    } \
+    bool type##_ll_atomic_stack_push(LL_ATOMIC_STACK(type)* stack, type element) { \
+        if (stack == NULL) return false; \
+        LL(type)* node = (LL(type)*)malloc(sizeof(struct type##_ll)); \
+        if (node == NULL) return false; \
+        node->value = element; \
+        type##_ll_atomic_stack_push_chain(stack, node, node); \
+        return true; \
+    } \
+    void type##_ll_atomic_stack_push_list(LL_ATOMIC_STACK(type)* stack, LL(type)* list) { \
+        if (stack == NULL || list == NULL) return; \
+        LL(type)* last = list; \
+        while (last->next != NULL) last = last->next; \
+        type##_ll_atomic_stack_push_chain(stack, list, last); \
+    } \
+    bool type##_ll_atomic_stack_pop(LL_ATOMIC_STACK(type)* stack, type* element) { \
+        if (stack == NULL) return false; \
+        atomic_fetch_add(&stack->poppers, 1); \
+        struct type##_ll_atomic_stack_head old = atomic_load(&stack->head); \
+        struct type##_ll_atomic_stack_head new; \
+        do { \
+            if (old.node == NULL) { \
+                atomic_fetch_sub(&stack->poppers, 1); \
+                return false; \
+            } \
+            /* old.node cannot be freed while we are counted in `poppers` */ \
+            new.node = __atomic_load_n(&old.node->next, __ATOMIC_RELAXED); \
+            new.tag = old.tag + 1; \
+        } while (!atomic_compare_exchange_weak(&stack->head, &old, new)); \
+        if (element != NULL) *element = old.node->value; \
+        __atomic_store_n(&old.node->next, NULL, __ATOMIC_RELAXED); \
+        type##_ll_atomic_stack_reclaim(stack, old.node, old.node); \
+        return true; \
+    } \
+    LL(type)* type##_ll_atomic_stack_pop_all(LL_ATOMIC_STACK(type)* stack) { \
+        if (stack == NULL) return NULL; \
+        struct type##_ll_atomic_stack_head old = atomic_load(&stack->head); \
+        struct type##_ll_atomic_stack_head new = {NULL, 0}; \
+        do { \
+            if (old.node == NULL) return NULL; \
+            new.tag = old.tag + 1; \
+        } while (!atomic_compare_exchange_weak(&stack->head, &old, new)); \
+        return old.node; \
+    } \
+    void type##_ll_atomic_stack_release(LL_ATOMIC_STACK(type)* stack, LL(type)* list) { \
+        if (stack == NULL || list == NULL) return; \
+        LL(type)* last = list; \
+        while (last->next != NULL) last = last->next; \
+        atomic_fetch_add(&stack->poppers, 1); \
+        type##_ll_atomic_stack_reclaim(stack, list, last); \
+    } \
+    bool type##_ll_atomic_stack_is_empty(LL_ATOMIC_STACK(type)* stack) { \
+        if (stack == NULL) return true; \
+        return atomic_load(&stack->head).node == NULL; \
+    }
+
+/** @struct TYPE_ll_atomic_stack
+
+    A lock-free LIFO stack of values of type `TYPE`, made of `LL(TYPE)` nodes.
+    Every function except `TYPE_ll_atomic_stack_free` may be called concurrently from any number of threads.
+**/
+
+/** @typedef TYPE_ll_atomic_stack_t
+
+    Resolves to `struct TYPE_ll_atomic_stack`; can also be accessed with LL_ATOMIC_STACK(TYPE)
+**/
+
+/** @fn TYPE_ll_atomic_stack_new()
+    @returns The new, empty stack, or NULL on allocation failure
+**/
+
+/** @fn TYPE_ll_atomic_stack_free(LL_ATOMIC_STACK(TYPE)* stack)
+    @param stack The stack to free
+
+    Frees the stack, the nodes it still holds and the nodes whose reclamation was deferred.
+    No other thread may be using the stack at that point.
+**/
+
+/** @fn TYPE_ll_atomic_stack_push(LL_ATOMIC_STACK(TYPE)* stack, TYPE element)
+    @param stack The stack to push the element onto
+    @param element The element to push
+    @returns false if the node could not be allocated, true otherwise
+**/
+
+/** @fn TYPE_ll_atomic_stack_push_list(LL_ATOMIC_STACK(TYPE)* stack, LL(TYPE)* list)
+    @param stack The stack to push the elements onto
+    @param list The linked list to push; its nodes are moved into the stack
+
+    Atomically pushes every node of `list` onto the stack, so that the head of `list` becomes the top of the stack.
+    The nodes must have been allocated with `malloc`, as the stack will eventually free them.
+    This is the way to hand back a list obtained with `TYPE_ll_atomic_stack_pop_all` without allocating.
+**/
+
+/** @fn TYPE_ll_atomic_stack_pop(LL_ATOMIC_STACK(TYPE)* stack, TYPE* element)
+    @param stack The stack to pop an element from
+    @param element Where to write the popped element; may be NULL
+    @returns false if the stack was empty, true otherwise
+
+    Pops the top of the stack.
+    The node that held the element is freed as soon as no other thread is in the middle of a pop; until then it is kept on a pending list.
+**/
+
+/** @fn TYPE_ll_atomic_stack_pop_all(LL_ATOMIC_STACK(TYPE)* stack)
+    @param stack The stack to empty
+    @returns The former content of the stack, top first
+
+    Atomically takes every element of the stack.
+    Other threads may still be reading the returned nodes for a short while, so they must not be freed with `TYPE_ll_free`:
+    give them back with `TYPE_ll_atomic_stack_push_list` or `TYPE_ll_atomic_stack_release` instead.
+**/
+
+/** @fn TYPE_ll_atomic_stack_release(LL_ATOMIC_STACK(TYPE)* stack, LL(TYPE)* list)
+    @param stack The stack `list` was popped from
+    @param list A list returned by `TYPE_ll_atomic_stack_pop_all`
+
+    Frees the nodes of `list` once it is safe to do so.
+**/
+
+#endif // LLSTACK_H
@@ -0,0 +1,319 @@
+#ifndef PVEC_H
+#define PVEC_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#define PVEC(type) type##_pvec_t
+
+/// The number of bits of an index resolved by each level of the trie
+#define PVEC_BITS 5
+/// The number of children of each node of the trie, and of values of each leaf
+#define PVEC_WIDTH (1 << PVEC_BITS)
+#define PVEC_MASK (PVEC_WIDTH - 1)
+
+/** @def DECL_PVEC(type)
+    @param type The type of the elements of the vector
+
+    Declares a persistent vector (PVEC) type and PVEC-associated functions.
+    A persistent vector is never modified: `TYPE_pvec_push` and `TYPE_pvec_set` return a new version of the vector, and leave the previous one untouched.
+    Versions share most of their nodes, which are reference-counted with atomic operations, so that versions can be handed to and released by other threads.
+
+    The values must be plain data: they are copied with `memcpy` whenever a leaf is copied.
+**/
+#define DECL_PVEC(type) struct type##_pvec_node { \
+        atomic_size_t refcount; \
+        void* children[PVEC_WIDTH]; \
+    }; \
+    struct type##_pvec_leaf { \
+        atomic_size_t refcount; \
+        type values[PVEC_WIDTH]; \
+    }; \
+    struct type##_pvec { \
+        atomic_size_t refcount; \
+        size_t length; \
+        unsigned shift; \
+        struct type##_pvec_node* root; \
+        struct type##_pvec_leaf* tail; \
+    }; \
+    typedef struct type##_pvec PVEC(type); \
+    PVEC(type)* type##_pvec_new(void); \
+    PVEC(type)* type##_pvec_retain(PVEC(type)* pvec); \
+    void type##_pvec_release(PVEC(type)* pvec); \
+    size_t type##_pvec_length(const PVEC(type)* pvec); \
+    const type* type##_pvec_get(const PVEC(type)* pvec, size_t index); \
+    PVEC(type)* type##_pvec_set(const PVEC(type)* pvec, size_t index, type value); \
+    PVEC(type)* type##_pvec_push(const PVEC(type)* pvec, type value); \
+    size_t type##_pvec_for_each(const PVEC(type)* pvec, bool (*callback)(const type*, void*), void* callback_data);
+
+/** @def DEF_PVEC(type)
+    @param type The type of the elements of the vector
+
+    Defines the PVEC-associated functions.
+    Requires `DECL_PVEC(type)` to have been called beforehand.
+**/
+#define DEF_PVEC(type) \
+    static void type##_pvec_retain_child(void* child) { \
+        /* Nodes and leaves both start with their reference count */ \
+        if (child != NULL) atomic_fetch_add_explicit((atomic_size_t*)child, 1, memory_order_relaxed); \
+    } \
+    /* Releases a node of the trie, `level` being 0 for leaves */ \
+    static void type##_pvec_release_child(void* child, unsigned level) { \
+        if (child == NULL) return; \
+        if (atomic_fetch_sub_explicit((atomic_size_t*)child, 1, memory_order_acq_rel) != 1) return; \
+        if (level > 0) { \
+            struct type##_pvec_node* node = (struct type##_pvec_node*)child; \
+            for (size_t n = 0; n < PVEC_WIDTH; n++) type##_pvec_release_child(node->children[n], level - PVEC_BITS); \
+        } \
+        free(child); \
+    } \
+    /* Returns a copy of `node` (an empty node if NULL), which holds a new reference to each of its children */ \
+    static struct type##_pvec_node* type##_pvec_copy_node(const struct type##_pvec_node* node) { \
+        struct type##_pvec_node* res = (struct type##_pvec_node*)malloc(sizeof(struct type##_pvec_node)); \
+        if (res == NULL) return NULL; \
+        atomic_init(&res->refcount, 1); \
+        if (node == NULL) { \
+            for (size_t n = 0; n < PVEC_WIDTH; n++) res->children[n] = NULL; \
+        } else { \
+            for (size_t n = 0; n < PVEC_WIDTH; n++) { \
+                res->children[n] = node->children[n]; \
+                type##_pvec_retain_child(res->children[n]); \
+            } \
+        } \
+        return res; \
+    } \
+    /* Returns a copy of the first `length` values of `leaf` */ \
+    static struct type##_pvec_leaf* type##_pvec_copy_leaf(const struct type##_pvec_leaf* leaf, size_t length) { \
+        struct type##_pvec_leaf* res = (struct type##_pvec_leaf*)malloc(sizeof(struct type##_pvec_leaf)); \
+        if (res == NULL) return NULL; \
+        atomic_init(&res->refcount, 1); \
+        if (length > 0) memcpy(res->values, leaf->values, sizeof(type) * length); \
+        return res; \
+    } \
+    /* Wraps a new version around `root` and `tail`, whose references it takes over */ \
+    static PVEC(type)* type##_pvec_wrap(size_t length, unsigned shift, struct type##_pvec_node* root, struct type##_pvec_leaf* tail) { \
+        PVEC(type)* res = (PVEC(type)*)malloc(sizeof(struct type##_pvec)); \
+        if (res == NULL) { \
+            type##_pvec_release_child(root, shift); \
+            type##_pvec_release_child(tail, 0); \
+            return NULL; \
+        } \
+        atomic_init(&res->refcount, 1); \
+        res->length = length; \
+        res->shift = shift; \
+        res->root = root; \
+        res->tail = tail; \
+        return res; \
+    } \
+    /* The index of the first value of the tail */ \
+    static size_t type##_pvec_tail_offset(const PVEC(type)* pvec) { \
+        return pvec->length == 0 ? 0 : (pvec->length - 1) & ~(size_t)PVEC_MASK; \
+    } \
+    static const struct type##_pvec_leaf* type##_pvec_leaf_for(const PVEC(type)* pvec, size_t index) { \
+        if (index >= type##_pvec_tail_offset(pvec)) return pvec->tail; \
+        const struct type##_pvec_node* node = pvec->root; \
+        for (unsigned level = pvec->shift; level > PVEC_BITS; level -= PVEC_BITS) { \
+            node = (const struct type##_pvec_node*)node->children[(index >> level) & PVEC_MASK]; \
+        } \
+        return (const struct type##_pvec_leaf*)node->children[(index >> PVEC_BITS) & PVEC_MASK]; \
+    } \
+    PVEC(type)* type##_pvec_new(void) { \
+        return type##_pvec_wrap(0, PVEC_BITS, NULL, NULL); \
+    } \
+    PVEC(type)* type##_pvec_retain(PVEC(type)* pvec) { \
+        if (pvec != NULL) atomic_fetch_add_explicit(&pvec->refcount, 1, memory_order_relaxed); \
+        return pvec; \
+    } \
+    void type##_pvec_release(PVEC(type)* pvec) { \
+        if (pvec == NULL) return; \
+        if (atomic_fetch_sub_explicit(&pvec->refcount, 1, memory_order_acq_rel) != 1) return; \
+        type##_pvec_release_child(pvec->root, pvec->shift); \
+        type##_pvec_release_child(pvec->tail, 0); \
+        free(pvec); \
+    } \
+    size_t type##_pvec_length(const PVEC(type)* pvec) { \
+        if (pvec == NULL) return 0; \
+        return pvec->length; \
+    } \
+    const type* type##_pvec_get(const PVEC(type)* pvec, size_t index) { \
+        if (pvec == NULL || index >= pvec->length) return NULL; \
+        return &type##_pvec_leaf_for(pvec, index)->values[index & PVEC_MASK]; \
+    } \
+    /* Copies the path from `child` (at `level`) to the value at `index`, and sets that value in the copy */ \
+    static void* type##_pvec_set_rec(const void* child, unsigned level, size_t index, type value) { \
+        if (level == 0) { \
+            struct type##_pvec_leaf* leaf = type##_pvec_copy_leaf((const struct type##_pvec_leaf*)child, PVEC_WIDTH); \
+            if (leaf != NULL) leaf->values[index & PVEC_MASK] = value; \
+            return leaf; \
+        } \
+        struct type##_pvec_node* node = type##_pvec_copy_node((const struct type##_pvec_node*)child); \
+        if (node == NULL) return NULL; \
+        size_t sub = (index >> level) & PVEC_MASK; \
+        void* new_child = type##_pvec_set_rec(node->children[sub], level - PVEC_BITS, index, value); \
+        if (new_child == NULL) { \
+            type##_pvec_release_child(node, level); \
+            return NULL; \
+        } \
+        type##_pvec_release_child(node->children[sub], level - PVEC_BITS); \
+        node->children[sub] = new_child; \
+        return node; \
+    } \
+    PVEC(type)* type##_pvec_set(const PVEC(type)* pvec, size_t index, type value) { \
+        if (pvec == NULL || index >= pvec->length) return NULL; \
+        size_t tail_offset = type##_pvec_tail_offset(pvec); \
+        if (index >= tail_offset) { \
+            struct type##_pvec_leaf* tail = type##_pvec_copy_leaf(pvec->tail, pvec->length - tail_offset); \
+            if (tail == NULL) return NULL; \
+            tail->values[index - tail_offset] = value; \
+            type##_pvec_retain_child(pvec->root); \
+            return type##_pvec_wrap(pvec->length, pvec->shift, pvec->root, tail); \
+        } \
+        struct type##_pvec_node* root = (struct type##_pvec_node*)type##_pvec_set_rec(pvec->root, pvec->shift, index, value); \
+        if (root == NULL) return NULL; \
+        type##_pvec_retain_child(pvec->tail); \
+        return type##_pvec_wrap(pvec->length, pvec->shift, root, pvec->tail); \
+    } \
+    /* Returns a chain of single-child nodes from `level` down to `leaf`, which it takes over */ \
+    static void* type##_pvec_new_path(unsigned level, struct type##_pvec_leaf* leaf) { \
+        if (level == 0) return leaf; \
+        struct type##_pvec_node* node = type##_pvec_copy_node(NULL); \
+        void* child = node == NULL ? NULL : type##_pvec_new_path(level - PVEC_BITS, leaf); \
+        if (child == NULL) { \
+            free(node); \
+            return NULL; \
+        } \
+        node->children[0] = child; \
+        return node; \
+    } \
+    /* Copies the path from `node` (at `level`) to the slot of the leaf that starts at `index`, and puts `leaf` there */ \
+    static struct type##_pvec_node* type##_pvec_push_leaf(const struct type##_pvec_node* node, unsigned level, size_t index, struct type##_pvec_leaf* leaf) { \
+        struct type##_pvec_node* res = type##_pvec_copy_node(node); \
+        if (res == NULL) return NULL; \
+        size_t sub = (index >> level) & PVEC_MASK; \
+        void* child; \
+        if (level == PVEC_BITS) child = leaf; \
+        else if (res->children[sub] != NULL) child = type##_pvec_push_leaf((const struct type##_pvec_node*)res->children[sub], level - PVEC_BITS, index, leaf); \
+        else child = type##_pvec_new_path(level - PVEC_BITS, leaf); \
+        if (child == NULL) { \
+            type##_pvec_release_child(res, level); \
+            return NULL; \
+        } \
+        type##_pvec_release_child(res->children[sub], level - PVEC_BITS); \
+        res->children[sub] = child; \
+        return res; \
+    } \
+    PVEC(type)* type##_pvec_push(const PVEC(type)* pvec, type value) { \
+        if (pvec == NULL) return NULL; \
+        size_t tail_length = pvec->length - type##_pvec_tail_offset(pvec); \
+        if (pvec->length == 0 || tail_length < PVEC_WIDTH) { \
+            struct type##_pvec_leaf* tail = type##_pvec_copy_leaf(pvec->tail, tail_length); \
+            if (tail == NULL) return NULL; \
+            tail->values[tail_length] = value; \
+            type##_pvec_retain_child(pvec->root); \
+            return type##_pvec_wrap(pvec->length + 1, pvec->shift, pvec->root, tail); \
+        } \
+        /* The tail is full: it moves into the trie, which gains a level if it is full as well */ \
+        struct type##_pvec_leaf* tail = type##_pvec_copy_leaf(NULL, 0); \
+        if (tail == NULL) return NULL; \
+        tail->values[0] = value; \
+        struct type##_pvec_leaf* full = pvec->tail; \
+        type##_pvec_retain_child(full); \
+        size_t index = pvec->length - PVEC_WIDTH; \
+        unsigned shift = pvec->shift; \
+        struct type##_pvec_node* root; \
+        if ((pvec->length >> PVEC_BITS) > ((size_t)1 << shift)) { \
+            root = type##_pvec_copy_node(NULL); \
+            void* path = root == NULL ? NULL : type##_pvec_new_path(shift, full); \
+            if (path == NULL) { \
+                free(root); \
+                root = NULL; \
+            } else { \
+                type##_pvec_retain_child(pvec->root); \
+                root->children[0] = pvec->root; \
+                root->children[1] = path; \
+                shift += PVEC_BITS; \
+            } \
+        } else { \
+            root = type##_pvec_push_leaf(pvec->root, shift, index, full); \
+        } \
+        if (root == NULL) { \
+            type##_pvec_release_child(full, 0); \
+            free(tail); \
+            return NULL; \
+        } \
+        return type##_pvec_wrap(pvec->length + 1, shift, root, tail); \
+    } \
+    size_t type##_pvec_for_each(const PVEC(type)* pvec, bool (*callback)(const type*, void*), void* callback_data) { \
+        if (pvec == NULL) return 0; \
+        size_t res = 0; \
+        for (size_t base = 0; base < pvec->length; base += PVEC_WIDTH) { \
+            const struct type##_pvec_leaf* leaf = type##_pvec_leaf_for(pvec, base); \
+            size_t end = pvec->length - base < PVEC_WIDTH ? pvec->length - base : PVEC_WIDTH; \
+            for (size_t n = 0; n < end; n++) { \
+                res++; \
+                if (!callback(&leaf->values[n], callback_data)) return res; \
+            } \
+        } \
+        return res; \
+    }
+
+/** @struct TYPE_pvec
+
+    A version of a persistent vector: a 32-way trie whose leaves hold the values, and a tail leaf holding the last values, up to 32 of them.
+    Reading a value goes down `log32(n)` levels, ie. at most 7 on 64-bit platforms; pushing a value usually only copies the tail.
+**/
+
+/** @typedef TYPE_pvec_t
+
+    Resolves to `struct TYPE_pvec`; can also be accessed with `PVEC(TYPE)`.
+**/
+
+/** @fn TYPE_pvec_new()
+    @returns A new, empty version, or NULL on allocation failure; it must be released with `TYPE_pvec_release`
+**/
+
+/** @fn TYPE_pvec_retain(PVEC(TYPE)* pvec)
+    @param pvec The version to keep
+    @returns `pvec`
+
+    Takes a new reference to `pvec`: this is how snapshots are made, in `O(1)`.
+    Each reference must be given back with `TYPE_pvec_release`, from any thread.
+**/
+
+/** @fn TYPE_pvec_release(PVEC(TYPE)* pvec)
+    @param pvec The version to release
+
+    Gives back a reference to `pvec`; the version is freed along with the nodes that no other version uses once its last reference is released.
+**/
+
+/** @fn TYPE_pvec_length(const PVEC(TYPE)* pvec)
+    @returns The number of values of `pvec`, 0 if NULL
+**/
+
+/** @fn TYPE_pvec_get(const PVEC(TYPE)* pvec, size_t index)
+    @returns A pointer to the value at `index`, valid as long as `pvec` is, or NULL if `index` is out of bounds
+**/
+
+/** @fn TYPE_pvec_set(const PVEC(TYPE)* pvec, size_t index, TYPE value)
+    @returns A new version of `pvec` whose value at `index` is `value`, or NULL if `index` is out of bounds or on allocation failure
+
+    Only the path from the root to the leaf of `index` is copied: `O(log32 n)`.
+**/
+
+/** @fn TYPE_pvec_push(const PVEC(TYPE)* pvec, TYPE value)
+    @returns A new version of `pvec` with `value` appended, or NULL on allocation failure
+
+    Runs in amortized `O(1)`: the tail is copied, and once every 32 pushes, it is moved into the trie.
+**/
+
+/** @fn TYPE_pvec_for_each(const PVEC(TYPE)* pvec, bool (*callback)(const TYPE*, void*), void* callback_data)
+    @param callback Called on each value, in order; returning false stops the iteration
+    @param callback_data A user-defined void pointer passed to `callback`
+    @returns The number of times `callback` was called
+
+    Goes down the trie once per leaf rather than once per value.
+**/
+
+#endif // PVEC_H
@@ -4,6 +4,7 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 
 #define _RING_MIN(a, b) ((a) < (b) ? (a) : (b))
 
@@ -104,7 +105,7 @@
     type type##_ring_pop_head(RING(type)* ring) { \
         type res; \
         if (ring->length == 0) return res; \
-        res = ring->data[ring->start + ring->length - 1]; \
+        res = ring->data[(ring->start + ring->length - 1) % ring->capacity]; \
         ring->length -= 1; \
         return res; \
     } \
@@ -112,7 +113,7 @@
         type res; \
         if (ring->length == 0) return res; \
         res = ring->data[ring->start]; \
-        ring->start += 1; \
+        ring->start = (ring->start + 1) % ring->capacity; \
         ring->length -= 1; \
         return res; \
     } \
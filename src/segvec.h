@@ -0,0 +1,208 @@
+#ifndef SEGVEC_H
+#define SEGVEC_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#define SEGVEC(type) type##_segvec_t
+
+/// The size of the segment table; segment k holds `SEGVEC_FIRST << k` values, so that the table is never the limit
+#define SEGVEC_SEGMENTS 64
+/// The number of values of the first segment is `1 << SEGVEC_FIRST_BITS`
+#define SEGVEC_FIRST_BITS 5
+#define SEGVEC_FIRST ((size_t)1 << SEGVEC_FIRST_BITS)
+
+/* Returns the segment that holds `index`: shifting the indices by SEGVEC_FIRST makes segment k start at the power of two SEGVEC_FIRST << k */
+static inline unsigned segvec_segment(size_t index) {
+    uint64_t shifted = (uint64_t)index + SEGVEC_FIRST;
+#if defined(__GNUC__) || defined(__clang__)
+    unsigned log = 63 - (unsigned)__builtin_clzll(shifted);
+#else
+    unsigned log = 0;
+    while (shifted >>= 1) log++;
+#endif
+    return log - SEGVEC_FIRST_BITS;
+}
+
+/* Returns the index of the first value of the segment `segment` */
+static inline size_t segvec_segment_start(unsigned segment) {
+    return (SEGVEC_FIRST << segment) - SEGVEC_FIRST;
+}
+
+/** @def DECL_SEGVEC(type)
+    @param type The type of the elements of the vector
+
+    Declares a segmented vector (SEGVEC) type and SEGVEC-associated functions.
+    A segmented vector is an append-only vector that many threads may push to and read from at the same time, without locking.
+    Its values live in segments whose sizes double, and which are never moved nor freed before the vector itself:
+    the address of a value stays valid for as long as the vector does.
+**/
+#define DECL_SEGVEC(type) struct type##_segvec_slot { \
+        atomic_bool ready; \
+        type value; \
+    }; \
+    struct type##_segvec { \
+        _Atomic(struct type##_segvec_slot*) segments[SEGVEC_SEGMENTS]; \
+        atomic_size_t length; \
+    }; \
+    typedef struct type##_segvec SEGVEC(type); \
+    SEGVEC(type)* type##_segvec_new(void); \
+    void type##_segvec_free(SEGVEC(type)* segvec); \
+    size_t type##_segvec_length(const SEGVEC(type)* segvec); \
+    size_t type##_segvec_reserve(SEGVEC(type)* segvec, size_t capacity); \
+    bool type##_segvec_push(SEGVEC(type)* segvec, type value, size_t* index); \
+    type* type##_segvec_get(SEGVEC(type)* segvec, size_t index); \
+    size_t type##_segvec_for_each(SEGVEC(type)* segvec, bool (*callback)(const type*, void*), void* callback_data);
+
+/** @def DEF_SEGVEC(type)
+    @param type The type of the elements of the vector
+
+    Defines the SEGVEC-associated functions.
+    Requires `DECL_SEGVEC(type)` to have been called beforehand.
+**/
+#define DEF_SEGVEC(type) \
+    /* Returns the segment `segment`, allocating it if no other thread has done so yet; NULL if it could not be allocated */ \
+    static struct type##_segvec_slot* type##_segvec_segment(SEGVEC(type)* segvec, unsigned segment) { \
+        struct type##_segvec_slot* res = atomic_load_explicit(&segvec->segments[segment], memory_order_acquire); \
+        if (res != NULL) return res; \
+        /* The ready flags of a new segment must all be clear */ \
+        struct type##_segvec_slot* fresh = (struct type##_segvec_slot*)calloc(SEGVEC_FIRST << segment, sizeof(struct type##_segvec_slot)); \
+        if (fresh == NULL) return NULL; \
+        if (atomic_compare_exchange_strong_explicit(&segvec->segments[segment], &res, fresh, memory_order_acq_rel, memory_order_acquire)) { \
+            return fresh; \
+        } \
+        /* Another thread installed its segment first */ \
+        free(fresh); \
+        return res; \
+    } \
+    SEGVEC(type)* type##_segvec_new(void) { \
+        SEGVEC(type)* res = (SEGVEC(type)*)malloc(sizeof(struct type##_segvec)); \
+        if (res == NULL) return NULL; \
+        for (size_t n = 0; n < SEGVEC_SEGMENTS; n++) atomic_init(&res->segments[n], NULL); \
+        atomic_init(&res->length, 0); \
+        return res; \
+    } \
+    void type##_segvec_free(SEGVEC(type)* segvec) { \
+        if (segvec == NULL) return; \
+        for (size_t n = 0; n < SEGVEC_SEGMENTS; n++) { \
+            free(atomic_load_explicit(&segvec->segments[n], memory_order_relaxed)); \
+        } \
+        free(segvec); \
+    } \
+    size_t type##_segvec_length(const SEGVEC(type)* segvec) { \
+        if (segvec == NULL) return 0; \
+        return atomic_load_explicit(&segvec->length, memory_order_acquire); \
+    } \
+    size_t type##_segvec_reserve(SEGVEC(type)* segvec, size_t capacity) { \
+        if (segvec == NULL || capacity == 0) return 0; \
+        unsigned last = segvec_segment(capacity - 1); \
+        for (unsigned segment = 0; segment <= last; segment++) { \
+            if (type##_segvec_segment(segvec, segment) == NULL) return 0; \
+        } \
+        return segvec_segment_start(last + 1); \
+    } \
+    bool type##_segvec_push(SEGVEC(type)* segvec, type value, size_t* index) { \
+        if (segvec == NULL) return false; \
+        size_t res = atomic_fetch_add_explicit(&segvec->length, 1, memory_order_relaxed); \
+        unsigned segment = segvec_segment(res); \
+        struct type##_segvec_slot* slots = type##_segvec_segment(segvec, segment); \
+        /* The slot is lost: readers will never see it as ready */ \
+        if (slots == NULL) return false; \
+        struct type##_segvec_slot* slot = &slots[res - segvec_segment_start(segment)]; \
+        slot->value = value; \
+        atomic_store_explicit(&slot->ready, true, memory_order_release); \
+        if (index != NULL) *index = res; \
+        return true; \
+    } \
+    type* type##_segvec_get(SEGVEC(type)* segvec, size_t index) { \
+        if (segvec == NULL || index > SIZE_MAX - SEGVEC_FIRST) return NULL; \
+        unsigned segment = segvec_segment(index); \
+        struct type##_segvec_slot* slots = atomic_load_explicit(&segvec->segments[segment], memory_order_acquire); \
+        if (slots == NULL) return NULL; \
+        struct type##_segvec_slot* slot = &slots[index - segvec_segment_start(segment)]; \
+        if (!atomic_load_explicit(&slot->ready, memory_order_acquire)) return NULL; \
+        return &slot->value; \
+    } \
+    size_t type##_segvec_for_each(SEGVEC(type)* segvec, bool (*callback)(const type*, void*), void* callback_data) { \
+        if (segvec == NULL) return 0; \
+        size_t length = type##_segvec_length(segvec); \
+        size_t res = 0; \
+        /* Walks each segment directly, rather than looking up the segment of every index */ \
+        for (unsigned segment = 0; segvec_segment_start(segment) < length; segment++) { \
+            struct type##_segvec_slot* slots = atomic_load_explicit(&segvec->segments[segment], memory_order_acquire); \
+            if (slots == NULL) continue; \
+            size_t start = segvec_segment_start(segment); \
+            size_t end = segvec_segment_start(segment + 1) < length ? segvec_segment_start(segment + 1) : length; \
+            for (size_t n = 0; n < end - start; n++) { \
+                if (!atomic_load_explicit(&slots[n].ready, memory_order_acquire)) continue; \
+                res++; \
+                if (!callback(&slots[n].value, callback_data)) return res; \
+            } \
+        } \
+        return res; \
+    }
+
+/** @struct TYPE_segvec
+
+    A segmented vector of values of type `TYPE`: segment `k` of the segment table holds the values `SEGVEC_FIRST * (2^k - 1)` to `SEGVEC_FIRST * (2^(k + 1) - 1)` (excluded),
+    and is allocated by the first push that needs it.
+    `length` counts the slots handed out by `atomic_fetch_add`; each slot holds a value and a `ready` flag, which is set once the value has been written.
+**/
+
+/** @typedef TYPE_segvec_t
+
+    Resolves to `struct TYPE_segvec`; can also be accessed with `SEGVEC(TYPE)`.
+**/
+
+/** @fn TYPE_segvec_new()
+    @returns A new, empty segmented vector, or NULL if it could not be allocated; no segment is allocated yet
+**/
+
+/** @fn TYPE_segvec_free(SEGVEC(TYPE)* segvec)
+    @param segvec The vector to free
+
+    Frees the vector and all of its segments; no other thread may be using it.
+**/
+
+/** @fn TYPE_segvec_length(const SEGVEC(TYPE)* segvec)
+    @returns The number of slots handed out so far
+
+    Values whose push is still in progress are counted: `TYPE_segvec_get` may return NULL for indices below the length.
+**/
+
+/** @fn TYPE_segvec_reserve(SEGVEC(TYPE)* segvec, size_t capacity)
+    @param capacity The number of values to make room for
+    @returns The number of values the allocated segments can hold, or 0 if one of them could not be allocated
+
+    Allocates the segments needed to hold `capacity` values ahead of time, so that pushes do not allocate.
+    May be called while other threads push.
+**/
+
+/** @fn TYPE_segvec_push(SEGVEC(TYPE)* segvec, TYPE value, size_t* index)
+    @param value The value to append
+    @param index If not NULL, where to write the index of the new value
+    @returns true, or false if the segment of the value could not be allocated; its index is then never filled
+
+    Reserves a slot with a single `atomic_fetch_add`, then writes `value` to it and publishes it.
+    The only other synchronization happens when a push is the first to reach a new segment, which it allocates and installs with a compare-and-swap.
+    Values pushed by the same thread are stored in order; values pushed by different threads are interleaved.
+**/
+
+/** @fn TYPE_segvec_get(SEGVEC(TYPE)* segvec, size_t index)
+    @returns A pointer to the value at `index`, or NULL if that value has not been published yet
+
+    Never locks: a value is only returned once its push has completed, and the returned pointer stays valid until `TYPE_segvec_free`.
+    Writing through the pointer is not synchronized with other readers.
+**/
+
+/** @fn TYPE_segvec_for_each(SEGVEC(TYPE)* segvec, bool (*callback)(const TYPE*, void*), void* callback_data)
+    @param callback Called on each published value, in order of index; returning false stops the iteration
+    @param callback_data A user-defined void pointer passed to `callback`
+    @returns The number of times `callback` was called
+
+    Values pushed after the iteration has started, or whose push has not completed yet, may be skipped.
+**/
+
+#endif // SEGVEC_H
@@ -0,0 +1,242 @@
+#ifndef SKIPLIST_H
+#define SKIPLIST_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SKIPLIST(key_type, value_type) key_type##_##value_type##_skiplist_t
+#define SKIPLIST_NODE(key_type, value_type) key_type##_##value_type##_skiplist_node_t
+
+/// The maximum number of levels of a skip list; with a promotion probability of 1/4, this is enough for 2^64 elements
+#define SKIPLIST_MAX_LEVEL 32
+
+/** @def DECL_SKIPLIST(key_type, value_type)
+    @param key_type The type of the keys
+    @param value_type The type of the values
+
+    Declares an ordered map (SKIPLIST) from `key_type` to `value_type`, backed by a skip list, and the SKIPLIST-associated functions.
+    Each node holds its key, its value and its forward pointers in a single allocation.
+**/
+#define DECL_SKIPLIST(key_type, value_type) struct key_type##_##value_type##_skiplist_node { \
+        key_type key; \
+        value_type value; \
+        size_t level; \
+        struct key_type##_##value_type##_skiplist_node* next[]; \
+    }; \
+    typedef struct key_type##_##value_type##_skiplist_node SKIPLIST_NODE(key_type, value_type); \
+    struct key_type##_##value_type##_skiplist { \
+        SKIPLIST_NODE(key_type, value_type)* head; \
+        size_t length; \
+        size_t level; \
+        uint64_t seed; \
+    }; \
+    typedef struct key_type##_##value_type##_skiplist SKIPLIST(key_type, value_type); \
+    SKIPLIST(key_type, value_type)* key_type##_##value_type##_skiplist_new(void); \
+    void key_type##_##value_type##_skiplist_free(SKIPLIST(key_type, value_type)* list); \
+    size_t key_type##_##value_type##_skiplist_length(const SKIPLIST(key_type, value_type)* list); \
+    bool key_type##_##value_type##_skiplist_insert(SKIPLIST(key_type, value_type)* list, key_type key, value_type value); \
+    value_type* key_type##_##value_type##_skiplist_find(SKIPLIST(key_type, value_type)* list, key_type key); \
+    bool key_type##_##value_type##_skiplist_erase(SKIPLIST(key_type, value_type)* list, key_type key); \
+    SKIPLIST_NODE(key_type, value_type)* key_type##_##value_type##_skiplist_first(SKIPLIST(key_type, value_type)* list); \
+    SKIPLIST_NODE(key_type, value_type)* key_type##_##value_type##_skiplist_lower_bound(SKIPLIST(key_type, value_type)* list, key_type key); \
+    SKIPLIST_NODE(key_type, value_type)* key_type##_##value_type##_skiplist_next(SKIPLIST_NODE(key_type, value_type)* node); \
+    size_t key_type##_##value_type##_skiplist_for_each_range(SKIPLIST(key_type, value_type)* list, key_type lo, key_type hi, bool (*callback)(const key_type*, value_type*, void*), void* callback_data);
+
+/** @def DEF_SKIPLIST(key_type, value_type, cmp)
+    @param key_type The type of the keys
+    @param value_type The type of the values
+    @param cmp A function or macro taking two keys `a` and `b` and returning a negative value if `a < b`, a positive value if `a > b` and 0 if they are equal
+
+    Defines the SKIPLIST-associated functions.
+    Requires `DECL_SKIPLIST(key_type, value_type)` to have been called beforehand.
+    `cmp` is expanded inline, so that a macro or a `static inline` function costs no call.
+**/
+#define DEF_SKIPLIST(key_type, value_type, cmp) \
+    static SKIPLIST_NODE(key_type, value_type)* key_type##_##value_type##_skiplist_node_new(size_t level) { \
+        SKIPLIST_NODE(key_type, value_type)* res = (SKIPLIST_NODE(key_type, value_type)*)malloc( \
+            sizeof(struct key_type##_##value_type##_skiplist_node) + sizeof(SKIPLIST_NODE(key_type, value_type)*) * level \
+        ); \
+        if (res == NULL) return NULL; \
+        res->level = level; \
+        for (size_t n = 0; n < level; n++) res->next[n] = NULL; \
+        return res; \
+    } \
+    static size_t key_type##_##value_type##_skiplist_random_level(SKIPLIST(key_type, value_type)* list) { \
+        /* xorshift64; every two bits of the output promote a node with probability 1/4 */ \
+        uint64_t x = list->seed; \
+        x ^= x << 13; \
+        x ^= x >> 7; \
+        x ^= x << 17; \
+        list->seed = x; \
+        size_t level = 1; \
+        while (level < SKIPLIST_MAX_LEVEL && (x & 3) == 0) { \
+            level++; \
+            x >>= 2; \
+        } \
+        return level; \
+    } \
+    /* Fills `update[n]` with the last node at level n whose key is lower than `key`, and returns the node following update[0] */ \
+    static SKIPLIST_NODE(key_type, value_type)* key_type##_##value_type##_skiplist_search(SKIPLIST(key_type, value_type)* list, key_type key, SKIPLIST_NODE(key_type, value_type)** update) { \
+        SKIPLIST_NODE(key_type, value_type)* node = list->head; \
+        for (size_t n = list->level; n-- > 0;) { \
+            while (node->next[n] != NULL && cmp(node->next[n]->key, key) < 0) node = node->next[n]; \
+            if (update != NULL) update[n] = node; \
+        } \
+        return node->next[0]; \
+    } \
+    SKIPLIST(key_type, value_type)* key_type##_##value_type##_skiplist_new(void) { \
+        SKIPLIST(key_type, value_type)* res = (SKIPLIST(key_type, value_type)*)malloc(sizeof(struct key_type##_##value_type##_skiplist)); \
+        if (res == NULL) return NULL; \
+        res->head = key_type##_##value_type##_skiplist_node_new(SKIPLIST_MAX_LEVEL); \
+        if (res->head == NULL) { \
+            free(res); \
+            return NULL; \
+        } \
+        res->length = 0; \
+        res->level = 1; \
+        res->seed = (uint64_t)(uintptr_t)res | 1; \
+        return res; \
+    } \
+    void key_type##_##value_type##_skiplist_free(SKIPLIST(key_type, value_type)* list) { \
+        if (list == NULL) return; \
+        SKIPLIST_NODE(key_type, value_type)* node = list->head; \
+        while (node != NULL) { \
+            SKIPLIST_NODE(key_type, value_type)* next = node->next[0]; \
+            free(node); \
+            node = next; \
+        } \
+        free(list); \
+    } \
+    size_t key_type##_##value_type##_skiplist_length(const SKIPLIST(key_type, value_type)* list) { \
+        if (list == NULL) return 0; \
+        return list->length; \
+    } \
+    bool key_type##_##value_type##_skiplist_insert(SKIPLIST(key_type, value_type)* list, key_type key, value_type value) { \
+        if (list == NULL) return false; \
+        SKIPLIST_NODE(key_type, value_type)* update[SKIPLIST_MAX_LEVEL]; \
+        SKIPLIST_NODE(key_type, value_type)* node = key_type##_##value_type##_skiplist_search(list, key, update); \
+        if (node != NULL && cmp(node->key, key) == 0) { \
+            node->value = value; \
+            return false; \
+        } \
+        size_t level = key_type##_##value_type##_skiplist_random_level(list); \
+        node = key_type##_##value_type##_skiplist_node_new(level); \
+        if (node == NULL) return false; \
+        node->key = key; \
+        node->value = value; \
+        for (size_t n = list->level; n < level; n++) update[n] = list->head; \
+        if (level > list->level) list->level = level; \
+        for (size_t n = 0; n < level; n++) { \
+            node->next[n] = update[n]->next[n]; \
+            update[n]->next[n] = node; \
+        } \
+        list->length++; \
+        return true; \
+    } \
+    value_type* key_type##_##value_type##_skiplist_find(SKIPLIST(key_type, value_type)* list, key_type key) { \
+        if (list == NULL) return NULL; \
+        SKIPLIST_NODE(key_type, value_type)* node = key_type##_##value_type##_skiplist_search(list, key, NULL); \
+        if (node != NULL && cmp(node->key, key) == 0) return &node->value; \
+        return NULL; \
+    } \
+    bool key_type##_##value_type##_skiplist_erase(SKIPLIST(key_type, value_type)* list, key_type key) { \
+        if (list == NULL) return false; \
+        SKIPLIST_NODE(key_type, value_type)* update[SKIPLIST_MAX_LEVEL]; \
+        SKIPLIST_NODE(key_type, value_type)* node = key_type##_##value_type##_skiplist_search(list, key, update); \
+        if (node == NULL || cmp(node->key, key) != 0) return false; \
+        for (size_t n = 0; n < node->level; n++) update[n]->next[n] = node->next[n]; \
+        free(node); \
+        while (list->level > 1 && list->head->next[list->level - 1] == NULL) list->level--; \
+        list->length--; \
+        return true; \
+    } \
+    SKIPLIST_NODE(key_type, value_type)* key_type##_##value_type##_skiplist_first(SKIPLIST(key_type, value_type)* list) { \
+        if (list == NULL) return NULL; \
+        return list->head->next[0]; \
+    } \
+    SKIPLIST_NODE(key_type, value_type)* key_type##_##value_type##_skiplist_lower_bound(SKIPLIST(key_type, value_type)* list, key_type key) { \
+        if (list == NULL) return NULL; \
+        return key_type##_##value_type##_skiplist_search(list, key, NULL); \
+    } \
+    SKIPLIST_NODE(key_type, value_type)* key_type##_##value_type##_skiplist_next(SKIPLIST_NODE(key_type, value_type)* node) { \
+        if (node == NULL) return NULL; \
+        return node->next[0]; \
+    } \
+    size_t key_type##_##value_type##_skiplist_for_each_range(SKIPLIST(key_type, value_type)* list, key_type lo, key_type hi, bool (*callback)(const key_type*, value_type*, void*), void* callback_data) { \
+        size_t res = 0; \
+        SKIPLIST_NODE(key_type, value_type)* node = key_type##_##value_type##_skiplist_lower_bound(list, lo); \
+        while (node != NULL && cmp(node->key, hi) < 0) { \
+            res++; \
+            if (!callback(&node->key, &node->value, callback_data)) break; \
+            node = node->next[0]; \
+        } \
+        return res; \
+    }
+
+/** @struct KEY_VALUE_skiplist
+
+    An ordered map from keys of type `KEY` to values of type `VALUE`, implemented as a skip list.
+    Insertion, lookup and removal take `O(log n)` expected time.
+**/
+
+/** @typedef KEY_VALUE_skiplist_t
+
+    Resolves to `struct KEY_VALUE_skiplist`; can also be accessed with SKIPLIST(KEY, VALUE)
+**/
+
+/** @typedef KEY_VALUE_skiplist_node_t
+
+    Resolves to `struct KEY_VALUE_skiplist_node`, a node of the skip list; can also be accessed with SKIPLIST_NODE(KEY, VALUE).
+    Its `key` and `value` fields may be read, and `value` may be modified; `key` must not be modified.
+**/
+
+/** @fn KEY_VALUE_skiplist_new()
+    @returns A new, empty skip list, or NULL on allocation failure
+**/
+
+/** @fn KEY_VALUE_skiplist_free(SKIPLIST(KEY, VALUE)* list)
+    @param list The skip list to free
+
+    Frees all of the memory used by `list`.
+**/
+
+/** @fn KEY_VALUE_skiplist_insert(SKIPLIST(KEY, VALUE)* list, KEY key, VALUE value)
+    @param list The skip list to insert into
+    @param key The key to insert
+    @param value The value to associate with `key`
+    @returns true if `key` was added, false if it was already present (in which case its value is replaced) or if the node could not be allocated
+**/
+
+/** @fn KEY_VALUE_skiplist_find(SKIPLIST(KEY, VALUE)* list, KEY key)
+    @param list The skip list to search through
+    @param key The key to look for
+    @returns A pointer to the value associated with `key`, or NULL if there is none
+**/
+
+/** @fn KEY_VALUE_skiplist_erase(SKIPLIST(KEY, VALUE)* list, KEY key)
+    @param list The skip list to remove the key from
+    @param key The key to remove
+    @returns true if `key` was found and removed, false otherwise
+**/
+
+/** @fn KEY_VALUE_skiplist_lower_bound(SKIPLIST(KEY, VALUE)* list, KEY key)
+    @param list The skip list to search through
+    @param key The key to look for
+    @returns The first node whose key is greater than or equal to `key`, or NULL if there is none
+
+    Together with `KEY_VALUE_skiplist_first` and `KEY_VALUE_skiplist_next`, this allows the keys to be iterated over in order, starting from any key.
+**/
+
+/** @fn KEY_VALUE_skiplist_for_each_range(SKIPLIST(KEY, VALUE)* list, KEY lo, KEY hi, bool (*callback)(const KEY*, VALUE*, void*), void* callback_data)
+    @param list The skip list to iterate over
+    @param lo The lower bound of the range, inclusive
+    @param hi The upper bound of the range, exclusive
+    @param callback Called for each key in `[lo, hi)`, in order; returning false stops the iteration
+    @param callback_data A user-defined pointer passed to `callback`
+    @returns The number of times `callback` was called
+
+    Visits the entries whose key is within `[lo, hi)`, in `O(log n + k)` expected time for `k` visited entries.
+**/
+
+#endif // SKIPLIST_H
@@ -0,0 +1,260 @@
+#ifndef SLOTMAP_H
+#define SLOTMAP_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "vec.h"
+
+#define SLOTMAP(type) type##_slotmap_t
+
+/// A handle that never refers to a value, since valid handles have an odd generation
+#define SLOTMAP_NULL ((uint64_t)0)
+/// Builds the handle of the slot `index` at the generation `generation`
+#define SLOTMAP_HANDLE(index, generation) (((uint64_t)(generation) << 32) | (uint64_t)(index))
+#define SLOTMAP_INDEX(handle) ((uint32_t)((handle) & 0xFFFFFFFFu))
+#define SLOTMAP_GENERATION(handle) ((uint32_t)((handle) >> 32))
+/// Marks the end of the freelist; slot indices are always below it
+#define SLOTMAP_NONE UINT32_MAX
+
+/** @def DECL_SLOTMAP(type)
+    @param type The type of the elements of the slot map
+
+    Declares a slot map (SLOTMAP) type and SLOTMAP-associated functions.
+    A slot map stores values in a dense `VEC(type)` and hands out 64-bit handles to them, which stay valid until the value is removed:
+    inserting, removing and looking up a value are `O(1)`, and a removed value's handle is never mistaken for a newer value's.
+    This macro requires `DECL_VEC(type)` to have been called beforehand.
+**/
+#define DECL_SLOTMAP(type) struct type##_slotmap_slot { \
+        uint32_t generation; \
+        uint32_t index; \
+    }; \
+    struct type##_slotmap { \
+        VEC(type)* values; \
+        uint32_t* owners; \
+        struct type##_slotmap_slot* slots; \
+        uint32_t slot_count; \
+        uint32_t slot_capacity; \
+        uint32_t free_head; \
+    }; \
+    typedef struct type##_slotmap SLOTMAP(type); \
+    SLOTMAP(type)* type##_slotmap_new(size_t capacity); \
+    void type##_slotmap_free(SLOTMAP(type)* map); \
+    size_t type##_slotmap_length(const SLOTMAP(type)* map); \
+    uint64_t type##_slotmap_insert(SLOTMAP(type)* map, type value); \
+    type* type##_slotmap_get(SLOTMAP(type)* map, uint64_t handle); \
+    bool type##_slotmap_contains(const SLOTMAP(type)* map, uint64_t handle); \
+    bool type##_slotmap_remove(SLOTMAP(type)* map, uint64_t handle, type* out); \
+    void type##_slotmap_clear(SLOTMAP(type)* map); \
+    type* type##_slotmap_values(SLOTMAP(type)* map); \
+    uint64_t type##_slotmap_handle_at(const SLOTMAP(type)* map, size_t index);
+
+/** @def DEF_SLOTMAP(type)
+    @param type The type of the elements of the slot map
+
+    Defines the SLOTMAP-associated functions.
+    Requires `DECL_VEC(type)`, `DEF_VEC(type)` and `DECL_SLOTMAP(type)` to have been called beforehand.
+**/
+#define DEF_SLOTMAP(type) \
+    /* Returns the slot `handle` refers to, or NULL if its value has been removed */ \
+    static const struct type##_slotmap_slot* type##_slotmap_slot_of(const SLOTMAP(type)* map, uint64_t handle) { \
+        if (map == NULL) return NULL; \
+        uint32_t index = SLOTMAP_INDEX(handle); \
+        uint32_t generation = SLOTMAP_GENERATION(handle); \
+        /* An even generation means that the slot is vacant, whichever handle is given */ \
+        if (index >= map->slot_count || (generation & 1) == 0) return NULL; \
+        if (map->slots[index].generation != generation) return NULL; \
+        return &map->slots[index]; \
+    } \
+    SLOTMAP(type)* type##_slotmap_new(size_t capacity) { \
+        if (capacity == 0) capacity = 1; \
+        if (capacity >= SLOTMAP_NONE) return NULL; \
+        SLOTMAP(type)* res = (SLOTMAP(type)*)malloc(sizeof(struct type##_slotmap)); \
+        if (res == NULL) return NULL; \
+        res->values = type##_vec_new(capacity); \
+        res->owners = (uint32_t*)malloc(sizeof(uint32_t) * capacity); \
+        res->slots = (struct type##_slotmap_slot*)malloc(sizeof(struct type##_slotmap_slot) * capacity); \
+        if (res->values == NULL || res->owners == NULL || res->slots == NULL) { \
+            type##_vec_free(res->values); \
+            free(res->owners); \
+            free(res->slots); \
+            free(res); \
+            return NULL; \
+        } \
+        res->slot_count = 0; \
+        res->slot_capacity = (uint32_t)capacity; \
+        res->free_head = SLOTMAP_NONE; \
+        return res; \
+    } \
+    void type##_slotmap_free(SLOTMAP(type)* map) { \
+        if (map == NULL) return; \
+        type##_vec_free(map->values); \
+        free(map->owners); \
+        free(map->slots); \
+        free(map); \
+    } \
+    size_t type##_slotmap_length(const SLOTMAP(type)* map) { \
+        if (map == NULL) return 0; \
+        return map->values->length; \
+    } \
+    uint64_t type##_slotmap_insert(SLOTMAP(type)* map, type value) { \
+        if (map == NULL) return SLOTMAP_NULL; \
+        /* Everything is grown first, so that a failed insertion leaves the map untouched */ \
+        if (map->values->length == map->values->capacity) { \
+            size_t capacity = map->values->capacity * 2; \
+            if (capacity >= SLOTMAP_NONE) capacity = SLOTMAP_NONE - 1; \
+            if (capacity <= map->values->length) return SLOTMAP_NULL; \
+            uint32_t* owners = (uint32_t*)realloc(map->owners, sizeof(uint32_t) * capacity); \
+            if (owners == NULL) return SLOTMAP_NULL; \
+            map->owners = owners; \
+            if (type##_vec_resize(map->values, capacity) == 0) return SLOTMAP_NULL; \
+        } \
+        if (map->free_head == SLOTMAP_NONE && map->slot_count == map->slot_capacity) { \
+            size_t capacity = (size_t)map->slot_capacity * 2; \
+            if (capacity >= SLOTMAP_NONE) capacity = SLOTMAP_NONE - 1; \
+            if (capacity <= map->slot_count) return SLOTMAP_NULL; \
+            struct type##_slotmap_slot* slots = (struct type##_slotmap_slot*)realloc(map->slots, sizeof(struct type##_slotmap_slot) * capacity); \
+            if (slots == NULL) return SLOTMAP_NULL; \
+            map->slots = slots; \
+            map->slot_capacity = (uint32_t)capacity; \
+        } \
+        uint32_t index; \
+        if (map->free_head != SLOTMAP_NONE) { \
+            index = map->free_head; \
+            map->free_head = map->slots[index].index; \
+        } else { \
+            index = map->slot_count++; \
+            map->slots[index].generation = 0; \
+        } \
+        struct type##_slotmap_slot* slot = &map->slots[index]; \
+        /* Vacant slots have an even generation, and occupied ones an odd generation */ \
+        slot->generation += 1; \
+        slot->index = (uint32_t)map->values->length; \
+        map->owners[slot->index] = index; \
+        map->values->data[map->values->length++] = value; \
+        return SLOTMAP_HANDLE(index, slot->generation); \
+    } \
+    type* type##_slotmap_get(SLOTMAP(type)* map, uint64_t handle) { \
+        const struct type##_slotmap_slot* slot = type##_slotmap_slot_of(map, handle); \
+        if (slot == NULL) return NULL; \
+        return &map->values->data[slot->index]; \
+    } \
+    bool type##_slotmap_contains(const SLOTMAP(type)* map, uint64_t handle) { \
+        return type##_slotmap_slot_of(map, handle) != NULL; \
+    } \
+    bool type##_slotmap_remove(SLOTMAP(type)* map, uint64_t handle, type* out) { \
+        const struct type##_slotmap_slot* found = type##_slotmap_slot_of(map, handle); \
+        if (found == NULL) return false; \
+        uint32_t index = SLOTMAP_INDEX(handle); \
+        struct type##_slotmap_slot* slot = &map->slots[index]; \
+        uint32_t dense = slot->index; \
+        if (out != NULL) *out = map->values->data[dense]; \
+        /* Moves the last value into the hole, so that the values stay packed */ \
+        uint32_t last = (uint32_t)map->values->length - 1; \
+        if (dense != last) { \
+            map->values->data[dense] = map->values->data[last]; \
+            map->owners[dense] = map->owners[last]; \
+            map->slots[map->owners[dense]].index = dense; \
+        } \
+        map->values->length -= 1; \
+        slot->generation += 1; \
+        /* A slot whose generation wrapped around is retired, so that its old handles stay invalid */ \
+        if (slot->generation != 0) { \
+            slot->index = map->free_head; \
+            map->free_head = index; \
+        } \
+        return true; \
+    } \
+    void type##_slotmap_clear(SLOTMAP(type)* map) { \
+        if (map == NULL) return; \
+        for (size_t n = 0; n < map->values->length; n++) { \
+            uint32_t index = map->owners[n]; \
+            map->slots[index].generation += 1; \
+            if (map->slots[index].generation != 0) { \
+                map->slots[index].index = map->free_head; \
+                map->free_head = index; \
+            } \
+        } \
+        map->values->length = 0; \
+    } \
+    type* type##_slotmap_values(SLOTMAP(type)* map) { \
+        if (map == NULL) return NULL; \
+        return map->values->data; \
+    } \
+    uint64_t type##_slotmap_handle_at(const SLOTMAP(type)* map, size_t index) { \
+        if (map == NULL || index >= map->values->length) return SLOTMAP_NULL; \
+        uint32_t slot = map->owners[index]; \
+        return SLOTMAP_HANDLE(slot, map->slots[slot].generation); \
+    }
+
+/** @struct TYPE_slotmap
+
+    A slot map of values of type `TYPE`: `values` holds the values, packed, and `owners[n]` is the slot of `values->data[n]`.
+    Each slot has a generation, which is odd while the slot holds a value and even while it is vacant, and an index:
+    the position of its value in `values` if it is occupied, or the next vacant slot of the freelist (starting at `free_head`) otherwise.
+    A handle is a slot index and the generation the slot had when the value was inserted; removing the value bumps the generation, so the handle no longer matches.
+**/
+
+/** @typedef TYPE_slotmap_t
+
+    Resolves to `struct TYPE_slotmap`; can also be accessed with `SLOTMAP(TYPE)`.
+**/
+
+/** @fn TYPE_slotmap_new(size_t capacity)
+    @param capacity The number of values to make room for; the map grows past it as needed
+    @returns A new, empty slot map, or NULL on allocation failure
+**/
+
+/** @fn TYPE_slotmap_free(SLOTMAP(TYPE)* map)
+    @param map The slot map to free
+
+    Frees the map and its values; every handle becomes invalid.
+**/
+
+/** @fn TYPE_slotmap_length(const SLOTMAP(TYPE)* map)
+    @returns The number of values in the map
+**/
+
+/** @fn TYPE_slotmap_insert(SLOTMAP(TYPE)* map, TYPE value)
+    @param value The value to insert
+    @returns The handle of the new value, or `SLOTMAP_NULL` if the map could not grow
+
+    Appends `value` to the packed values, and reuses the most recently vacated slot if there is one; `O(1)` amortized.
+**/
+
+/** @fn TYPE_slotmap_get(SLOTMAP(TYPE)* map, uint64_t handle)
+    @returns A pointer to the value of `handle`, or NULL if that value was removed; the pointer is invalidated by the next insertion or removal
+
+    `O(1)`: a single lookup in the slot array, then in the packed values.
+**/
+
+/** @fn TYPE_slotmap_contains(const SLOTMAP(TYPE)* map, uint64_t handle)
+    @returns Whether the value of `handle` is still in the map
+**/
+
+/** @fn TYPE_slotmap_remove(SLOTMAP(TYPE)* map, uint64_t handle, TYPE* out)
+    @param handle The handle of the value to remove
+    @param out If not NULL, where to write the removed value
+    @returns true, or false if `handle` does not refer to a value of the map
+
+    The last of the packed values is moved into the hole, so that the values stay packed; `O(1)`.
+    This changes the order of `TYPE_slotmap_values`, but not the handles.
+**/
+
+/** @fn TYPE_slotmap_clear(SLOTMAP(TYPE)* map)
+
+    Removes every value from the map, invalidating their handles; the memory is kept.
+**/
+
+/** @fn TYPE_slotmap_values(SLOTMAP(TYPE)* map)
+    @returns The packed values of the map, `TYPE_slotmap_length(map)` of them, in no particular order
+
+    Iterating over this array is as cache-friendly as iterating over a `VEC(TYPE)`; it is invalidated by the next insertion or removal.
+**/
+
+/** @fn TYPE_slotmap_handle_at(const SLOTMAP(TYPE)* map, size_t index)
+    @param index An index into `TYPE_slotmap_values(map)`
+    @returns The handle of the value at `index`, or `SLOTMAP_NULL` if `index` is out of bounds
+**/
+
+#endif // SLOTMAP_H
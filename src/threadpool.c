@@ -0,0 +1,149 @@
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "threadpool.h"
+
+struct lists_pool_task {
+    void (*function)(void*);
+    void* data;
+    struct lists_pool_group* group;
+    struct lists_pool_task* next;
+};
+
+// Everything below is protected by lists_pool_mutex; lists_pool_changed is broadcast whenever a task is queued or a group is done
+static pthread_mutex_t lists_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t lists_pool_changed = PTHREAD_COND_INITIALIZER;
+static struct lists_pool_task* lists_pool_queue = NULL;
+static pthread_t* lists_pool_workers = NULL;
+static size_t lists_pool_worker_count = 0;
+static size_t lists_pool_size = 0;
+static bool lists_pool_started = false;
+static bool lists_pool_stopping = false;
+
+static size_t lists_pool_size_locked(void) {
+    if (lists_pool_size == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        lists_pool_size = cpus > 0 ? (size_t)cpus : 1;
+    }
+    return lists_pool_size;
+}
+
+// Pops the most recently queued task, which is the most likely to still be in cache
+static struct lists_pool_task* lists_pool_pop_locked(void) {
+    struct lists_pool_task* task = lists_pool_queue;
+    if (task != NULL) lists_pool_queue = task->next;
+    return task;
+}
+
+static void lists_pool_run(struct lists_pool_task* task) {
+    struct lists_pool_group* group = task->group;
+    task->function(task->data);
+    free(task);
+    if (atomic_fetch_sub(&group->pending, 1) == 1) {
+        pthread_mutex_lock(&lists_pool_mutex);
+        pthread_cond_broadcast(&lists_pool_changed);
+        pthread_mutex_unlock(&lists_pool_mutex);
+    }
+}
+
+static void* lists_pool_worker(void* unused) {
+    (void)unused;
+    pthread_mutex_lock(&lists_pool_mutex);
+    while (true) {
+        struct lists_pool_task* task = lists_pool_pop_locked();
+        if (task != NULL) {
+            pthread_mutex_unlock(&lists_pool_mutex);
+            lists_pool_run(task);
+            pthread_mutex_lock(&lists_pool_mutex);
+        } else if (lists_pool_stopping) {
+            break;
+        } else {
+            pthread_cond_wait(&lists_pool_changed, &lists_pool_mutex);
+        }
+    }
+    pthread_mutex_unlock(&lists_pool_mutex);
+    return NULL;
+}
+
+static void lists_pool_start_locked(void) {
+    lists_pool_started = true;
+    size_t workers = lists_pool_size_locked() - 1;
+    if (workers == 0) return;
+    lists_pool_workers = (pthread_t*)malloc(sizeof(pthread_t) * workers);
+    if (lists_pool_workers == NULL) return;
+    for (lists_pool_worker_count = 0; lists_pool_worker_count < workers; lists_pool_worker_count++) {
+        if (pthread_create(&lists_pool_workers[lists_pool_worker_count], NULL, lists_pool_worker, NULL) != 0) break;
+    }
+}
+
+void lists_pool_set_threads(size_t threads) {
+    pthread_mutex_lock(&lists_pool_mutex);
+    lists_pool_stopping = true;
+    pthread_cond_broadcast(&lists_pool_changed);
+    pthread_mutex_unlock(&lists_pool_mutex);
+
+    for (size_t n = 0; n < lists_pool_worker_count; n++) pthread_join(lists_pool_workers[n], NULL);
+
+    pthread_mutex_lock(&lists_pool_mutex);
+    free(lists_pool_workers);
+    lists_pool_workers = NULL;
+    lists_pool_worker_count = 0;
+    lists_pool_started = false;
+    lists_pool_stopping = false;
+    lists_pool_size = threads;
+    pthread_mutex_unlock(&lists_pool_mutex);
+}
+
+size_t lists_pool_threads(void) {
+    pthread_mutex_lock(&lists_pool_mutex);
+    size_t res = lists_pool_size_locked();
+    pthread_mutex_unlock(&lists_pool_mutex);
+    return res;
+}
+
+size_t lists_pool_split_depth(void) {
+    size_t threads = lists_pool_threads();
+    if (threads <= 1) return 0;
+    size_t depth = 0;
+    while (((size_t)1 << depth) < threads) depth++;
+    return depth + 3;
+}
+
+void lists_pool_spawn(struct lists_pool_group* group, void (*task)(void*), void* data) {
+    struct lists_pool_task* node = (struct lists_pool_task*)malloc(sizeof(struct lists_pool_task));
+    if (node == NULL) {
+        task(data);
+        return;
+    }
+    node->function = task;
+    node->data = data;
+    node->group = group;
+
+    pthread_mutex_lock(&lists_pool_mutex);
+    if (!lists_pool_started) lists_pool_start_locked();
+    if (lists_pool_worker_count == 0) {
+        pthread_mutex_unlock(&lists_pool_mutex);
+        free(node);
+        task(data);
+        return;
+    }
+    atomic_fetch_add(&group->pending, 1);
+    node->next = lists_pool_queue;
+    lists_pool_queue = node;
+    pthread_cond_broadcast(&lists_pool_changed);
+    pthread_mutex_unlock(&lists_pool_mutex);
+}
+
+void lists_pool_wait(struct lists_pool_group* group) {
+    while (atomic_load(&group->pending) > 0) {
+        pthread_mutex_lock(&lists_pool_mutex);
+        struct lists_pool_task* task = lists_pool_pop_locked();
+        if (task == NULL) {
+            if (atomic_load(&group->pending) > 0) pthread_cond_wait(&lists_pool_changed, &lists_pool_mutex);
+            pthread_mutex_unlock(&lists_pool_mutex);
+        } else {
+            pthread_mutex_unlock(&lists_pool_mutex);
+            lists_pool_run(task);
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/** @struct lists_pool_group
+
+    A set of tasks that can be waited upon together; it must be initialized with `LISTS_POOL_GROUP_INIT`.
+    A group is typically a local variable of the function that spawns the tasks, and that function must call `lists_pool_wait` before returning.
+**/
+struct lists_pool_group {
+    atomic_size_t pending;
+};
+
+#define LISTS_POOL_GROUP_INIT {0}
+
+/** @fn lists_pool_set_threads(size_t threads)
+    @param threads The number of threads that may work at the same time, including the thread that waits for the tasks; 0 picks the number of online CPUs
+
+    Sets the size of the built-in thread pool, stopping its worker threads if they were running; they are started again on the next spawned task.
+    With a single thread, tasks are run as soon as they are spawned.
+    Must not be called while tasks are pending.
+**/
+void lists_pool_set_threads(size_t threads);
+
+/** @fn lists_pool_threads()
+    @returns The number of threads that may work at the same time, including the waiting thread
+**/
+size_t lists_pool_threads(void);
+
+/** @fn lists_pool_split_depth()
+    @returns How many levels of a recursive algorithm should spawn tasks, so that each thread gets several tasks to balance the load; 0 if the pool has a single thread
+**/
+size_t lists_pool_split_depth(void);
+
+/** @fn lists_pool_spawn(struct lists_pool_group* group, void (*task)(void*), void* data)
+    @param group The group the task belongs to
+    @param task The function to run
+    @param data The argument given to `task`; it must stay valid until `lists_pool_wait(group)` returns
+
+    Queues `task` on the thread pool, starting the pool if needed.
+    The task is run right away on the calling thread if the pool has a single thread or if the task could not be queued.
+**/
+void lists_pool_spawn(struct lists_pool_group* group, void (*task)(void*), void* data);
+
+/** @fn lists_pool_wait(struct lists_pool_group* group)
+    @param group The group to wait for
+
+    Waits until every task of `group` has finished.
+    The calling thread runs queued tasks meanwhile, so that tasks may themselves spawn and wait for other tasks without exhausting the pool.
+**/
+void lists_pool_wait(struct lists_pool_group* group);
+
+#endif // THREADPOOL_H
@@ -4,9 +4,16 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 
 #define VEC(type) type##_vec_t
 
+#if defined(__GNUC__) || defined(__clang__)
+#define VEC_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define VEC_PREFETCH(address) ((void)(address))
+#endif
+
 /** @def DECL_VEC(type)
     @param type The type of the vector
 
@@ -166,6 +173,283 @@
 #define DEF_VEC_PRINTF(type, printf_format) \
     DEF_VEC_PRINTF_CUSTOM(type, printf(printf_format, value))
 
+/**
+    @def DECL_VEC_EYTZINGER(type)
+    @param type The type of the vector
+
+    Declares the functions that build and search vectors in Eytzinger layout, ie. implicit binary search trees stored breadth-first.
+    This macro requires `DECL_VEC(type)` to have been called beforehand.
+**/
+#define DECL_VEC_EYTZINGER(type) \
+    VEC(type)* type##_vec_build_eytzinger(const VEC(type)* sorted); \
+    size_t type##_vec_eytzinger_lower_bound(const VEC(type)* eytzinger, type value);
+
+/**
+    @def DEF_VEC_EYTZINGER(type, cmp)
+    @param type The type of the vector
+    @param cmp A function or macro taking two values `a` and `b` and returning a negative value if `a < b`, a positive value if `a > b` and 0 if they are equal
+
+    Defines the functions declared by `DECL_VEC_EYTZINGER(type)`.
+    Requires `DECL_VEC(type)`, `DEF_VEC(type)` and `DECL_VEC_EYTZINGER(type)` to have been called beforehand.
+**/
+#define DEF_VEC_EYTZINGER(type, cmp) \
+    /* Writes sorted[i...] into the subtree rooted at the (1-based) position k, in order */ \
+    static size_t type##_vec_eytzinger_fill(const type* sorted, type* eytzinger, size_t length, size_t i, size_t k) { \
+        if (k <= length) { \
+            i = type##_vec_eytzinger_fill(sorted, eytzinger, length, i, 2 * k); \
+            eytzinger[k - 1] = sorted[i++]; \
+            i = type##_vec_eytzinger_fill(sorted, eytzinger, length, i, 2 * k + 1); \
+        } \
+        return i; \
+    } \
+    VEC(type)* type##_vec_build_eytzinger(const VEC(type)* sorted) { \
+        if (sorted == NULL) return NULL; \
+        VEC(type)* res = type##_vec_new(sorted->length > 0 ? sorted->length : 1); \
+        if (res == NULL) return NULL; \
+        type##_vec_eytzinger_fill(sorted->data, res->data, sorted->length, 0, 1); \
+        res->length = sorted->length; \
+        return res; \
+    } \
+    size_t type##_vec_eytzinger_lower_bound(const VEC(type)* eytzinger, type value) { \
+        if (eytzinger == NULL) return 0; \
+        const type* data = eytzinger->data; \
+        const size_t length = eytzinger->length; \
+        /* The 16 descendants of k that are four levels below it are contiguous: fetch them while the next levels are resolved */ \
+        const size_t stride = 16; \
+        size_t k = 1; \
+        while (k <= length) { \
+            VEC_PREFETCH(data + k * stride - 1); \
+            k = 2 * k + (cmp(data[k - 1], value) < 0); \
+        } \
+        /* k now encodes the path taken; the answer is the last node where the search went left */ \
+        while (k & 1) k >>= 1; \
+        k >>= 1; \
+        return k == 0 ? length : k - 1; \
+    }
+
+/// How many values in a row the set operations of `DEF_VEC_SORTED` step over before they start galloping
+#ifndef VEC_SORTED_MIN_GALLOP
+#define VEC_SORTED_MIN_GALLOP 8
+#endif
+
+/**
+    @def DECL_VEC_SORTED(type)
+    @param type The type of the vector
+
+    Declares the functions that search, insert into and combine vectors sorted in increasing order.
+    This macro requires `DECL_VEC(type)` to have been called beforehand.
+**/
+#define DECL_VEC_SORTED(type) \
+    size_t type##_vec_lower_bound(const VEC(type)* vec, type value); \
+    size_t type##_vec_upper_bound(const VEC(type)* vec, type value); \
+    void type##_vec_equal_range(const VEC(type)* vec, type value, size_t* begin, size_t* end); \
+    size_t type##_vec_binary_search(const VEC(type)* vec, type value); \
+    size_t type##_vec_insert_sorted(VEC(type)* vec, type value); \
+    size_t type##_vec_merge(const VEC(type)* a, const VEC(type)* b, VEC(type)* dest); \
+    size_t type##_vec_union(const VEC(type)* a, const VEC(type)* b, VEC(type)* dest); \
+    size_t type##_vec_intersection(const VEC(type)* a, const VEC(type)* b, VEC(type)* dest); \
+    size_t type##_vec_difference(const VEC(type)* a, const VEC(type)* b, VEC(type)* dest);
+
+/**
+    @def DEF_VEC_SORTED(type, cmp)
+    @param type The type of the vector
+    @param cmp A function or macro taking two values `a` and `b` and returning a negative value if `a < b`, a positive value if `a > b` and 0 if they are equal
+
+    Defines the functions declared by `DECL_VEC_SORTED(type)`.
+    Requires `DECL_VEC(type)`, `DEF_VEC(type)` and `DECL_VEC_SORTED(type)` to have been called beforehand.
+**/
+#define DEF_VEC_SORTED(type, cmp) \
+    /* Returns the index of the first value of data[0 .. length] for which `cmp(x, value) < strict` does not hold: the lower bound if strict = 0, the upper bound if strict = 1 */ \
+    static size_t type##_vec_sorted_search(const type* data, size_t length, type value, int strict) { \
+        if (length == 0) return 0; \
+        const type* base = data; \
+        /* The answer lies in [base, base + length]; the loop only ever moves base, which compilers turn into a conditional move */ \
+        while (length > 1) { \
+            size_t half = length / 2; \
+            /* Without a branch to speculate on, both of the next probes are fetched ahead of time */ \
+            size_t next = (length - half) / 2; \
+            VEC_PREFETCH(base + next); \
+            VEC_PREFETCH(base + half + next); \
+            base += (cmp(base[half - 1], value) < strict) ? half : 0; \
+            length -= half; \
+        } \
+        return (size_t)(base - data) + (cmp(*base, value) < strict); \
+    } \
+    /* Like type##_vec_sorted_search on data[start .. end], probing 1, 2, 4... values ahead first: cheap when the answer is close to `start` */ \
+    static size_t type##_vec_sorted_gallop(const type* data, size_t start, size_t end, type value, int strict) { \
+        size_t bound = 1; \
+        while (start + bound <= end && cmp(data[start + bound - 1], value) < strict) bound *= 2; \
+        size_t low = start + bound / 2; \
+        size_t high = start + bound - 1 < end ? start + bound - 1 : end; \
+        return low + type##_vec_sorted_search(data + low, high - low, value, strict); \
+    } \
+    /* Makes room for `count` more values in `dest` */ \
+    static bool type##_vec_sorted_reserve(VEC(type)* dest, size_t count) { \
+        if (dest->capacity - dest->length >= count) return true; \
+        return type##_vec_resize(dest, dest->length + count) != 0; \
+    } \
+    static void type##_vec_sorted_append(VEC(type)* dest, const type* values, size_t count) { \
+        if (count == 0) return; \
+        memcpy(dest->data + dest->length, values, sizeof(type) * count); \
+        dest->length += count; \
+    } \
+    size_t type##_vec_lower_bound(const VEC(type)* vec, type value) { \
+        if (vec == NULL) return 0; \
+        return type##_vec_sorted_search(vec->data, vec->length, value, 0); \
+    } \
+    size_t type##_vec_upper_bound(const VEC(type)* vec, type value) { \
+        if (vec == NULL) return 0; \
+        return type##_vec_sorted_search(vec->data, vec->length, value, 1); \
+    } \
+    void type##_vec_equal_range(const VEC(type)* vec, type value, size_t* begin, size_t* end) { \
+        *begin = type##_vec_lower_bound(vec, value); \
+        *end = *begin + (vec == NULL ? 0 : type##_vec_sorted_search(vec->data + *begin, vec->length - *begin, value, 1)); \
+    } \
+    size_t type##_vec_binary_search(const VEC(type)* vec, type value) { \
+        size_t res = type##_vec_lower_bound(vec, value); \
+        if (res < type##_vec_length(vec) && cmp(vec->data[res], value) == 0) return res; \
+        return type##_vec_length(vec); \
+    } \
+    size_t type##_vec_insert_sorted(VEC(type)* vec, type value) { \
+        if (vec == NULL) return 0; \
+        if (vec->length == vec->capacity) { \
+            if (type##_vec_resize(vec, vec->capacity * 2) == 0) return 0; \
+        } \
+        size_t index = type##_vec_upper_bound(vec, value); \
+        memmove(vec->data + index + 1, vec->data + index, sizeof(type) * (vec->length - index)); \
+        vec->data[index] = value; \
+        vec->length += 1; \
+        return vec->length; \
+    } \
+    /* The loops below step through `a` and `b` one value at a time; once one of them has been stepped through VEC_SORTED_MIN_GALLOP times in a row, */ \
+    /* the rest of its run is skipped over by galloping */ \
+    size_t type##_vec_merge(const VEC(type)* a, const VEC(type)* b, VEC(type)* dest) { \
+        if (a == NULL || b == NULL || dest == NULL) return 0; \
+        if (!type##_vec_sorted_reserve(dest, a->length + b->length)) return 0; \
+        size_t length = dest->length; \
+        size_t i = 0, j = 0, run_a = 0, run_b = 0; \
+        while (i < a->length && j < b->length) { \
+            if (cmp(b->data[j], a->data[i]) < 0) { \
+                dest->data[dest->length++] = b->data[j++]; \
+                run_a = 0; \
+                if (++run_b >= VEC_SORTED_MIN_GALLOP && j < b->length) { \
+                    size_t next = type##_vec_sorted_gallop(b->data, j, b->length, a->data[i], 0); \
+                    type##_vec_sorted_append(dest, b->data + j, next - j); \
+                    j = next; \
+                    run_b = 0; \
+                } \
+            } else { \
+                dest->data[dest->length++] = a->data[i++]; \
+                run_b = 0; \
+                if (++run_a >= VEC_SORTED_MIN_GALLOP && i < a->length) { \
+                    size_t next = type##_vec_sorted_gallop(a->data, i, a->length, b->data[j], 1); \
+                    type##_vec_sorted_append(dest, a->data + i, next - i); \
+                    i = next; \
+                    run_a = 0; \
+                } \
+            } \
+        } \
+        type##_vec_sorted_append(dest, a->data + i, a->length - i); \
+        type##_vec_sorted_append(dest, b->data + j, b->length - j); \
+        return dest->length - length; \
+    } \
+    size_t type##_vec_union(const VEC(type)* a, const VEC(type)* b, VEC(type)* dest) { \
+        if (a == NULL || b == NULL || dest == NULL) return 0; \
+        if (!type##_vec_sorted_reserve(dest, a->length + b->length)) return 0; \
+        size_t length = dest->length; \
+        size_t i = 0, j = 0, run_a = 0, run_b = 0; \
+        while (i < a->length && j < b->length) { \
+            int order = cmp(a->data[i], b->data[j]); \
+            if (order < 0) { \
+                dest->data[dest->length++] = a->data[i++]; \
+                run_b = 0; \
+                if (++run_a >= VEC_SORTED_MIN_GALLOP && i < a->length) { \
+                    size_t next = type##_vec_sorted_gallop(a->data, i, a->length, b->data[j], 0); \
+                    type##_vec_sorted_append(dest, a->data + i, next - i); \
+                    i = next; \
+                    run_a = 0; \
+                } \
+            } else if (order > 0) { \
+                dest->data[dest->length++] = b->data[j++]; \
+                run_a = 0; \
+                if (++run_b >= VEC_SORTED_MIN_GALLOP && j < b->length) { \
+                    size_t next = type##_vec_sorted_gallop(b->data, j, b->length, a->data[i], 0); \
+                    type##_vec_sorted_append(dest, b->data + j, next - j); \
+                    j = next; \
+                    run_b = 0; \
+                } \
+            } else { \
+                dest->data[dest->length++] = a->data[i++]; \
+                j++; \
+                run_a = run_b = 0; \
+            } \
+        } \
+        type##_vec_sorted_append(dest, a->data + i, a->length - i); \
+        type##_vec_sorted_append(dest, b->data + j, b->length - j); \
+        return dest->length - length; \
+    } \
+    size_t type##_vec_intersection(const VEC(type)* a, const VEC(type)* b, VEC(type)* dest) { \
+        if (a == NULL || b == NULL || dest == NULL) return 0; \
+        if (!type##_vec_sorted_reserve(dest, a->length < b->length ? a->length : b->length)) return 0; \
+        size_t length = dest->length; \
+        size_t i = 0, j = 0, run_a = 0, run_b = 0; \
+        while (i < a->length && j < b->length) { \
+            int order = cmp(a->data[i], b->data[j]); \
+            if (order < 0) { \
+                i++; \
+                run_b = 0; \
+                if (++run_a >= VEC_SORTED_MIN_GALLOP && i < a->length) { \
+                    i = type##_vec_sorted_gallop(a->data, i, a->length, b->data[j], 0); \
+                    run_a = 0; \
+                } \
+            } else if (order > 0) { \
+                j++; \
+                run_a = 0; \
+                if (++run_b >= VEC_SORTED_MIN_GALLOP && j < b->length) { \
+                    j = type##_vec_sorted_gallop(b->data, j, b->length, a->data[i], 0); \
+                    run_b = 0; \
+                } \
+            } else { \
+                dest->data[dest->length++] = a->data[i++]; \
+                j++; \
+                run_a = run_b = 0; \
+            } \
+        } \
+        return dest->length - length; \
+    } \
+    size_t type##_vec_difference(const VEC(type)* a, const VEC(type)* b, VEC(type)* dest) { \
+        if (a == NULL || b == NULL || dest == NULL) return 0; \
+        if (!type##_vec_sorted_reserve(dest, a->length)) return 0; \
+        size_t length = dest->length; \
+        size_t i = 0, j = 0, run_a = 0, run_b = 0; \
+        while (i < a->length && j < b->length) { \
+            int order = cmp(a->data[i], b->data[j]); \
+            if (order < 0) { \
+                dest->data[dest->length++] = a->data[i++]; \
+                run_b = 0; \
+                if (++run_a >= VEC_SORTED_MIN_GALLOP && i < a->length) { \
+                    size_t next = type##_vec_sorted_gallop(a->data, i, a->length, b->data[j], 0); \
+                    type##_vec_sorted_append(dest, a->data + i, next - i); \
+                    i = next; \
+                    run_a = 0; \
+                } \
+            } else if (order > 0) { \
+                j++; \
+                run_a = 0; \
+                if (++run_b >= VEC_SORTED_MIN_GALLOP && j < b->length) { \
+                    j = type##_vec_sorted_gallop(b->data, j, b->length, a->data[i], 0); \
+                    run_b = 0; \
+                } \
+            } else { \
+                i++; \
+                j++; \
+                run_a = run_b = 0; \
+            } \
+        } \
+        type##_vec_sorted_append(dest, a->data + i, a->length - i); \
+        return dest->length - length; \
+    }
+
 /** @struct TYPE_vec
 
     A scalable array or "vector" with values of type `TYPE`
@@ -278,4 +562,95 @@
     ```
 **/
 
+/** @fn TYPE_vec_build_eytzinger(const VEC(TYPE)* sorted)
+    @param sorted A vector sorted in increasing order
+    @returns A new vector holding the same values in Eytzinger layout, or NULL on allocation failure
+
+    In Eytzinger layout, the value at index `k - 1` has its children at indices `2k - 1` and `2k`: the vector is a complete binary search tree stored breadth-first, without any pointer.
+    The first levels of the tree are packed together at the start of the vector and stay in cache, and the descendants of a node are close to each other.
+    The returned vector is meant to be searched with `TYPE_vec_eytzinger_lower_bound`, and must not be modified.
+
+    **Note:** only available if `DECL_VEC_EYTZINGER(TYPE)` and `DEF_VEC_EYTZINGER(TYPE, cmp)` have been called.
+**/
+
+/** @fn TYPE_vec_eytzinger_lower_bound(const VEC(TYPE)* eytzinger, TYPE value)
+    @param eytzinger A vector returned by `TYPE_vec_build_eytzinger`
+    @param value The value to look for
+    @returns The index in `eytzinger` of the smallest value that is greater than or equal to `value`, or the length of `eytzinger` if there is none
+
+    Searches an Eytzinger-layout vector in `O(log n)`.
+    The loop does not branch on the comparisons, and prefetches the nodes four levels below the current one.
+
+    **Note:** only available if `DECL_VEC_EYTZINGER(TYPE)` and `DEF_VEC_EYTZINGER(TYPE, cmp)` have been called.
+**/
+
+/** @fn TYPE_vec_lower_bound(const VEC(TYPE)* vec, TYPE value)
+    @param vec A vector sorted in increasing order
+    @returns The index of the first value that is greater than or equal to `value`, or the length of `vec` if there is none
+
+    A binary search in `O(log n)`, whose loop does not branch on the comparisons.
+
+    **Note:** only available if `DECL_VEC_SORTED(TYPE)` and `DEF_VEC_SORTED(TYPE, cmp)` have been called; the same goes for the functions below.
+**/
+
+/** @fn TYPE_vec_upper_bound(const VEC(TYPE)* vec, TYPE value)
+    @param vec A vector sorted in increasing order
+    @returns The index of the first value that is strictly greater than `value`, or the length of `vec` if there is none
+**/
+
+/** @fn TYPE_vec_equal_range(const VEC(TYPE)* vec, TYPE value, size_t* begin, size_t* end)
+    @param vec A vector sorted in increasing order
+    @param begin Where to write the lower bound of `value`
+    @param end Where to write the upper bound of `value`
+
+    The values equal to `value` are those at the indices `[*begin, *end)`.
+**/
+
+/** @fn TYPE_vec_binary_search(const VEC(TYPE)* vec, TYPE value)
+    @param vec A vector sorted in increasing order
+    @returns The index of the first value equal to `value`, or the length of `vec` if there is none
+
+    The `O(log n)` counterpart of `TYPE_vec_find` for sorted vectors.
+**/
+
+/** @fn TYPE_vec_insert_sorted(VEC(TYPE)* vec, TYPE value)
+    @param vec A vector sorted in increasing order
+    @returns The new length, or 0 if the vector could not grow
+
+    Inserts `value` after the values equal to it, keeping `vec` sorted; the values after it are moved, in `O(n)`.
+**/
+
+/** @fn TYPE_vec_merge(const VEC(TYPE)* a, const VEC(TYPE)* b, VEC(TYPE)* dest)
+    @param a A vector sorted in increasing order
+    @param b A vector sorted in increasing order
+    @param dest The vector to append the result to; it must be neither `a` nor `b`
+    @returns The number of values appended to `dest`, or 0 if it could not grow
+
+    Appends all of the values of `a` and `b` to `dest`, in increasing order; values of `a` go before the values of `b` that are equal to them.
+    Once `VEC_SORTED_MIN_GALLOP` values in a row have come from the same vector, the rest of that run is found by galloping (exponential search) and copied at once,
+    so that merging vectors that barely overlap takes `O(log n)` comparisons.
+
+    `dest` grows once, before anything is written; the same goes for the set operations below.
+**/
+
+/** @fn TYPE_vec_union(const VEC(TYPE)* a, const VEC(TYPE)* b, VEC(TYPE)* dest)
+    @returns The number of values appended to `dest`, or 0 if it could not grow
+
+    Appends the values that are in `a` or in `b` to `dest`, in increasing order.
+    A value that is `n` times in `a` and `m` times in `b` is appended `max(n, m)` times.
+**/
+
+/** @fn TYPE_vec_intersection(const VEC(TYPE)* a, const VEC(TYPE)* b, VEC(TYPE)* dest)
+    @returns The number of values appended to `dest`, or 0 if it could not grow
+
+    Appends the values that are both in `a` and in `b` to `dest`, in increasing order; a value is appended `min(n, m)` times.
+    Galloping over the values that are missing from the other vector makes intersecting `k` values with `n` values take about `O(k log(n / k))` comparisons when `k` is much smaller than `n`.
+**/
+
+/** @fn TYPE_vec_difference(const VEC(TYPE)* a, const VEC(TYPE)* b, VEC(TYPE)* dest)
+    @returns The number of values appended to `dest`, or 0 if it could not grow
+
+    Appends the values of `a` that are not in `b` to `dest`, in increasing order; a value is appended `max(n - m, 0)` times.
+**/
+
 #endif // VEC_H
@@ -0,0 +1,228 @@
+#ifndef VEC_PAR_H
+#define VEC_PAR_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "vec.h"
+#include "threadpool.h"
+
+/// Vectors shorter than this are processed on the calling thread, as spawning tasks would cost more than it saves
+#ifndef VEC_PAR_THRESHOLD
+#define VEC_PAR_THRESHOLD 16384
+#endif
+
+/// The size of a cache line; chunks start on cache line boundaries, so that two threads never write to the same line
+#ifndef VEC_PAR_CACHE_LINE
+#define VEC_PAR_CACHE_LINE 64
+#endif
+
+/// The number of chunks given to each thread, so that a slow thread does not hold the others back
+#define VEC_PAR_CHUNKS_PER_THREAD 4
+
+/** @struct vec_par_chunks
+
+    How a vector is cut into chunks: the first chunk ends at `head + length`, and the next chunks are `length` values long.
+**/
+struct vec_par_chunks {
+    size_t head;
+    size_t length;
+    size_t count;
+};
+
+/* Plans the chunks of an array of `length` values of `size` bytes starting at `data`, for `threads` threads */
+static inline struct vec_par_chunks vec_par_plan(const void* data, size_t length, size_t size, size_t threads) {
+    struct vec_par_chunks res;
+    size_t line = size < VEC_PAR_CACHE_LINE ? VEC_PAR_CACHE_LINE / size : 1;
+    // The number of values before the first cache line boundary; it is only exact if `size` divides the cache line size
+    size_t misalignment = (uintptr_t)data % VEC_PAR_CACHE_LINE;
+    res.head = misalignment == 0 ? 0 : ((VEC_PAR_CACHE_LINE - misalignment) / size) % line;
+    size_t chunks = threads * VEC_PAR_CHUNKS_PER_THREAD;
+    res.length = (length + chunks - 1) / chunks;
+    res.length = (res.length + line - 1) / line * line;
+    res.count = length <= res.head ? 1 : (length - res.head + res.length - 1) / res.length;
+    return res;
+}
+
+/* Returns the start of the chunk `index` of a plan, clipped to `length` */
+static inline size_t vec_par_chunk_start(const struct vec_par_chunks* plan, size_t index, size_t length) {
+    size_t res = index == 0 ? 0 : plan->head + index * plan->length;
+    return res < length ? res : length;
+}
+
+/** @def DECL_VEC_PAR(type)
+    @param type The type of the vector
+
+    Declares the parallel operations on `VEC(type)`, which run on the built-in thread pool (see `threadpool.h`).
+    This macro requires `DECL_VEC(type)` to have been called beforehand.
+**/
+#define DECL_VEC_PAR(type) \
+    void type##_vec_par_for_each(VEC(type)* vec, void (*callback)(type*, void*), void* callback_data); \
+    type type##_vec_par_reduce(const VEC(type)* vec, type identity, type (*combine)(type, type)); \
+    size_t type##_vec_par_filter_into(const VEC(type)* vec, VEC(type)* dest, bool (*predicate)(const type*, const void*), const void* predicate_data);
+
+/** @def DEF_VEC_PAR(type)
+    @param type The type of the vector
+
+    Defines the functions declared by `DECL_VEC_PAR(type)`.
+    Requires `DECL_VEC(type)`, `DEF_VEC(type)` and `DECL_VEC_PAR(type)` to have been called beforehand.
+
+    The vector is cut into `VEC_PAR_CHUNKS_PER_THREAD` chunks per thread of the pool, which start on cache line boundaries;
+    each chunk is a task, and the calling thread waits for all of them.
+**/
+#define DEF_VEC_PAR(type) \
+    /* Each task lies on its own cache lines, so that storing the result of a task never invalidates the line of another */ \
+    struct type##_vec_par_task { \
+        _Alignas(VEC_PAR_CACHE_LINE) type* data; \
+        size_t start; \
+        size_t end; \
+        void (*callback)(type*, void*); \
+        void* callback_data; \
+        type (*combine)(type, type); \
+        type result; \
+        bool (*predicate)(const type*, const void*); \
+        const void* predicate_data; \
+        type* dest; \
+        size_t count; \
+    }; \
+    /* Runs `function` on each chunk of `data`, with tasks copied from `prototype`; returns NULL if the tasks could not be allocated, or the tasks, which must be freed */ \
+    /* The chunks start on the cache line boundaries of `written`, the array that the tasks write to */ \
+    static struct type##_vec_par_task* type##_vec_par_run(type* data, size_t length, const type* written, const struct type##_vec_par_task* prototype, void (*function)(void*), size_t* count) { \
+        struct vec_par_chunks plan = vec_par_plan(written, length, sizeof(type), lists_pool_threads()); \
+        /* sizeof is a multiple of the alignment, as aligned_alloc requires */ \
+        struct type##_vec_par_task* tasks = (struct type##_vec_par_task*)aligned_alloc(VEC_PAR_CACHE_LINE, sizeof(struct type##_vec_par_task) * plan.count); \
+        if (tasks == NULL) return NULL; \
+        struct lists_pool_group group = LISTS_POOL_GROUP_INIT; \
+        for (size_t n = 0; n < plan.count; n++) { \
+            tasks[n] = *prototype; \
+            tasks[n].data = data; \
+            tasks[n].start = vec_par_chunk_start(&plan, n, length); \
+            tasks[n].end = vec_par_chunk_start(&plan, n + 1, length); \
+            lists_pool_spawn(&group, function, &tasks[n]); \
+        } \
+        lists_pool_wait(&group); \
+        *count = plan.count; \
+        return tasks; \
+    } \
+    static void type##_vec_par_for_each_task(void* data) { \
+        struct type##_vec_par_task* task = (struct type##_vec_par_task*)data; \
+        for (size_t n = task->start; n < task->end; n++) task->callback(&task->data[n], task->callback_data); \
+    } \
+    void type##_vec_par_for_each(VEC(type)* vec, void (*callback)(type*, void*), void* callback_data) { \
+        if (vec == NULL) return; \
+        struct type##_vec_par_task prototype = {.callback = callback, .callback_data = callback_data}; \
+        struct type##_vec_par_task* tasks = NULL; \
+        size_t count; \
+        if (vec->length >= VEC_PAR_THRESHOLD && lists_pool_threads() > 1) { \
+            tasks = type##_vec_par_run(vec->data, vec->length, vec->data, &prototype, type##_vec_par_for_each_task, &count); \
+        } \
+        if (tasks == NULL) { \
+            prototype.data = vec->data; \
+            prototype.start = 0; \
+            prototype.end = vec->length; \
+            type##_vec_par_for_each_task(&prototype); \
+        } \
+        free(tasks); \
+    } \
+    static void type##_vec_par_reduce_task(void* data) { \
+        struct type##_vec_par_task* task = (struct type##_vec_par_task*)data; \
+        /* Accumulates in a local, as `combine` is opaque and would otherwise force a store to the task on every value */ \
+        type result = task->result; \
+        for (size_t n = task->start; n < task->end; n++) result = task->combine(result, task->data[n]); \
+        task->result = result; \
+    } \
+    type type##_vec_par_reduce(const VEC(type)* vec, type identity, type (*combine)(type, type)) { \
+        if (vec == NULL) return identity; \
+        struct type##_vec_par_task prototype = {.combine = combine, .result = identity}; \
+        struct type##_vec_par_task* tasks = NULL; \
+        size_t count; \
+        if (vec->length >= VEC_PAR_THRESHOLD && lists_pool_threads() > 1) { \
+            tasks = type##_vec_par_run(vec->data, vec->length, vec->data, &prototype, type##_vec_par_reduce_task, &count); \
+        } \
+        if (tasks == NULL) { \
+            prototype.data = vec->data; \
+            prototype.start = 0; \
+            prototype.end = vec->length; \
+            type##_vec_par_reduce_task(&prototype); \
+            return prototype.result; \
+        } \
+        /* The partial results are combined in order, so `combine` need not be commutative */ \
+        type res = identity; \
+        for (size_t n = 0; n < count; n++) res = combine(res, tasks[n].result); \
+        free(tasks); \
+        return res; \
+    } \
+    /* Filters the chunk into `dest`, at the same offset as the chunk */ \
+    static void type##_vec_par_filter_task(void* data) { \
+        struct type##_vec_par_task* task = (struct type##_vec_par_task*)data; \
+        type* out = task->dest + task->start; \
+        size_t count = 0; \
+        for (size_t n = task->start; n < task->end; n++) { \
+            if (task->predicate(&task->data[n], task->predicate_data)) out[count++] = task->data[n]; \
+        } \
+        task->count = count; \
+    } \
+    size_t type##_vec_par_filter_into(const VEC(type)* vec, VEC(type)* dest, bool (*predicate)(const type*, const void*), const void* predicate_data) { \
+        if (vec == NULL || dest == NULL) return 0; \
+        /* Each chunk may keep all of its values: make room for the whole vector */ \
+        if (dest->capacity - dest->length < vec->length) { \
+            if (type##_vec_resize(dest, dest->length + vec->length) == 0) return 0; \
+        } \
+        struct type##_vec_par_task prototype = {.predicate = predicate, .predicate_data = predicate_data, .dest = dest->data + dest->length, .count = 0}; \
+        struct type##_vec_par_task* tasks = NULL; \
+        size_t count; \
+        if (vec->length >= VEC_PAR_THRESHOLD && lists_pool_threads() > 1) { \
+            tasks = type##_vec_par_run(vec->data, vec->length, prototype.dest, &prototype, type##_vec_par_filter_task, &count); \
+        } \
+        if (tasks == NULL) { \
+            prototype.data = vec->data; \
+            prototype.start = 0; \
+            prototype.end = vec->length; \
+            type##_vec_par_filter_task(&prototype); \
+            dest->length += prototype.count; \
+            return prototype.count; \
+        } \
+        /* Packs the values kept by each chunk together, in order */ \
+        size_t res = 0; \
+        for (size_t n = 0; n < count; n++) { \
+            if (res != tasks[n].start) { \
+                memmove(dest->data + dest->length + res, dest->data + dest->length + tasks[n].start, sizeof(type) * tasks[n].count); \
+            } \
+            res += tasks[n].count; \
+        } \
+        free(tasks); \
+        dest->length += res; \
+        return res; \
+    }
+
+/** @fn TYPE_vec_par_for_each(VEC(TYPE)* vec, void (*callback)(TYPE*, void*), void* callback_data)
+    @param vec The vector to go through
+    @param callback Called on each value of `vec`, from several threads at once; it may modify the value it is given, but no other value
+    @param callback_data A user-defined void pointer passed to `callback`
+
+    Calls `callback` on every value of `vec`, in no particular order.
+    Vectors shorter than `VEC_PAR_THRESHOLD`, or pools with a single thread, are processed serially, in order.
+**/
+
+/** @fn TYPE_vec_par_reduce(const VEC(TYPE)* vec, TYPE identity, TYPE (*combine)(TYPE, TYPE))
+    @param vec The vector to reduce
+    @param identity The identity of `combine`, ie. `combine(identity, x) == x`; it starts the reduction of each chunk
+    @param combine An associative function, called from several threads at once
+    @returns `combine(...combine(combine(identity, v0), v1)..., vn)`, or `identity` if `vec` is empty or NULL
+
+    Each chunk is reduced by a task, and the results of the chunks are then combined in order.
+**/
+
+/** @fn TYPE_vec_par_filter_into(const VEC(TYPE)* vec, VEC(TYPE)* dest, bool (*predicate)(const TYPE*, const void*), const void* predicate_data)
+    @param vec The vector to filter
+    @param dest The vector to append the values that match `predicate` to, in order; it must not be `vec`
+    @param predicate Called once on each value of `vec`, from several threads at once
+    @param predicate_data A user-defined void pointer passed to `predicate`
+    @returns The number of values appended to `dest`; 0 if `dest` could not grow
+
+    `dest` is first grown so that it can hold all of `vec`: each chunk writes the values it keeps at its own offset, and they are then packed together.
+    The chunks are cut on the cache line boundaries of `dest` rather than `vec`, since `dest` is the array being written to.
+**/
+
+#endif // VEC_PAR_H
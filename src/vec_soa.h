@@ -0,0 +1,241 @@
+#ifndef VEC_SOA_H
+#define VEC_SOA_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#define SOA_VEC(name) name##_soa_t
+#define SOA_VEC_ROW(name) name##_soa_row_t
+
+/// The maximum number of fields of a SOA_VEC
+#define SOA_VEC_MAX_FIELDS 16
+
+/* SOA_VEC_MAP(m, name, (type1, field1), (type2, field2), ...) expands to m(name, type1, field1) m(name, type2, field2) ... */
+#define SOA_VEC_UNPACK(field_type, field) field_type, field
+#define SOA_VEC_CALL(m, args) m args
+#define SOA_VEC_APPLY(m, name, pair) SOA_VEC_CALL(m, (name, SOA_VEC_UNPACK pair))
+#define SOA_VEC_COUNT(...) SOA_VEC_COUNT_(__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define SOA_VEC_COUNT_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, count, ...) count
+#define SOA_VEC_CONCAT(a, b) SOA_VEC_CONCAT_(a, b)
+#define SOA_VEC_CONCAT_(a, b) a##b
+#define SOA_VEC_MAP(m, name, ...) SOA_VEC_CONCAT(SOA_VEC_MAP_, SOA_VEC_COUNT(__VA_ARGS__))(m, name, __VA_ARGS__)
+#define SOA_VEC_MAP_1(m, name, pair) SOA_VEC_APPLY(m, name, pair)
+#define SOA_VEC_MAP_2(m, name, pair, ...) SOA_VEC_APPLY(m, name, pair) SOA_VEC_MAP_1(m, name, __VA_ARGS__)
+#define SOA_VEC_MAP_3(m, name, pair, ...) SOA_VEC_APPLY(m, name, pair) SOA_VEC_MAP_2(m, name, __VA_ARGS__)
+#define SOA_VEC_MAP_4(m, name, pair, ...) SOA_VEC_APPLY(m, name, pair) SOA_VEC_MAP_3(m, name, __VA_ARGS__)
+#define SOA_VEC_MAP_5(m, name, pair, ...) SOA_VEC_APPLY(m, name, pair) SOA_VEC_MAP_4(m, name, __VA_ARGS__)
+#define SOA_VEC_MAP_6(m, name, pair, ...) SOA_VEC_APPLY(m, name, pair) SOA_VEC_MAP_5(m, name, __VA_ARGS__)
+#define SOA_VEC_MAP_7(m, name, pair, ...) SOA_VEC_APPLY(m, name, pair) SOA_VEC_MAP_6(m, name, __VA_ARGS__)
+#define SOA_VEC_MAP_8(m, name, pair, ...) SOA_VEC_APPLY(m, name, pair) SOA_VEC_MAP_7(m, name, __VA_ARGS__)
+#define SOA_VEC_MAP_9(m, name, pair, ...) SOA_VEC_APPLY(m, name, pair) SOA_VEC_MAP_8(m, name, __VA_ARGS__)
+#define SOA_VEC_MAP_10(m, name, pair, ...) SOA_VEC_APPLY(m, name, pair) SOA_VEC_MAP_9(m, name, __VA_ARGS__)
+#define SOA_VEC_MAP_11(m, name, pair, ...) SOA_VEC_APPLY(m, name, pair) SOA_VEC_MAP_10(m, name, __VA_ARGS__)
+#define SOA_VEC_MAP_12(m, name, pair, ...) SOA_VEC_APPLY(m, name, pair) SOA_VEC_MAP_11(m, name, __VA_ARGS__)
+#define SOA_VEC_MAP_13(m, name, pair, ...) SOA_VEC_APPLY(m, name, pair) SOA_VEC_MAP_12(m, name, __VA_ARGS__)
+#define SOA_VEC_MAP_14(m, name, pair, ...) SOA_VEC_APPLY(m, name, pair) SOA_VEC_MAP_13(m, name, __VA_ARGS__)
+#define SOA_VEC_MAP_15(m, name, pair, ...) SOA_VEC_APPLY(m, name, pair) SOA_VEC_MAP_14(m, name, __VA_ARGS__)
+#define SOA_VEC_MAP_16(m, name, pair, ...) SOA_VEC_APPLY(m, name, pair) SOA_VEC_MAP_15(m, name, __VA_ARGS__)
+
+/* The pieces of code generated for each field */
+#define SOA_VEC_MEMBER(name, field_type, field) field_type field;
+#define SOA_VEC_ARRAY(name, field_type, field) field_type* field;
+#define SOA_VEC_DECL_SLICE(name, field_type, field) field_type* name##_soa_slice_##field(SOA_VEC(name)* vec);
+#define SOA_VEC_DEF_SLICE(name, field_type, field) \
+    field_type* name##_soa_slice_##field(SOA_VEC(name)* vec) { \
+        if (vec == NULL) return NULL; \
+        return vec->field; \
+    }
+#define SOA_VEC_FREE(name, field_type, field) free(vec->field);
+#define SOA_VEC_ALLOC(name, field_type, field) \
+    if ((res->field = (field_type*)malloc(sizeof(field_type) * capacity)) == NULL) failed = true;
+#define SOA_VEC_REALLOC(name, field_type, field) \
+    if (!failed) { \
+        field_type* new_##field = (field_type*)realloc((void*)vec->field, sizeof(field_type) * new_capacity); \
+        if (new_##field == NULL) failed = true; \
+        else vec->field = new_##field; \
+    }
+#define SOA_VEC_STORE(name, field_type, field) vec->field[index] = row.field;
+#define SOA_VEC_LOAD(name, field_type, field) res.field = vec->field[index];
+
+/** @def DECL_SOA_VEC(name, ...)
+    @param name The name of the vector type
+    @param ... The fields of the records, as `(type, field)` pairs; there may be up to `SOA_VEC_MAX_FIELDS` of them
+
+    Declares a struct-of-arrays vector (SOA_VEC) of records, which keeps each field in its own array, and the SOA_VEC-associated functions.
+    `DECL_SOA_VEC(particle, (float, x), (float, y), (int, id))` declares `SOA_VEC(particle)`, with one array of `float` for `x`, one for `y` and one array of `int` for `id`,
+    and the record type `SOA_VEC_ROW(particle)`, a struct with the fields `x`, `y` and `id`.
+**/
+#define DECL_SOA_VEC(name, ...) struct name##_soa_row { \
+        SOA_VEC_MAP(SOA_VEC_MEMBER, name, __VA_ARGS__) \
+    }; \
+    typedef struct name##_soa_row SOA_VEC_ROW(name); \
+    struct name##_soa { \
+        size_t capacity; \
+        size_t length; \
+        SOA_VEC_MAP(SOA_VEC_ARRAY, name, __VA_ARGS__) \
+    }; \
+    typedef struct name##_soa SOA_VEC(name); \
+    SOA_VEC(name)* name##_soa_new(const size_t capacity); \
+    void name##_soa_free(SOA_VEC(name)* vec); \
+    size_t name##_soa_length(const SOA_VEC(name)* vec); \
+    size_t name##_soa_capacity(const SOA_VEC(name)* vec); \
+    size_t name##_soa_resize(SOA_VEC(name)* vec, size_t new_capacity); \
+    size_t name##_soa_push(SOA_VEC(name)* vec, SOA_VEC_ROW(name) row); \
+    bool name##_soa_pop(SOA_VEC(name)* vec, SOA_VEC_ROW(name)* out); \
+    bool name##_soa_get(const SOA_VEC(name)* vec, size_t index, SOA_VEC_ROW(name)* out); \
+    bool name##_soa_set(SOA_VEC(name)* vec, size_t index, SOA_VEC_ROW(name) row); \
+    SOA_VEC_MAP(SOA_VEC_DECL_SLICE, name, __VA_ARGS__)
+
+/** @def DEF_SOA_VEC(name, ...)
+    @param name The name of the vector type
+    @param ... The fields of the records, as given to `DECL_SOA_VEC`
+
+    Defines the SOA_VEC-associated functions.
+    Requires `DECL_SOA_VEC(name, ...)` to have been called beforehand, with the same fields.
+**/
+#define DEF_SOA_VEC(name, ...) \
+    SOA_VEC(name)* name##_soa_new(const size_t capacity) { \
+        SOA_VEC(name)* res = (SOA_VEC(name)*)malloc(sizeof(struct name##_soa)); \
+        if (res == NULL) return NULL; \
+        res->capacity = capacity; \
+        res->length = 0; \
+        bool failed = false; \
+        SOA_VEC_MAP(SOA_VEC_ALLOC, name, __VA_ARGS__) \
+        if (failed) { \
+            name##_soa_free(res); \
+            return NULL; \
+        } \
+        return res; \
+    } \
+    void name##_soa_free(SOA_VEC(name)* vec) { \
+        if (vec == NULL) return; \
+        SOA_VEC_MAP(SOA_VEC_FREE, name, __VA_ARGS__) \
+        free(vec); \
+    } \
+    size_t name##_soa_length(const SOA_VEC(name)* vec) { \
+        if (vec == NULL) return 0; \
+        return vec->length; \
+    } \
+    size_t name##_soa_capacity(const SOA_VEC(name)* vec) { \
+        if (vec == NULL) return 0; \
+        return vec->capacity; \
+    } \
+    size_t name##_soa_resize(SOA_VEC(name)* vec, size_t new_capacity) { \
+        if (vec == NULL) return 0; \
+        if (new_capacity == 0) return vec->capacity; \
+        if (new_capacity < vec->length) new_capacity = vec->length; \
+        if (new_capacity == 0) return 0; \
+        bool failed = false; \
+        SOA_VEC_MAP(SOA_VEC_REALLOC, name, __VA_ARGS__) \
+        if (failed) { \
+            /* Some arrays may have been resized already: only the smallest of both capacities is safe to use */ \
+            if (new_capacity < vec->capacity) vec->capacity = new_capacity; \
+            return 0; \
+        } \
+        vec->capacity = new_capacity; \
+        return new_capacity; \
+    } \
+    size_t name##_soa_push(SOA_VEC(name)* vec, SOA_VEC_ROW(name) row) { \
+        if (vec == NULL) return 0; \
+        if (vec->length == vec->capacity) { \
+            if (name##_soa_resize(vec, vec->capacity * 2) == 0) return 0; \
+        } \
+        size_t index = vec->length; \
+        SOA_VEC_MAP(SOA_VEC_STORE, name, __VA_ARGS__) \
+        vec->length += 1; \
+        return vec->length; \
+    } \
+    bool name##_soa_get(const SOA_VEC(name)* vec, size_t index, SOA_VEC_ROW(name)* out) { \
+        if (vec == NULL || index >= vec->length) return false; \
+        SOA_VEC_ROW(name) res; \
+        SOA_VEC_MAP(SOA_VEC_LOAD, name, __VA_ARGS__) \
+        *out = res; \
+        return true; \
+    } \
+    bool name##_soa_set(SOA_VEC(name)* vec, size_t index, SOA_VEC_ROW(name) row) { \
+        if (vec == NULL || index >= vec->length) return false; \
+        SOA_VEC_MAP(SOA_VEC_STORE, name, __VA_ARGS__) \
+        return true; \
+    } \
+    bool name##_soa_pop(SOA_VEC(name)* vec, SOA_VEC_ROW(name)* out) { \
+        if (vec == NULL || vec->length == 0) return false; \
+        if (out != NULL) name##_soa_get(vec, vec->length - 1, out); \
+        vec->length -= 1; \
+        return true; \
+    } \
+    SOA_VEC_MAP(SOA_VEC_DEF_SLICE, name, __VA_ARGS__)
+
+/** @struct NAME_soa
+
+    A scalable array of records whose fields are stored in separate arrays, which share the same length and capacity:
+    for each field `FIELD` of type `T`, the struct has a member `T* FIELD`, which points to `capacity` values, `length` of which are used.
+
+    A loop that reads a single field only brings this field's array into the cache, instead of whole records;
+    the arrays are plain arrays of scalars, which compilers can vectorize loops over.
+**/
+
+/** @typedef NAME_soa_t
+
+    Resolves to `struct NAME_soa`; can also be accessed with `SOA_VEC(NAME)`.
+**/
+
+/** @typedef NAME_soa_row_t
+
+    A single record, with each field as a member; can also be accessed with `SOA_VEC_ROW(NAME)`.
+**/
+
+/** @fn NAME_soa_new(const size_t capacity)
+    @param capacity The capacity in number of records
+    @returns A new, empty vector, or NULL on allocation failure
+
+    Like `TYPE_vec_new`, pushing to a vector of null capacity will not work until it is resized.
+**/
+
+/** @fn NAME_soa_free(SOA_VEC(NAME)* vec)
+    @param vec The vector to free, along with all of its arrays
+**/
+
+/** @fn NAME_soa_length(const SOA_VEC(NAME)* vec)
+    @returns The number of records of `vec`, 0 if NULL
+**/
+
+/** @fn NAME_soa_capacity(const SOA_VEC(NAME)* vec)
+    @returns The number of records `vec` can hold without being resized, 0 if NULL
+**/
+
+/** @fn NAME_soa_resize(SOA_VEC(NAME)* vec, size_t new_capacity)
+    @param new_capacity The new capacity, in number of records. Must be non-null, or else nothing is done.
+    @returns The new capacity, or 0 on allocation failure
+
+    Resizes every array of `vec`, like `TYPE_vec_resize` does; pointers returned by the slice accessors are invalidated.
+**/
+
+/** @fn NAME_soa_push(SOA_VEC(NAME)* vec, SOA_VEC_ROW(NAME) row)
+    @returns The new length, or 0 if the vector could not grow
+
+    Appends a record to `vec`, writing each field to its array; the capacity is doubled when it is full, like with `TYPE_vec_push`.
+**/
+
+/** @fn NAME_soa_pop(SOA_VEC(NAME)* vec, SOA_VEC_ROW(NAME)* out)
+    @param out Where to write the removed record; may be NULL
+    @returns false if `vec` is empty, true otherwise
+**/
+
+/** @fn NAME_soa_get(const SOA_VEC(NAME)* vec, size_t index, SOA_VEC_ROW(NAME)* out)
+    @param out Where to write the record at `index`, gathered from every array
+    @returns false if `index` is out of bounds, true otherwise
+**/
+
+/** @fn NAME_soa_set(SOA_VEC(NAME)* vec, size_t index, SOA_VEC_ROW(NAME) row)
+    @returns false if `index` is out of bounds, true otherwise
+
+    Overwrites the record at `index`.
+**/
+
+/** @fn NAME_soa_slice_FIELD(SOA_VEC(NAME)* vec)
+    @returns The array holding the field `FIELD` of every record, which has `NAME_soa_length(vec)` values, or NULL if `vec` is NULL
+
+    The array is valid until `vec` is resized; its values may be read and written freely.
+**/
+
+#endif // VEC_SOA_H
@@ -7,25 +7,114 @@
 #include <bstree.h>
 #include <vec.h>
 #include <ring.h>
+#include <llstack.h>
+#include <skiplist.h>
+#include <btreemap.h>
+#include <btree_par.h>
+#include <btree_arena.h>
+#include <btree_io.h>
+#include <btree_bfs.h>
+#include <hashmap.h>
+#include <heap.h>
+#include <bitvec.h>
+#include <vec_soa.h>
+#include <pvec.h>
+#include <gapbuf.h>
+#include <vec_par.h>
+#include <segvec.h>
+#include <slotmap.h>
+#include <pthread.h>
 
 DECL_LL(int);
 DEF_LL(int);
 DECL_LL_PTR(char);
 
+DECL_LL_ATOMIC_STACK(int);
+DEF_LL_ATOMIC_STACK(int);
+
 DECL_BT(int);
 DEF_BT(int);
+DECL_BT_PAR(int);
+DEF_BT_PAR(int);
+DECL_BT_ARENA(int);
+DEF_BT_ARENA(int);
+DECL_BT_IO(int);
+DEF_BT_IO(int);
+DECL_BT_BFS(int);
+DEF_BT_BFS(int);
 
 DECL_BST(int);
 DECL_BST_LL(int);
 DEF_BST(int);
 DEF_BST_LL(int);
 
+typedef struct {
+    int key;
+    int payload;
+} keyed;
+#define KEYED_CMP(a, b) (((a).key > (b).key) - ((a).key < (b).key))
+
+DECL_BT(keyed);
+DEF_BT(keyed);
+DECL_BST(keyed);
+DEF_BST_CMP(keyed, KEYED_CMP);
+
+#define INT_CMP(a, b) (((a) > (b)) - ((a) < (b)))
+
+// DEF_BT(long) is in test_split.c
+DECL_BT(long);
+DECL_BST(long);
+DEF_BST_CMP(long, INT_CMP);
+
+DECL_BST_BALANCED(int);
+DEF_BST_BALANCED(int, INT_CMP);
+DECL_BST_RANK(int);
+DEF_BST_RANK(int, INT_CMP);
+
 DECL_VEC(int);
 DEF_VEC(int);
+DECL_VEC_EYTZINGER(int);
+DEF_VEC_EYTZINGER(int, INT_CMP);
+DECL_BST_VEC(int);
+DEF_BST_VEC(int);
+DECL_HEAP(int);
+DEF_HEAP(int, INT_CMP, HEAP_DEFAULT_ARITY);
+
+DECL_SOA_VEC(particle, (float, x), (float, y), (char, kind), (long, id));
+DEF_SOA_VEC(particle, (float, x), (float, y), (char, kind), (long, id));
+
+DECL_PVEC(int);
+DEF_PVEC(int);
+
+DECL_GAPBUF(char);
+DEF_GAPBUF(char);
+
+DECL_VEC_PAR(int);
+DEF_VEC_PAR(int);
+DECL_VEC_SORTED(int);
+DEF_VEC_SORTED(int, INT_CMP);
+DECL_SEGVEC(int);
+DEF_SEGVEC(int);
+DECL_SLOTMAP(int);
+DEF_SLOTMAP(int);
 
 DECL_RING(int);
 DEF_RING(int);
 
+DECL_SKIPLIST(int, int);
+DEF_SKIPLIST(int, int, INT_CMP);
+
+DECL_BTREE_MAP(int, int);
+DEF_BTREE_MAP(int, int, INT_CMP);
+DECL_BTREE_MAP_VEC(int, int);
+DEF_BTREE_MAP_VEC(int, int);
+
+DECL_HASHMAP(int, int);
+DEF_HASHMAP(int, int, HASHMAP_HASH_INT, HASHMAP_EQ);
+#define KEYED_EQ(a, b) ((a).key == (b).key && (a).payload == (b).payload)
+DECL_HASHMAP(keyed, int);
+DEF_HASHMAP(keyed, int, HASHMAP_HASH_BYTES, KEYED_EQ);
+
 START_TEST(test_ll_new) {
     LL(int)* int_list = int_ll_new(10);
     ck_assert_int_eq(int_list->value, 10);
@@ -97,6 +186,217 @@ START_TEST(test_ll_length) {
 }
 END_TEST
 
+START_TEST(test_ll_pop) {
+    LL(int)* int_list = int_ll_new(0);
+    for (int n = 1; n < 4; n++) {
+        int_list = int_ll_push_head(int_list, n);
+    }
+    int_list = int_ll_pop_head(int_list);
+    ck_assert_int_eq(*int_ll_head(int_list), 2);
+    int_list = int_ll_pop_tail(int_list);
+    ck_assert_int_eq(*int_ll_tail(int_list), 1);
+    ck_assert_int_eq(int_ll_length(int_list), 2);
+    int_list = int_ll_pop_head(int_list);
+    int_list = int_ll_pop_head(int_list);
+    ck_assert(int_list == NULL);
+}
+END_TEST
+
+int test_ll_sort_cmp(const int* a, const int* b) {
+    return (*a > *b) - (*a < *b);
+}
+
+int test_ll_sort_key_cmp(const int* a, const int* b) {
+    return test_ll_sort_cmp(&(int){*a / 16}, &(int){*b / 16});
+}
+
+START_TEST(test_ll_sort) {
+    ck_assert(int_ll_sort(NULL, test_ll_sort_cmp) == NULL);
+
+    // Ascending, descending, random and nearly-sorted inputs
+    for (int pattern = 0; pattern < 4; pattern++) {
+        LL(int)* int_list = NULL;
+        srand(pattern);
+        for (int n = 0; n < 1000; n++) {
+            int value = pattern == 0 ? n : pattern == 1 ? -n : pattern == 2 ? rand() % 100 : n + rand() % 8;
+            int_list = int_ll_push_head(int_list, value);
+        }
+        int_list = int_ll_sort(int_list, test_ll_sort_cmp);
+        ck_assert_int_eq(int_ll_length(int_list), 1000);
+        for (LL(int)* node = int_list; node->next != NULL; node = node->next) {
+            ck_assert_int_le(node->value, node->next->value);
+        }
+        int_ll_free(int_list);
+    }
+
+    // Stability: values are sorted by `value / 16` only, so the original order of each bucket must be kept
+    LL(int)* int_list = NULL;
+    for (int n = 0; n < 256; n++) {
+        int_list = int_ll_push_tail(int_list, (n * 37) % 256);
+    }
+    int_list = int_ll_sort(int_list, test_ll_sort_key_cmp);
+    for (LL(int)* node = int_list; node->next != NULL; node = node->next) {
+        int a = node->value, b = node->next->value;
+        ck_assert_int_le(a / 16, b / 16);
+        if (a / 16 == b / 16) {
+            ck_assert_int_lt((a * 173) % 256, (b * 173) % 256); // 173 is the inverse of 37 modulo 256
+        }
+    }
+    int_ll_free(int_list);
+}
+END_TEST
+
+START_TEST(test_ll_merge) {
+    LL(int)* list_a = NULL;
+    LL(int)* list_b = NULL;
+    for (int n = 9; n >= 0; n--) {
+        if (n % 3 == 0) list_a = int_ll_push_head(list_a, n);
+        else list_b = int_ll_push_head(list_b, n);
+    }
+    LL(int)* merged = int_ll_merge(list_a, list_b, test_ll_sort_cmp);
+    for (int n = 0; n < 10; n++) {
+        ck_assert_int_eq(*int_ll_get(merged, n), n);
+    }
+    int_ll_free(merged);
+}
+END_TEST
+
+bool test_ll_find_sub(const int* value, const void* cmp) {
+    return *value == *(int*)cmp;
+}
+
+void test_ll_for_each_sub(int* value, void* sum) {
+    *(long*)sum += *value;
+    *value += 1;
+}
+
+bool test_ll_ptr_find_sub(const void* value, const void* cmp) {
+    return strcmp(value, cmp) == 0;
+}
+
+START_TEST(test_ll_find) {
+    LL(int)* int_list = NULL;
+    for (int n = 9; n >= 0; n--) {
+        int_list = int_ll_push_head(int_list, n);
+    }
+    int x = 7;
+    ck_assert(int_ll_find(int_list, test_ll_find_sub, &x) == int_list->next->next->next->next->next->next->next);
+    x = 10;
+    ck_assert(int_ll_find(int_list, test_ll_find_sub, &x) == NULL);
+
+    long sum = 0;
+    int_ll_for_each(int_list, test_ll_for_each_sub, &sum);
+    ck_assert_int_eq(sum, 45);
+    ck_assert_int_eq(*int_ll_head(int_list), 1);
+    int_ll_free(int_list);
+
+    LL_PTR(char)* string_list = LL_PTR_NEW(char, "a");
+    LL_PTR_PUSH_TAIL(char, string_list, "b");
+    LL_PTR_PUSH_TAIL(char, string_list, "c");
+    ck_assert_str_eq(LL_PTR_FIND(char, string_list, test_ll_ptr_find_sub, "b"), "b");
+    ck_assert(LL_PTR_FIND(char, string_list, test_ll_ptr_find_sub, "d") == NULL);
+    size_t length = 0;
+    LL_PTR_FOR_EACH(char, string_list, length += strlen(element));
+    ck_assert_int_eq(length, 3);
+    // The locals of the macro do not shadow the caller's variables
+    LL_PTR(char)* list_ptr = string_list;
+    size_t next = 0;
+    LL_PTR_FOR_EACH(char, list_ptr, next += strlen(element));
+    ck_assert_int_eq(next, 3);
+    LL_PTR_FREE_AUTO(char, string_list);
+}
+END_TEST
+
+START_TEST(test_ll_for_each_multi) {
+    LL(int)* lists[20] = {NULL};
+    long expected = 0;
+    for (int n = 0; n < 20; n++) {
+        if (n == 3) continue;
+        for (int m = 0; m < n * 3; m++) {
+            lists[n] = int_ll_push_head(lists[n], m);
+            expected += m;
+        }
+    }
+    long sum = 0;
+    int_ll_for_each_multi(lists, 20, test_ll_for_each_sub, &sum);
+    ck_assert(sum == expected);
+    for (int n = 0; n < 20; n++) {
+        if (n >= 1 && n != 3) {
+            ck_assert_int_eq(*int_ll_tail(lists[n]), 1);
+        }
+        int_ll_free(lists[n]);
+    }
+}
+END_TEST
+
+START_TEST(test_ll_atomic_stack) {
+    LL_ATOMIC_STACK(int)* stack = int_ll_atomic_stack_new();
+    int x;
+    ck_assert(int_ll_atomic_stack_is_empty(stack));
+    ck_assert(!int_ll_atomic_stack_pop(stack, &x));
+
+    for (int n = 0; n < 4; n++) {
+        ck_assert(int_ll_atomic_stack_push(stack, n));
+    }
+    ck_assert(int_ll_atomic_stack_pop(stack, &x));
+    ck_assert_int_eq(x, 3);
+
+    LL(int)* all = int_ll_atomic_stack_pop_all(stack);
+    ck_assert(int_ll_atomic_stack_is_empty(stack));
+    ck_assert_int_eq(int_ll_length(all), 3);
+    ck_assert_int_eq(*int_ll_head(all), 2);
+
+    int_ll_atomic_stack_push_list(stack, all);
+    for (int n = 2; n >= 0; n--) {
+        ck_assert(int_ll_atomic_stack_pop(stack, &x));
+        ck_assert_int_eq(x, n);
+    }
+
+    int_ll_atomic_stack_push(stack, 4);
+    int_ll_atomic_stack_release(stack, int_ll_atomic_stack_pop_all(stack));
+    int_ll_atomic_stack_free(stack);
+}
+END_TEST
+
+#define TEST_ATOMIC_STACK_THREADS 4
+#define TEST_ATOMIC_STACK_ITERATIONS 10000
+
+void* test_ll_atomic_stack_worker(void* data) {
+    LL_ATOMIC_STACK(int)* stack = data;
+    long sum = 0;
+    for (int n = 0; n < TEST_ATOMIC_STACK_ITERATIONS; n++) {
+        int x;
+        int_ll_atomic_stack_push(stack, n);
+        if (int_ll_atomic_stack_pop(stack, &x)) sum += x;
+        if (n % 1000 == 0) {
+            LL(int)* all = int_ll_atomic_stack_pop_all(stack);
+            for (LL(int)* node = all; node != NULL; node = node->next) sum += node->value;
+            int_ll_atomic_stack_release(stack, all);
+        }
+    }
+    return (void*)sum;
+}
+
+START_TEST(test_ll_atomic_stack_threads) {
+    LL_ATOMIC_STACK(int)* stack = int_ll_atomic_stack_new();
+    pthread_t threads[TEST_ATOMIC_STACK_THREADS];
+    for (int n = 0; n < TEST_ATOMIC_STACK_THREADS; n++) {
+        pthread_create(&threads[n], NULL, test_ll_atomic_stack_worker, stack);
+    }
+    long sum = 0;
+    for (int n = 0; n < TEST_ATOMIC_STACK_THREADS; n++) {
+        void* res;
+        pthread_join(threads[n], &res);
+        sum += (long)res;
+    }
+    int x;
+    while (int_ll_atomic_stack_pop(stack, &x)) sum += x;
+    long expected = (long)TEST_ATOMIC_STACK_THREADS * TEST_ATOMIC_STACK_ITERATIONS * (TEST_ATOMIC_STACK_ITERATIONS - 1) / 2;
+    ck_assert(sum == expected);
+    int_ll_atomic_stack_free(stack);
+}
+END_TEST
+
 START_TEST(test_bt_new) {
     BT(int)* int_btree = int_bt_new(16);
 
@@ -163,6 +463,524 @@ START_TEST(test_bt_get) {
 }
 END_TEST
 
+bool test_bt_par_sub(const int value, const void* data) {
+    return value == *(const int*)data;
+}
+
+START_TEST(test_bt_par) {
+    lists_pool_set_threads(4);
+    BT(int)* tree = test_bt_size_rec(12);
+    // Make the tree lopsided, so that the tasks do not all have the same amount of work
+    for (int n = 0; n < 1000; n++) {
+        tree = int_bst_insert(tree, (n * 37) % 1000);
+    }
+
+    ck_assert_int_eq(int_bt_par_size(tree), int_bt_size(tree));
+    ck_assert_int_eq(int_bt_par_depth(tree), int_bt_depth(tree));
+    ck_assert_int_eq(int_bt_par_leaves(tree), int_bt_leaves(tree));
+
+    BT(int)* clone = int_bt_par_clone(tree);
+    ck_assert_int_eq(int_bt_size(clone), int_bt_size(tree));
+    ck_assert_int_eq(int_bt_get(clone, 0b1011)->value, int_bt_get(tree, 0b1011)->value);
+
+    int value = 123;
+    ck_assert_int_eq(int_bt_par_prefix_find(clone, test_bt_par_sub, &value)->value, 123);
+    value = 12;
+    ck_assert_int_eq(int_bt_par_prefix_find(clone, test_bt_par_sub, &value)->value, 12);
+    value = -1;
+    ck_assert(int_bt_par_prefix_find(clone, test_bt_par_sub, &value) == NULL);
+
+    int_bt_par_free(clone);
+    int_bt_par_free(tree);
+
+    // A right spine, built from sorted inserts, has no left subtree to hand out
+    tree = NULL;
+    for (int n = 0; n < 100; n++) tree = int_bst_insert(tree, n);
+    ck_assert_int_eq(int_bt_par_size(tree), 100);
+    ck_assert_int_eq(int_bt_par_depth(tree), 100);
+    ck_assert_int_eq(int_bt_par_leaves(tree), 1);
+    clone = int_bt_par_clone(tree);
+    ck_assert_int_eq(int_bt_size(clone), 100);
+    ck_assert_int_eq(clone->right->right->value, 2);
+    value = 42;
+    ck_assert_int_eq(int_bt_par_prefix_find(clone, test_bt_par_sub, &value)->value, 42);
+    int_bt_par_free(clone);
+    int_bt_par_free(tree);
+
+    lists_pool_set_threads(1);
+    tree = test_bt_size_rec(4);
+    ck_assert_int_eq(int_bt_par_size(tree), 31);
+    int_bt_par_free(tree);
+}
+END_TEST
+
+START_TEST(test_bt_arena) {
+    BT(int)* tree = test_bt_size_rec(4);
+    BT_ARENA(int)* arena = int_bt_arena_from_bt(tree);
+    ck_assert_int_eq(int_bt_arena_length(arena), 31);
+    // Breadth-first order puts the levels one after the other
+    ck_assert_int_eq(int_bt_arena_get(arena, 0)->value, 4);
+    ck_assert_int_eq(int_bt_arena_get(arena, 2)->value, 3);
+    ck_assert_int_eq(int_bt_arena_get(arena, 6)->value, 2);
+    ck_assert_int_eq(int_bt_arena_get(arena, 30)->value, 0);
+    ck_assert(int_bt_arena_get(arena, 31) == NULL);
+
+    // Replace the left subtree of the root, then drop the old one
+    uint32_t leaf = int_bt_arena_new_node(arena, 10);
+    uint32_t node = int_bt_arena_connect(arena, leaf, BT_ARENA_NULL, 11);
+    ck_assert_int_eq(node, 32);
+    int_bt_arena_get(arena, arena->root)->left = node;
+    ck_assert(int_bt_arena_relayout(arena));
+    ck_assert_int_eq(int_bt_arena_length(arena), 18);
+    ck_assert_int_eq(int_bt_arena_get(arena, 1)->value, 11);
+    ck_assert_int_eq(int_bt_arena_get(arena, int_bt_arena_get(arena, 1)->left)->value, 10);
+
+    BT(int)* copy = int_bt_arena_into_bt(arena);
+    ck_assert_int_eq(int_bt_size(copy), 18);
+    ck_assert_int_eq(int_bt_get(copy, 0b00)->value, 10);
+    ck_assert_int_eq(int_bt_get(copy, 0b1111)->value, 0);
+
+    // A cycle is rejected, and leaves the arena as it was
+    uint32_t left = int_bt_arena_get(arena, arena->root)->left;
+    int_bt_arena_get(arena, left)->right = arena->root;
+    ck_assert(!int_bt_arena_relayout(arena));
+    ck_assert_int_eq(int_bt_arena_length(arena), 18);
+    ck_assert_int_eq(int_bt_arena_get(arena, 1)->value, 11);
+    int_bt_arena_get(arena, left)->right = BT_ARENA_NULL;
+
+    int_bt_arena_clear(arena);
+    ck_assert_int_eq(int_bt_arena_length(arena), 0);
+    ck_assert(int_bt_arena_into_bt(arena) == NULL);
+    ck_assert(int_bt_arena_relayout(arena));
+
+    int_bt_arena_free(arena);
+    int_bt_free(copy);
+    int_bt_free(tree);
+}
+END_TEST
+
+bool test_bt_io_equal(BT(int)* a, BT(int)* b) {
+    if (a == NULL || b == NULL) return a == b;
+    return a->value == b->value && test_bt_io_equal(a->left, b->left) && test_bt_io_equal(a->right, b->right);
+}
+
+START_TEST(test_bt_io) {
+    BT(int)* tree = NULL;
+    for (int n = 0; n < 1000; n++) {
+        tree = int_bst_insert(tree, (n * 37) % 1000);
+    }
+    size_t size = int_bt_serialized_size(tree);
+    ck_assert_int_eq(size, BT_IO_VALUES_OFFSET(1000) + 1000 * sizeof(int));
+    uint8_t* buffer = malloc(size);
+    ck_assert_int_eq(int_bt_serialize(tree, buffer, size - 1), 0);
+    ck_assert_int_eq(int_bt_serialize(tree, buffer, size), size);
+
+    BT(int)* copy = int_bt_deserialize(buffer, size);
+    ck_assert(test_bt_io_equal(tree, copy));
+    free(copy);
+
+    BT_VIEW(int) view;
+    ck_assert(int_bt_view_open(&view, buffer, size));
+    ck_assert_int_eq(int_bt_view_length(&view), 1000);
+    ck_assert_int_eq(int_bt_view_get(&view, 0), 0);
+    int value = 123;
+    size_t index = int_bt_view_prefix_find(&view, test_bt_par_sub, &value);
+    ck_assert_int_eq(int_bt_view_get(&view, index), 123);
+    value = -1;
+    ck_assert_int_eq(int_bt_view_prefix_find(&view, test_bt_par_sub, &value), 1000);
+
+    // Invalid input is rejected
+    ck_assert(int_bt_deserialize(buffer, size - 1) == NULL);
+    buffer[BT_IO_HEADER_SIZE] &= ~3;
+    ck_assert(int_bt_deserialize(buffer, size) == NULL);
+    memset(buffer + BT_IO_HEADER_SIZE, 0xff, (1000 + 3) / 4);
+    ck_assert(int_bt_deserialize(buffer, size) == NULL);
+    buffer[0] = 'X';
+    ck_assert(!int_bt_view_open(&view, buffer, size));
+    free(buffer);
+
+    FILE* file = tmpfile();
+    ck_assert(file != NULL);
+    ck_assert(int_bt_serialize_file(tree, file));
+    rewind(file);
+    copy = int_bt_deserialize_file(file);
+    ck_assert(test_bt_io_equal(tree, copy));
+    fclose(file);
+
+    free(copy);
+    int_bt_free(tree);
+}
+END_TEST
+
+START_TEST(test_bt_io_degenerate) {
+    // A left spine deep enough to overflow the stack of a recursive reader
+    const size_t length = 1000000;
+    size_t size = BT_IO_VALUES_OFFSET(length) + length * sizeof(int);
+    uint8_t* buffer = calloc(size, 1);
+    uint32_t value_size = sizeof(int);
+    uint64_t length64 = length;
+    memcpy(buffer, BT_IO_MAGIC, 4);
+    memcpy(buffer + 4, &value_size, 4);
+    memcpy(buffer + 8, &length64, 8);
+    for (size_t n = 0; n + 1 < length; n++) buffer[BT_IO_HEADER_SIZE + n / 4] |= (uint8_t)(1 << (n % 4 * 2));
+    BT(int)* spine = int_bt_deserialize(buffer, size);
+    ck_assert(spine != NULL);
+    size_t depth = 0;
+    for (BT(int)* node = spine; node != NULL; node = node->left) depth++;
+    ck_assert_uint_eq(depth, length);
+
+    // It can be written back without recursing either, to the same bytes
+    ck_assert_uint_eq(int_bt_serialized_size(spine), size);
+    uint8_t* copy = malloc(size);
+    ck_assert_uint_eq(int_bt_serialize(spine, copy, size), size);
+    ck_assert(memcmp(copy, buffer, size) == 0);
+    free(copy);
+    free(spine);
+
+    // A header claiming far more nodes than the file holds is rejected without allocating for all of them
+    length64 = (uint64_t)1 << 40;
+    memcpy(buffer + 8, &length64, 8);
+    FILE* file = tmpfile();
+    ck_assert(file != NULL);
+    ck_assert_uint_eq(fwrite(buffer, 1, BT_IO_HEADER_SIZE + 64, file), BT_IO_HEADER_SIZE + 64);
+    rewind(file);
+    ck_assert(int_bt_deserialize_file(file) == NULL);
+
+    // So is a header of another type, before anything else is read
+    rewind(file);
+    buffer[0] = 'X';
+    ck_assert_uint_eq(fwrite(buffer, 1, BT_IO_HEADER_SIZE, file), BT_IO_HEADER_SIZE);
+    rewind(file);
+    ck_assert(int_bt_deserialize_file(file) == NULL);
+    fclose(file);
+    free(buffer);
+}
+END_TEST
+
+bool test_bt_bfs_sub(const int value, const void* data) {
+    return value <= *(const int*)data;
+}
+
+START_TEST(test_bt_bfs) {
+    // A deep left spine, then a shallow match on the right
+    BT(int)* tree = int_bt_connect(test_bt_size_rec(6), int_bt_new(1), 10);
+    int threshold = 1;
+    BT(int)* found = int_bt_bfs_find(tree, test_bt_bfs_sub, &threshold);
+    ck_assert(found == tree->right);
+    threshold = -1;
+    ck_assert(int_bt_bfs_find(tree, test_bt_bfs_sub, &threshold) == NULL);
+
+    size_t depth;
+    size_t* widths = int_bt_level_widths(tree, &depth);
+    ck_assert_int_eq(depth, 8);
+    ck_assert_int_eq(widths[0], 1);
+    ck_assert_int_eq(widths[1], 2);
+    ck_assert_int_eq(widths[2], 2);
+    ck_assert_int_eq(widths[7], 64);
+    free(widths);
+    ck_assert(int_bt_level_widths(NULL, &depth) == NULL);
+    ck_assert_int_eq(depth, 0);
+
+    BT_BFS(int)* iterator = int_bt_bfs_new(tree);
+    size_t count = 0, last_depth = 0;
+    for (BT(int)* node = int_bt_bfs_next(iterator); node != NULL; node = int_bt_bfs_next(iterator)) {
+        size_t node_depth = int_bt_bfs_depth(iterator);
+        ck_assert_int_ge(node_depth, last_depth);
+        // The values of test_bt_size_rec count down from its root
+        if (node_depth >= 1 && node != tree->right) ck_assert_int_eq(node->value, 7 - node_depth);
+        last_depth = node_depth;
+        count++;
+    }
+    ck_assert_int_eq(count, int_bt_size(tree));
+    ck_assert_int_eq(last_depth, 7);
+    int_bt_bfs_free(iterator);
+
+    int_bt_free(tree);
+}
+END_TEST
+
+START_TEST(test_bst_find) {
+    BST(int)* tree = NULL;
+    for (int n = 0; n < 100; n++) {
+        tree = int_bst_insert(tree, (n * 37) % 100);
+    }
+    ck_assert_int_eq(int_bst_find(tree, 42)->value, 42);
+    ck_assert(int_bst_find(tree, 100) == NULL);
+    ck_assert(int_bst_lower_bound(tree, 100) == NULL);
+    ck_assert_int_eq(int_bst_lower_bound(tree, -5)->value, 0);
+    ck_assert_int_eq(int_bst_upper_bound(tree, 41)->value, 42);
+
+    for (int n = 0; n < 100; n += 3) {
+        tree = int_bst_erase(tree, n);
+    }
+    ck_assert_int_eq(int_bt_size(tree), 66);
+    ck_assert(int_bst_find(tree, 42) == NULL);
+    ck_assert_int_eq(int_bst_lower_bound(tree, 42)->value, 43);
+    ck_assert_int_eq(int_bst_upper_bound(tree, 43)->value, 44);
+    tree = int_bst_erase(tree, 42);
+    ck_assert_int_eq(int_bt_size(tree), 66);
+
+    int_bt_free(tree);
+}
+END_TEST
+
+START_TEST(test_bst_vec) {
+    VEC(int)* sorted = int_vec_new(1);
+    for (int n = 0; n < 1000; n++) {
+        int_vec_push(sorted, n / 3);
+    }
+    BST(int)* tree = int_bst_from_sorted_vec(sorted);
+    ck_assert_int_eq(int_bt_size(tree), 1000);
+    ck_assert_int_le(int_bt_depth(tree), 12);
+    ck_assert_int_eq(int_bst_lower_bound(tree, 100)->value, 100);
+    ck_assert_int_eq(int_bst_range_count(tree, 100, 200), 300);
+
+    VEC(int)* flat = int_vec_new(1);
+    int_vec_push(flat, -1);
+    ck_assert_int_eq(int_bst_into_vec(tree, flat), 1001);
+    for (int n = 0; n < 1000; n++) {
+        ck_assert_int_eq(flat->data[n + 1], sorted->data[n]);
+    }
+    LL(int)* list = int_bst_into_ll(tree);
+    ck_assert_int_eq(int_ll_length(list), 1000);
+    ck_assert_int_eq(*int_ll_get(list, 999), 333);
+    int_ll_free(list);
+    free(tree);
+
+    // Runs of equal values must all end up in right subtrees
+    sorted->length = 0;
+    for (int n = 0; n < 100; n++) {
+        int_vec_push(sorted, n < 90 ? 7 : 8);
+    }
+    tree = int_bst_from_sorted_vec(sorted);
+    ck_assert_int_eq(int_bst_range_count(tree, 7, 8), 90);
+    ck_assert_int_eq(int_bst_find(tree, 8)->value, 8);
+    free(tree);
+
+    sorted->length = 0;
+    ck_assert(int_bst_from_sorted_vec(sorted) == NULL);
+
+    int_vec_free(sorted);
+    int_vec_free(flat);
+}
+END_TEST
+
+START_TEST(test_bst_cursor_split) {
+    // The tree functions of `long` are defined in test_split.c
+    BST(long)* tree = NULL;
+    for (long n = 0; n < 100; n += 5) tree = long_bst_insert(tree, n);
+    BT_CURSOR(long)* cursor = long_bt_cursor_new(tree);
+    ck_assert(long_bst_cursor_seek(cursor, 42));
+    ck_assert_int_eq(*long_bt_cursor_get(cursor), 45);
+    ck_assert(long_bt_cursor_next(cursor));
+    ck_assert_int_eq(*long_bt_cursor_get(cursor), 50);
+    ck_assert(!long_bst_cursor_seek(cursor, 96));
+    long_bt_cursor_free(cursor);
+    long_bt_free(tree);
+}
+END_TEST
+
+START_TEST(test_bst_cursor) {
+    BST(int)* evens = NULL;
+    BST(int)* thirds = NULL;
+    // Sorted insertions make degenerate trees, deeper than the cursor's initial path
+    for (int n = 0; n < 200; n += 2) {
+        evens = int_bst_insert(evens, n);
+    }
+    for (int n = 0; n < 200; n++) {
+        thirds = int_bst_insert(thirds, (n * 37) % 200 / 3 * 3);
+    }
+
+    // Merge-join: count the values present in both trees
+    BT_CURSOR(int)* a = int_bt_cursor_new(evens);
+    BT_CURSOR(int)* b = int_bt_cursor_new(thirds);
+    ck_assert(int_bt_cursor_get(a) == NULL);
+    int_bt_cursor_first(a);
+    int_bt_cursor_first(b);
+    int common = 0, previous = -1;
+    while (int_bt_cursor_get(a) != NULL && int_bt_cursor_get(b) != NULL) {
+        int x = *int_bt_cursor_get(a), y = *int_bt_cursor_get(b);
+        if (x < y) {
+            int_bt_cursor_next(a);
+        } else if (y < x) {
+            ck_assert_int_ge(y, previous);
+            previous = y;
+            int_bt_cursor_next(b);
+        } else {
+            common++;
+            int_bt_cursor_next(a);
+        }
+    }
+    ck_assert_int_eq(common, 34);
+
+    // Resume from a value, in both directions
+    ck_assert(int_bst_cursor_seek(a, 51));
+    ck_assert_int_eq(*int_bt_cursor_get(a), 52);
+    ck_assert(int_bt_cursor_prev(a));
+    ck_assert_int_eq(*int_bt_cursor_get(a), 50);
+    ck_assert(int_bt_cursor_next(a));
+    ck_assert(int_bt_cursor_next(a));
+    ck_assert_int_eq(*int_bt_cursor_get(a), 54);
+    ck_assert(!int_bst_cursor_seek(a, 199));
+    ck_assert(int_bt_cursor_last(a));
+    ck_assert_int_eq(*int_bt_cursor_get(a), 198);
+    ck_assert(!int_bt_cursor_next(a));
+    ck_assert(!int_bt_cursor_next(a));
+
+    int count = 0;
+    for (bool valid = int_bt_cursor_last(b); valid; valid = int_bt_cursor_prev(b)) {
+        count++;
+    }
+    ck_assert_int_eq(count, 200);
+
+    int_bt_cursor_free(a);
+    int_bt_cursor_free(b);
+    int_bt_free(evens);
+    int_bt_free(thirds);
+}
+END_TEST
+
+bool test_bst_range_sub(const keyed* value, void* data) {
+    *(int*)data += value->payload;
+    return value->key < 25;
+}
+
+START_TEST(test_bst_range) {
+    BST(keyed)* tree = NULL;
+    for (int n = 0; n < 50; n++) {
+        keyed value = {(n * 7) % 50, 1};
+        tree = keyed_bst_insert(tree, value);
+    }
+    keyed lo = {10, 0}, hi = {30, 0};
+    ck_assert_int_eq(keyed_bst_range_count(tree, lo, hi), 20);
+    ck_assert_int_eq(keyed_bst_range_count(tree, hi, lo), 0);
+
+    int sum = 0;
+    ck_assert_int_eq(keyed_bst_for_each_in_range(tree, lo, hi, test_bst_range_sub, &sum), 16);
+    ck_assert_int_eq(sum, 16);
+
+    keyed_bt_free(tree);
+}
+END_TEST
+
+bool test_bbst_for_each_sub(const int* value, void* data) {
+    int* expected = data;
+    ck_assert_int_eq(*value, *expected);
+    *expected += 8;
+    return true;
+}
+
+START_TEST(test_bbst_insert) {
+    BST_BALANCED(int)* tree = int_bbst_new();
+
+    // Sorted input is the worst case for the unbalanced BST
+    for (int n = 0; n < 4096; n++) {
+        ck_assert(int_bbst_insert(tree, n));
+    }
+    ck_assert(!int_bbst_insert(tree, 100));
+    ck_assert_int_eq(int_bbst_size(tree), 4096);
+    ck_assert_int_le(int_bbst_depth(tree), 17);
+    ck_assert_int_eq(*int_bbst_min(tree), 0);
+    ck_assert_int_eq(*int_bbst_max(tree), 4095);
+    ck_assert_int_eq(*int_bbst_find(tree, 1234), 1234);
+    ck_assert(int_bbst_find(tree, 4096) == NULL);
+
+    int_bbst_free(tree);
+}
+END_TEST
+
+START_TEST(test_bbst_erase) {
+    BST_BALANCED(int)* tree = int_bbst_new();
+
+    for (int n = 4095; n >= 0; n--) {
+        int_bbst_insert(tree, n * 2);
+    }
+    for (int n = 0; n < 4096; n++) {
+        if (n % 4 != 0) ck_assert(int_bbst_erase(tree, n * 2));
+    }
+    ck_assert(!int_bbst_erase(tree, 2));
+    ck_assert(!int_bbst_erase(tree, 1));
+    ck_assert_int_eq(int_bbst_size(tree), 1024);
+    ck_assert_int_le(int_bbst_depth(tree), 15);
+
+    ck_assert_int_eq(*int_bbst_lower_bound(tree, 8), 8);
+    ck_assert_int_eq(*int_bbst_lower_bound(tree, 9), 16);
+    ck_assert_int_eq(*int_bbst_upper_bound(tree, 8), 16);
+    ck_assert(int_bbst_upper_bound(tree, 8184) == NULL);
+
+    int_bbst_erase(tree, 0);
+    int expected = 8;
+    ck_assert_int_eq(int_bbst_for_each(tree, test_bbst_for_each_sub, &expected), 1023);
+
+    // Random insertions and removals keep the tree balanced
+    srand(1);
+    for (int n = 0; n < 20000; n++) {
+        int value = rand() % 5000;
+        if (rand() % 2) int_bbst_insert(tree, value);
+        else int_bbst_erase(tree, value);
+    }
+    size_t size = int_bbst_size(tree);
+    size_t max_depth = 1;
+    while (((size_t)1 << (max_depth * 2 / 3)) <= size) max_depth++;
+    ck_assert_int_le(int_bbst_depth(tree), max_depth + 1);
+
+    int_bbst_free(tree);
+}
+END_TEST
+
+START_TEST(test_ost) {
+    BST_RANK(int)* tree = int_ost_new();
+
+    // Sorted input is the worst case for the unbalanced BST
+    for (int n = 0; n < 4096; n++) {
+        ck_assert(int_ost_insert(tree, n / 2));
+    }
+    ck_assert_int_eq(int_ost_size(tree), 4096);
+    ck_assert_int_le(int_ost_depth(tree), 24);
+    ck_assert_int_eq(*int_ost_select(tree, 0), 0);
+    ck_assert_int_eq(*int_ost_select(tree, 1001), 500);
+    ck_assert(int_ost_select(tree, 4096) == NULL);
+    ck_assert_int_eq(int_ost_rank(tree, 500), 1000);
+    ck_assert_int_eq(int_ost_rank(tree, -1), 0);
+    ck_assert_int_eq(int_ost_rank(tree, 5000), 4096);
+
+    // Random insertions and removals, checked against a counting array
+    int counts[1000] = {0};
+    for (int n = 0; n < 4096; n++) {
+        ck_assert(int_ost_erase(tree, n / 2));
+    }
+    ck_assert_int_eq(int_ost_size(tree), 0);
+    ck_assert(!int_ost_erase(tree, 0));
+    srand(2);
+    for (int n = 0; n < 20000; n++) {
+        int value = rand() % 1000;
+        if (rand() % 3) {
+            int_ost_insert(tree, value);
+            counts[value]++;
+        } else {
+            ck_assert(int_ost_erase(tree, value) == (counts[value] > 0));
+            if (counts[value] > 0) counts[value]--;
+        }
+    }
+    size_t below = 0;
+    for (int value = 0; value < 1000; value++) {
+        ck_assert_int_eq(int_ost_rank(tree, value), below);
+        if (counts[value] > 0) {
+            ck_assert_int_eq(*int_ost_select(tree, below), value);
+            ck_assert_int_eq(*int_ost_select(tree, below + counts[value] - 1), value);
+            ck_assert_int_eq(*int_ost_find(tree, value), value);
+        } else {
+            ck_assert(int_ost_find(tree, value) == NULL);
+        }
+        below += counts[value];
+    }
+    ck_assert_int_eq(int_ost_size(tree), below);
+    ck_assert_int_le(int_ost_depth(tree), 28);
+
+    int_ost_free(tree);
+}
+END_TEST
+
 START_TEST(test_vec_new) {
     VEC(int)* int_vec = int_vec_new(4);
 
@@ -220,6 +1038,630 @@ START_TEST(test_vec_find) {
 }
 END_TEST
 
+START_TEST(test_vec_eytzinger) {
+    for (int length = 0; length < 70; length++) {
+        VEC(int)* sorted = int_vec_new(1);
+        for (int n = 0; n < length; n++) {
+            int_vec_push(sorted, n / 2 * 3);
+        }
+        VEC(int)* eytzinger = int_vec_build_eytzinger(sorted);
+        ck_assert_int_eq(int_vec_length(eytzinger), length);
+
+        for (int value = -1; value <= length / 2 * 3 + 1; value++) {
+            size_t expected = 0;
+            while (expected < (size_t)length && sorted->data[expected] < value) expected++;
+            size_t index = int_vec_eytzinger_lower_bound(eytzinger, value);
+            if (expected == (size_t)length) {
+                ck_assert_int_eq(index, length);
+            } else {
+                ck_assert_int_eq(eytzinger->data[index], sorted->data[expected]);
+            }
+        }
+
+        int_vec_free(sorted);
+        int_vec_free(eytzinger);
+    }
+}
+END_TEST
+
+START_TEST(test_heap_push_pop) {
+    VEC(int)* heap = int_vec_new(4);
+    int value;
+
+    ck_assert(int_heap_peek(heap) == NULL);
+    ck_assert(!int_heap_pop(heap, &value));
+    for (int n = 0; n < 1000; n++) {
+        ck_assert_int_eq(int_heap_push(heap, (n * 7919) % 1000), n + 1);
+    }
+    ck_assert_int_eq(*int_heap_peek(heap), 0);
+    for (int n = 0; n < 1000; n++) {
+        ck_assert(int_heap_pop(heap, &value));
+        ck_assert_int_eq(value, n);
+    }
+    ck_assert_int_eq(int_vec_length(heap), 0);
+
+    // Duplicates, interleaved with pops
+    for (int n = 0; n < 100; n++) {
+        int_heap_push(heap, n % 10);
+        int_heap_push(heap, n % 7);
+        ck_assert(int_heap_pop(heap, NULL));
+    }
+    int previous = -1;
+    while (int_heap_pop(heap, &value)) {
+        ck_assert_int_ge(value, previous);
+        previous = value;
+    }
+
+    int_vec_free(heap);
+}
+END_TEST
+
+START_TEST(test_heap_heapify) {
+    VEC(int)* heap = int_vec_new(16);
+    for (int n = 0; n < 1000; n++) {
+        int_vec_push(heap, (n * 7919) % 1000);
+    }
+    int_heap_heapify(heap);
+    int value;
+
+    // Timer queue: every fired event is rescheduled 1000 ticks later
+    for (int n = 0; n < 3000; n++) {
+        ck_assert(int_heap_replace_top(heap, *int_heap_peek(heap) + 1000, &value));
+        ck_assert_int_eq(value, n);
+    }
+    ck_assert_int_eq(int_vec_length(heap), 1000);
+
+    // Few values are sifted up, many values trigger a rebuild
+    int values[3000];
+    for (int n = 0; n < 3000; n++) values[n] = 2999 - n;
+    ck_assert_int_eq(int_heap_push_n(heap, values, 10), 1010);
+    // A small batch that does not fit doubles the capacity, rather than growing it to the exact length
+    ck_assert_int_eq(int_heap_push_n(heap, values + 10, 20), 1030);
+    ck_assert_int_eq(int_vec_capacity(heap), 2048);
+    ck_assert_int_eq(int_heap_push_n(heap, values + 30, 2970), 4000);
+    for (int n = 0; n < 4000; n++) {
+        ck_assert(int_heap_pop(heap, &value));
+        ck_assert_int_eq(value, n);
+    }
+    ck_assert(!int_heap_replace_top(heap, 0, &value));
+
+    int_vec_free(heap);
+}
+END_TEST
+
+START_TEST(test_bitvec_push) {
+    BITVEC* bitvec = bitvec_new(4);
+
+    for (size_t n = 0; n < 1000; n++) {
+        ck_assert_uint_eq(bitvec_push(bitvec, n % 3 == 0), n + 1);
+    }
+    ck_assert_int_ge(bitvec_capacity(bitvec), 1000);
+    for (size_t n = 0; n < 1000; n++) {
+        ck_assert(bitvec_test(bitvec, n) == (n % 3 == 0));
+    }
+    ck_assert(!bitvec_test(bitvec, 1000));
+    ck_assert_uint_eq(bitvec_count(bitvec), 334);
+
+    bitvec_set(bitvec, 1);
+    bitvec_clear(bitvec, 0);
+    bitvec_set(bitvec, 5000);
+    ck_assert(bitvec_test(bitvec, 1));
+    ck_assert(!bitvec_test(bitvec, 0));
+    ck_assert_uint_eq(bitvec_count(bitvec), 334);
+
+    // 999 is set, and must not linger once popped
+    ck_assert(bitvec_pop(bitvec));
+    ck_assert(!bitvec_pop(bitvec));
+    ck_assert_uint_eq(bitvec_push(bitvec, false), 999);
+    ck_assert(!bitvec_test(bitvec, 998));
+    ck_assert_uint_eq(bitvec_count(bitvec), 333);
+
+    ck_assert_uint_eq(bitvec_resize(bitvec, 1), 1024);
+
+    bitvec_free(bitvec);
+}
+END_TEST
+
+START_TEST(test_bitvec_rank_select) {
+    BITVEC* bitvec = bitvec_zeros(1000);
+    ck_assert_uint_eq(bitvec_length(bitvec), 1000);
+    ck_assert_uint_eq(bitvec_first_set(bitvec), 1000);
+    ck_assert_uint_eq(bitvec_select(bitvec, 0), 1000);
+
+    for (size_t n = 0; n < 1000; n++) {
+        if ((n * 7919) % 13 < 2) bitvec_set(bitvec, n);
+    }
+    size_t rank = 0;
+    for (size_t n = 0; n < 1000; n++) {
+        ck_assert_uint_eq(bitvec_rank(bitvec, n), rank);
+        if (bitvec_test(bitvec, n)) {
+            ck_assert_uint_eq(bitvec_select(bitvec, rank), n);
+            rank++;
+        }
+    }
+    ck_assert_uint_eq(bitvec_count(bitvec), rank);
+    ck_assert_uint_eq(bitvec_select(bitvec, rank), 1000);
+
+    size_t visited = 0;
+    for (size_t n = bitvec_first_set(bitvec); n < bitvec_length(bitvec); n = bitvec_next_set(bitvec, n + 1)) {
+        ck_assert(bitvec_test(bitvec, n));
+        ck_assert_uint_eq(bitvec_rank(bitvec, n), visited);
+        visited++;
+    }
+    ck_assert_uint_eq(visited, rank);
+
+    bitvec_free(bitvec);
+}
+END_TEST
+
+START_TEST(test_bitvec_bulk) {
+    // Lengths that are not multiples of 64, nor of the 256 bits of an AVX2 register
+    BITVEC* a = bitvec_zeros(1000);
+    BITVEC* b = bitvec_zeros(700);
+    bool expected[1000];
+    for (size_t n = 0; n < 1000; n++) {
+        if (n % 2 == 0) bitvec_set(a, n);
+        if (n % 3 == 0) bitvec_set(b, n);
+    }
+    ck_assert_uint_eq(bitvec_and_count(a, b), 117);
+
+    BITVEC* c = bitvec_zeros(1000);
+    bitvec_or(c, a);
+    bitvec_and(c, b);
+    for (size_t n = 0; n < 1000; n++) expected[n] = n < 700 && n % 6 == 0;
+    for (size_t n = 0; n < 1000; n++) ck_assert(bitvec_test(c, n) == expected[n]);
+    ck_assert_uint_eq(bitvec_count(c), 117);
+
+    bitvec_xor(c, a);
+    for (size_t n = 0; n < 1000; n++) ck_assert(bitvec_test(c, n) == (n % 2 == 0 && !expected[n]));
+    bitvec_andnot(c, b);
+    for (size_t n = 0; n < 1000; n++) ck_assert(bitvec_test(c, n) == (n % 2 == 0 && (n >= 700 || n % 3 != 0)));
+
+    // Bits of `a` past the length of `b` are dropped
+    bitvec_or(b, a);
+    ck_assert_uint_eq(bitvec_length(b), 700);
+    ck_assert_uint_eq(bitvec_count(b), 467);
+
+    bitvec_free(a);
+    bitvec_free(b);
+    bitvec_free(c);
+}
+END_TEST
+
+START_TEST(test_soa_vec) {
+    SOA_VEC(particle)* particles = particle_soa_new(2);
+
+    for (long n = 0; n < 1000; n++) {
+        SOA_VEC_ROW(particle) row = {(float)n, (float)-n, (char)('a' + n % 26), n * 3};
+        ck_assert_uint_eq(particle_soa_push(particles, row), n + 1);
+    }
+    ck_assert_int_eq(particle_soa_length(particles), 1000);
+    ck_assert_int_ge(particle_soa_capacity(particles), 1000);
+
+    SOA_VEC_ROW(particle) row;
+    ck_assert(particle_soa_get(particles, 30, &row));
+    ck_assert(row.x == 30.0f && row.y == -30.0f);
+    ck_assert_int_eq(row.kind, 'e');
+    ck_assert_int_eq(row.id, 90);
+    ck_assert(!particle_soa_get(particles, 1000, &row));
+
+    // Each field is a plain array
+    float* x = particle_soa_slice_x(particles);
+    long* id = particle_soa_slice_id(particles);
+    float sum = 0;
+    for (size_t n = 0; n < particle_soa_length(particles); n++) sum += x[n];
+    ck_assert(sum == 499500.0f);
+    for (size_t n = 0; n < particle_soa_length(particles); n++) id[n] += 1;
+    row.x = 1.5f;
+    ck_assert(particle_soa_set(particles, 30, row));
+    ck_assert(particles->x[30] == 1.5f);
+    ck_assert_int_eq(particles->id[30], 90);
+    ck_assert_int_eq(particles->id[31], 94);
+
+    ck_assert_int_eq(particle_soa_resize(particles, 1), 1000);
+    ck_assert(particle_soa_pop(particles, &row));
+    ck_assert_int_eq(row.id, 2998);
+    ck_assert_int_eq(row.kind, 'a' + 999 % 26);
+    while (particle_soa_pop(particles, NULL)) {}
+    ck_assert_int_eq(particle_soa_length(particles), 0);
+
+    particle_soa_free(particles);
+}
+END_TEST
+
+bool test_pvec_sum(const int* value, void* data) {
+    *(long*)data += *value;
+    return true;
+}
+
+START_TEST(test_pvec) {
+    PVEC(int)* versions[4];
+    PVEC(int)* pvec = int_pvec_new();
+    size_t kept = 0;
+    ck_assert(int_pvec_get(pvec, 0) == NULL);
+
+    // Enough values for the trie to be three levels deep
+    for (int n = 0; n < 40000; n++) {
+        if (n == 0 || n == 32 || n == 1056 || n == 33000) versions[kept++] = int_pvec_retain(pvec);
+        PVEC(int)* next = int_pvec_push(pvec, n);
+        int_pvec_release(pvec);
+        pvec = next;
+    }
+    ck_assert_int_eq(int_pvec_length(pvec), 40000);
+    for (int n = 0; n < 40000; n++) {
+        ck_assert_int_eq(*int_pvec_get(pvec, n), n);
+    }
+    ck_assert(int_pvec_get(pvec, 40000) == NULL);
+
+    // Older versions are left untouched
+    ck_assert_int_eq(int_pvec_length(versions[0]), 0);
+    ck_assert_int_eq(int_pvec_length(versions[2]), 1056);
+    ck_assert_int_eq(*int_pvec_get(versions[2], 1055), 1055);
+    ck_assert(int_pvec_get(versions[2], 1056) == NULL);
+    ck_assert_int_eq(*int_pvec_get(versions[3], 32999), 32999);
+
+    PVEC(int)* changed = int_pvec_set(pvec, 1000, -1);
+    PVEC(int)* changed_tail = int_pvec_set(changed, 39999, -2);
+    ck_assert(int_pvec_set(pvec, 40000, 0) == NULL);
+    ck_assert_int_eq(*int_pvec_get(changed_tail, 1000), -1);
+    ck_assert_int_eq(*int_pvec_get(changed_tail, 39999), -2);
+    ck_assert_int_eq(*int_pvec_get(changed, 39999), 39999);
+    ck_assert_int_eq(*int_pvec_get(pvec, 1000), 1000);
+    ck_assert_int_eq(*int_pvec_get(versions[2], 1000), 1000);
+
+    long sum = 0;
+    ck_assert_int_eq(int_pvec_for_each(changed_tail, test_pvec_sum, &sum), 40000);
+    ck_assert_int_eq(sum, 39999L * 40000 / 2 - 1001 - 40001);
+
+    int_pvec_release(changed);
+    int_pvec_release(changed_tail);
+    for (size_t n = 0; n < kept; n++) int_pvec_release(versions[n]);
+    int_pvec_release(pvec);
+}
+END_TEST
+
+void* test_pvec_concurrent_sub(void* data) {
+    PVEC(int)* pvec = (PVEC(int)*)data;
+    long sum = 0;
+    for (size_t n = 0; n < int_pvec_length(pvec); n++) sum += *int_pvec_get(pvec, n);
+    size_t length = int_pvec_length(pvec);
+    int_pvec_release(pvec);
+    return (void*)(intptr_t)(sum == (long)length * (long)(length - 1) / 2);
+}
+
+START_TEST(test_pvec_concurrent) {
+    // Each snapshot is handed to another thread, which reads it and releases it while new versions are being built
+    PVEC(int)* pvec = int_pvec_new();
+    pthread_t threads[8];
+    for (int n = 0; n < 8; n++) {
+        for (int m = 0; m < 1000; m++) {
+            PVEC(int)* next = int_pvec_push(pvec, n * 1000 + m);
+            int_pvec_release(pvec);
+            pvec = next;
+        }
+        pthread_create(&threads[n], NULL, test_pvec_concurrent_sub, int_pvec_retain(pvec));
+    }
+    for (int n = 0; n < 8; n++) {
+        void* res;
+        pthread_join(threads[n], &res);
+        ck_assert(res != NULL);
+    }
+    int_pvec_release(pvec);
+}
+END_TEST
+
+START_TEST(test_gapbuf) {
+    GAPBUF(char)* buffer = char_gapbuf_new(4);
+
+    ck_assert_int_eq(char_gapbuf_insert_n(buffer, "held world", 10), 10);
+    ck_assert_int_eq(char_gapbuf_move_to(buffer, 3), 3);
+    ck_assert_int_eq(char_gapbuf_erase_before(buffer, 1), 1);
+    char_gapbuf_insert_n(buffer, "llo,", 4);
+    ck_assert_int_eq(char_gapbuf_cursor(buffer), 6);
+    ck_assert_int_eq(char_gapbuf_move_to(buffer, 100), 13);
+    char_gapbuf_insert(buffer, '!');
+    ck_assert_int_eq(char_gapbuf_length(buffer), 14);
+    ck_assert_int_eq(*char_gapbuf_get(buffer, 4), 'o');
+    ck_assert(char_gapbuf_get(buffer, 14) == NULL);
+
+    char_gapbuf_move_to(buffer, 5);
+    ck_assert_int_eq(char_gapbuf_erase_after(buffer, 100), 9);
+    const char* before;
+    const char* after;
+    size_t before_length, after_length;
+    char_gapbuf_slices(buffer, &before, &before_length, &after, &after_length);
+    ck_assert_int_eq(before_length, 5);
+    ck_assert_int_eq(after_length, 0);
+    ck_assert(memcmp(before, "hello", 5) == 0);
+    char_gapbuf_slices(NULL, &before, &before_length, &after, &after_length);
+    ck_assert(before == NULL && after == NULL);
+    ck_assert_int_eq(before_length + after_length, 0);
+
+    // Random edits, checked against a plain array
+    char expected[4096];
+    size_t length = 5;
+    memcpy(expected, "hello", 5);
+    srand(3);
+    for (int n = 0; n < 20000; n++) {
+        size_t cursor = char_gapbuf_move_to(buffer, (size_t)rand() % (length + 1));
+        int op = rand() % 3;
+        if (op == 0 && length < sizeof(expected)) {
+            char value = (char)('a' + rand() % 26);
+            memmove(expected + cursor + 1, expected + cursor, length - cursor);
+            expected[cursor] = value;
+            length++;
+            ck_assert_int_eq(char_gapbuf_insert(buffer, value), length);
+        } else if (op == 1) {
+            size_t count = char_gapbuf_erase_before(buffer, 2);
+            memmove(expected + cursor - count, expected + cursor, length - cursor);
+            length -= count;
+        } else {
+            size_t count = char_gapbuf_erase_after(buffer, 1);
+            memmove(expected + cursor, expected + cursor + count, length - cursor - count);
+            length -= count;
+        }
+    }
+    ck_assert_int_eq(char_gapbuf_length(buffer), length);
+    for (size_t n = 0; n < length; n++) ck_assert_int_eq(*char_gapbuf_get(buffer, n), expected[n]);
+
+    char_gapbuf_move_to(buffer, length / 2);
+    ck_assert_int_eq(char_gapbuf_resize(buffer, 1), length);
+    ck_assert_int_eq(char_gapbuf_cursor(buffer), length / 2);
+    ck_assert(memcmp(char_gapbuf_contiguous(buffer), expected, length) == 0);
+
+    char_gapbuf_free(buffer);
+}
+END_TEST
+
+void test_vec_par_double(int* value, void* data) {
+    (void)data;
+    *value *= 2;
+}
+
+int test_vec_par_sum(int a, int b) {
+    return a + b;
+}
+
+// Associative but not commutative: keeps the first value that is not -1
+int test_vec_par_first(int a, int b) {
+    return a == -1 ? b : a;
+}
+
+bool test_vec_par_multiple(const int* value, const void* data) {
+    return *value % *(const int*)data == 0;
+}
+
+START_TEST(test_vec_par) {
+    for (size_t threads = 1; threads <= 4; threads += 3) {
+        lists_pool_set_threads(threads);
+        // Short vectors are processed serially
+        for (int length = 1000; length <= 100000; length *= 100) {
+            VEC(int)* vec = int_vec_new(16);
+            for (int n = 0; n < length; n++) int_vec_push(vec, n % 1000);
+
+            int_vec_par_for_each(vec, test_vec_par_double, NULL);
+            for (int n = 0; n < length; n++) ck_assert_int_eq(vec->data[n], 2 * (n % 1000));
+
+            ck_assert_int_eq(int_vec_par_reduce(vec, 0, test_vec_par_sum), length / 1000 * 999000);
+            vec->data[0] = -1;
+            ck_assert_int_eq(int_vec_par_reduce(vec, -1, test_vec_par_first), 2);
+
+            VEC(int)* dest = int_vec_new(1);
+            int_vec_push(dest, 42);
+            int divisor = 6;
+            ck_assert_int_eq(int_vec_par_filter_into(vec, dest, test_vec_par_multiple, &divisor), length / 1000 * 334 - 1);
+            ck_assert_int_eq(dest->length, length / 1000 * 334);
+            ck_assert_int_eq(dest->data[0], 42);
+            for (size_t n = 1; n < dest->length; n++) {
+                ck_assert_int_eq(dest->data[n] % 6, 0);
+                if (n > 1 && dest->data[n] != 0) ck_assert_int_gt(dest->data[n], dest->data[n - 1]);
+            }
+
+            int_vec_free(dest);
+            int_vec_free(vec);
+        }
+    }
+    lists_pool_set_threads(1);
+}
+END_TEST
+
+START_TEST(test_vec_sorted_search) {
+    for (int length = 0; length < 70; length++) {
+        VEC(int)* sorted = int_vec_new(1);
+        for (int n = 0; n < length; n++) {
+            int_vec_push(sorted, n / 2 * 3);
+        }
+
+        for (int value = -1; value <= length / 2 * 3 + 1; value++) {
+            size_t lower = 0;
+            while (lower < (size_t)length && sorted->data[lower] < value) lower++;
+            size_t upper = lower;
+            while (upper < (size_t)length && sorted->data[upper] == value) upper++;
+
+            ck_assert_uint_eq(int_vec_lower_bound(sorted, value), lower);
+            ck_assert_uint_eq(int_vec_upper_bound(sorted, value), upper);
+            size_t begin, end;
+            int_vec_equal_range(sorted, value, &begin, &end);
+            ck_assert_uint_eq(begin, lower);
+            ck_assert_uint_eq(end, upper);
+            ck_assert_uint_eq(int_vec_binary_search(sorted, value), lower < upper ? lower : (size_t)length);
+        }
+
+        int_vec_free(sorted);
+    }
+
+    VEC(int)* vec = int_vec_new(1);
+    for (int n = 0; n < 100; n++) {
+        ck_assert_int_eq(int_vec_insert_sorted(vec, (n * 37) % 50), n + 1);
+    }
+    for (int n = 0; n < 100; n++) {
+        ck_assert_int_eq(vec->data[n], n / 2);
+    }
+    int_vec_free(vec);
+}
+END_TEST
+
+START_TEST(test_vec_sorted_set) {
+    // a holds the multiples of 2 below 200, b the multiples of 3 below 30 and the multiples of 5 below 600, with 30 twice
+    VEC(int)* a = int_vec_new(1);
+    VEC(int)* b = int_vec_new(1);
+    for (int n = 0; n < 200; n += 2) int_vec_push(a, n);
+    for (int n = 0; n < 30; n += 3) int_vec_push(b, n);
+    for (int n = 30; n < 600; n += 5) int_vec_push(b, n);
+    int_vec_insert_sorted(b, 30);
+
+    VEC(int)* dest = int_vec_new(1);
+    int_vec_push(dest, -1);
+    ck_assert_int_eq(int_vec_merge(a, b, dest), a->length + b->length);
+    ck_assert_int_eq(dest->data[0], -1);
+    for (size_t n = 2; n < dest->length; n++) ck_assert_int_le(dest->data[n - 1], dest->data[n]);
+    dest->length = 0;
+
+    // Reference results, computed by testing every value
+    int union_length = 0, intersection_length = 0, difference_length = 0;
+    for (int n = 0; n < 600; n++) {
+        int in_a = n < 200 && n % 2 == 0;
+        int in_b = (n < 30 && n % 3 == 0) + (n >= 30 && n % 5 == 0) + (n == 30);
+        union_length += in_a > in_b ? in_a : in_b;
+        intersection_length += in_a < in_b ? in_a : in_b;
+        difference_length += in_a > in_b ? in_a - in_b : 0;
+    }
+
+    ck_assert_int_eq(int_vec_union(a, b, dest), union_length);
+    for (size_t n = 1; n < dest->length; n++) ck_assert_int_le(dest->data[n - 1], dest->data[n]);
+    dest->length = 0;
+
+    ck_assert_int_eq(int_vec_intersection(a, b, dest), intersection_length);
+    for (size_t n = 0; n < dest->length; n++) {
+        ck_assert_int_eq(dest->data[n] % 2, 0);
+        ck_assert(dest->data[n] < 30 ? dest->data[n] % 3 == 0 : dest->data[n] % 5 == 0);
+        if (n > 0) ck_assert_int_lt(dest->data[n - 1], dest->data[n]);
+    }
+    dest->length = 0;
+
+    ck_assert_int_eq(int_vec_difference(a, b, dest), difference_length);
+    for (size_t n = 0; n < dest->length; n++) {
+        ck_assert(dest->data[n] < 30 ? dest->data[n] % 3 != 0 : dest->data[n] % 5 != 0);
+    }
+    ck_assert_int_eq(int_vec_difference(b, b, dest), 0);
+    dest->length = 0;
+
+    VEC(int)* empty = int_vec_new(1);
+    ck_assert_int_eq(int_vec_intersection(a, empty, dest), 0);
+    ck_assert_int_eq(int_vec_union(empty, b, dest), b->length);
+    ck_assert_int_eq(memcmp(dest->data, b->data, sizeof(int) * b->length), 0);
+
+    int_vec_free(empty);
+    int_vec_free(dest);
+    int_vec_free(a);
+    int_vec_free(b);
+}
+END_TEST
+
+bool test_segvec_sum(const int* value, void* data) {
+    *(long*)data += *value;
+    return true;
+}
+
+START_TEST(test_segvec) {
+    SEGVEC(int)* segvec = int_segvec_new();
+    ck_assert(int_segvec_get(segvec, 0) == NULL);
+    ck_assert_int_eq(int_segvec_reserve(segvec, 100), 224);
+
+    int* first = NULL;
+    for (int n = 0; n < 10000; n++) {
+        size_t index;
+        ck_assert(int_segvec_push(segvec, n, &index));
+        ck_assert_uint_eq(index, n);
+        if (n == 0) first = int_segvec_get(segvec, 0);
+    }
+    // Growing never moves the values
+    ck_assert(int_segvec_get(segvec, 0) == first);
+    ck_assert_int_eq(int_segvec_length(segvec), 10000);
+    for (int n = 0; n < 10000; n++) {
+        ck_assert_int_eq(*int_segvec_get(segvec, n), n);
+    }
+    ck_assert(int_segvec_get(segvec, 10000) == NULL);
+    ck_assert(int_segvec_get(segvec, SIZE_MAX) == NULL);
+
+    long sum = 0;
+    ck_assert_int_eq(int_segvec_for_each(segvec, test_segvec_sum, &sum), 10000);
+    ck_assert_int_eq(sum, 9999L * 10000 / 2);
+
+    int_segvec_free(segvec);
+}
+END_TEST
+
+#define TEST_SEGVEC_THREADS 4
+#define TEST_SEGVEC_PUSHES 20000
+
+struct test_segvec_writer {
+    SEGVEC(int)* segvec;
+    int thread;
+};
+
+void* test_segvec_writer(void* data) {
+    struct test_segvec_writer* writer = (struct test_segvec_writer*)data;
+    for (int n = 0; n < TEST_SEGVEC_PUSHES; n++) {
+        if (!int_segvec_push(writer->segvec, writer->thread * TEST_SEGVEC_PUSHES + n, NULL)) return NULL;
+    }
+    return data;
+}
+
+void* test_segvec_reader(void* data) {
+    SEGVEC(int)* segvec = (SEGVEC(int)*)data;
+    size_t seen = 0;
+    // Reads the values as they are published, until all of them are
+    while (seen < TEST_SEGVEC_THREADS * TEST_SEGVEC_PUSHES) {
+        size_t length = int_segvec_length(segvec);
+        seen = 0;
+        for (size_t n = 0; n < length; n++) {
+            int* value = int_segvec_get(segvec, n);
+            if (value == NULL) continue;
+            if (*value < 0 || *value >= TEST_SEGVEC_THREADS * TEST_SEGVEC_PUSHES) return NULL;
+            seen++;
+        }
+    }
+    return data;
+}
+
+START_TEST(test_segvec_concurrent) {
+    SEGVEC(int)* segvec = int_segvec_new();
+    pthread_t writers[TEST_SEGVEC_THREADS];
+    struct test_segvec_writer args[TEST_SEGVEC_THREADS];
+    pthread_t reader;
+    pthread_create(&reader, NULL, test_segvec_reader, segvec);
+    for (int n = 0; n < TEST_SEGVEC_THREADS; n++) {
+        args[n].segvec = segvec;
+        args[n].thread = n;
+        pthread_create(&writers[n], NULL, test_segvec_writer, &args[n]);
+    }
+    void* res;
+    for (int n = 0; n < TEST_SEGVEC_THREADS; n++) {
+        pthread_join(writers[n], &res);
+        ck_assert(res != NULL);
+    }
+    pthread_join(reader, &res);
+    ck_assert(res != NULL);
+
+    // Every value was pushed exactly once, and the values of each thread are in order
+    ck_assert_int_eq(int_segvec_length(segvec), TEST_SEGVEC_THREADS * TEST_SEGVEC_PUSHES);
+    bool* found = (bool*)calloc(TEST_SEGVEC_THREADS * TEST_SEGVEC_PUSHES, sizeof(bool));
+    int last[TEST_SEGVEC_THREADS];
+    for (int n = 0; n < TEST_SEGVEC_THREADS; n++) last[n] = -1;
+    for (size_t n = 0; n < TEST_SEGVEC_THREADS * TEST_SEGVEC_PUSHES; n++) {
+        int value = *int_segvec_get(segvec, n);
+        ck_assert(!found[value]);
+        found[value] = true;
+        ck_assert_int_gt(value, last[value / TEST_SEGVEC_PUSHES]);
+        last[value / TEST_SEGVEC_PUSHES] = value;
+    }
+
+    free(found);
+    int_segvec_free(segvec);
+}
+END_TEST
+
 START_TEST(test_ring_new) {
     RING(int)* int_ring = int_ring_new(4);
 
@@ -265,6 +1707,15 @@ START_TEST(test_ring_pop) {
         ck_assert_int_eq(int_ring_length(int_ring), 3 - n);
     }
 
+    // Used as a queue, the ring wraps around without growing
+    for (int n = 0; n < 100; n++) {
+        int_ring_push_head(int_ring, n);
+        int_ring_push_head(int_ring, n);
+        ck_assert_int_eq(int_ring_pop_tail(int_ring), n);
+        ck_assert_int_eq(int_ring_pop_head(int_ring), n);
+    }
+    ck_assert_int_eq(int_ring_capacity(int_ring), 4);
+
     int_ring_free(int_ring);
 }
 END_TEST
@@ -293,6 +1744,362 @@ START_TEST(test_ring_find) {
 }
 END_TEST
 
+START_TEST(test_skiplist_insert) {
+    SKIPLIST(int, int)* list = int_int_skiplist_new();
+
+    for (int n = 0; n < 1000; n++) {
+        ck_assert(int_int_skiplist_insert(list, (n * 7919) % 1000, n));
+    }
+    ck_assert(!int_int_skiplist_insert(list, 500, -1));
+    ck_assert_int_eq(int_int_skiplist_length(list), 1000);
+    ck_assert_int_eq(*int_int_skiplist_find(list, 500), -1);
+    ck_assert_int_eq(*int_int_skiplist_find(list, 7919 % 1000), 1);
+    ck_assert(int_int_skiplist_find(list, 1000) == NULL);
+
+    int expected = 0;
+    for (SKIPLIST_NODE(int, int)* node = int_int_skiplist_first(list); node != NULL; node = int_int_skiplist_next(node)) {
+        ck_assert_int_eq(node->key, expected++);
+    }
+    ck_assert_int_eq(expected, 1000);
+
+    int_int_skiplist_free(list);
+}
+END_TEST
+
+START_TEST(test_skiplist_erase) {
+    SKIPLIST(int, int)* list = int_int_skiplist_new();
+
+    for (int n = 0; n < 100; n++) {
+        int_int_skiplist_insert(list, n, n);
+    }
+    for (int n = 0; n < 100; n += 2) {
+        ck_assert(int_int_skiplist_erase(list, n));
+    }
+    ck_assert(!int_int_skiplist_erase(list, 0));
+    ck_assert_int_eq(int_int_skiplist_length(list), 50);
+    for (int n = 0; n < 100; n++) {
+        ck_assert((int_int_skiplist_find(list, n) != NULL) == (n % 2 == 1));
+    }
+    ck_assert_int_eq(int_int_skiplist_lower_bound(list, 10)->key, 11);
+
+    int_int_skiplist_free(list);
+}
+END_TEST
+
+bool test_skiplist_range_sub(const int* key, int* value, void* data) {
+    (void)value;
+    *(int*)data += *key;
+    return *key < 40;
+}
+
+START_TEST(test_skiplist_range) {
+    SKIPLIST(int, int)* list = int_int_skiplist_new();
+
+    for (int n = 0; n < 100; n++) {
+        int_int_skiplist_insert(list, n * 2, n);
+    }
+    int sum = 0;
+    ck_assert_int_eq(int_int_skiplist_for_each_range(list, 9, 20, test_skiplist_range_sub, &sum), 5);
+    ck_assert_int_eq(sum, 10 + 12 + 14 + 16 + 18);
+
+    // Stops early once the callback returns false
+    sum = 0;
+    ck_assert_int_eq(int_int_skiplist_for_each_range(list, 38, 100, test_skiplist_range_sub, &sum), 2);
+    ck_assert_int_eq(sum, 38 + 40);
+
+    int_int_skiplist_free(list);
+}
+END_TEST
+
+START_TEST(test_btree_map_insert) {
+    BTREE_MAP(int, int)* map = int_int_btree_map_new();
+
+    // Enough keys for the tree to be three levels deep
+    for (int n = 0; n < 20000; n++) {
+        ck_assert(int_int_btree_map_insert(map, (n * 7919) % 20000, n));
+    }
+    ck_assert(!int_int_btree_map_insert(map, 0, -1));
+    ck_assert_int_eq(int_int_btree_map_length(map), 20000);
+    ck_assert_int_eq(*int_int_btree_map_find(map, 0), -1);
+    ck_assert_int_eq(*int_int_btree_map_find(map, 7919), 1);
+    ck_assert(int_int_btree_map_find(map, 20000) == NULL);
+
+    int expected = 0;
+    for (BTREE_MAP_ITER(int, int) iter = int_int_btree_map_first(map); iter.key != NULL; int_int_btree_map_iter_next(&iter)) {
+        ck_assert_int_eq(*iter.key, expected++);
+    }
+    ck_assert_int_eq(expected, 20000);
+
+    int_int_btree_map_free(map);
+}
+END_TEST
+
+START_TEST(test_btree_map_erase) {
+    BTREE_MAP(int, int)* map = int_int_btree_map_new();
+
+    for (int n = 0; n < 20000; n++) {
+        int_int_btree_map_insert(map, n, n);
+    }
+    for (int n = 0; n < 20000; n++) {
+        int key = (n * 7919) % 20000;
+        if (key % 5 != 0) ck_assert(int_int_btree_map_erase(map, key));
+    }
+    ck_assert(!int_int_btree_map_erase(map, 1));
+    ck_assert_int_eq(int_int_btree_map_length(map), 4000);
+    for (int n = 0; n < 20000; n++) {
+        ck_assert((int_int_btree_map_find(map, n) != NULL) == (n % 5 == 0));
+    }
+    ck_assert_int_eq(*int_int_btree_map_lower_bound(map, 11).key, 15);
+
+    for (int n = 0; n < 20000; n += 5) {
+        ck_assert(int_int_btree_map_erase(map, n));
+    }
+    ck_assert_int_eq(int_int_btree_map_length(map), 0);
+    ck_assert(int_int_btree_map_first(map).key == NULL);
+
+    int_int_btree_map_free(map);
+}
+END_TEST
+
+START_TEST(test_btree_map_from_sorted_vecs) {
+    VEC(int)* keys = int_vec_new(16);
+    for (int n = 0; n < 10000; n++) {
+        int_vec_push(keys, n * 2);
+    }
+    BTREE_MAP(int, int)* map = int_int_btree_map_from_sorted_vecs(keys, keys);
+    ck_assert_int_eq(int_int_btree_map_length(map), 10000);
+    for (int n = 0; n < 20000; n++) {
+        int* value = int_int_btree_map_find(map, n);
+        if (n % 2 == 0) ck_assert_int_eq(*value, n);
+        else ck_assert(value == NULL);
+    }
+
+    int sum = 0;
+    ck_assert_int_eq(int_int_btree_map_for_each_range(map, 9, 20, test_skiplist_range_sub, &sum), 5);
+    ck_assert_int_eq(sum, 10 + 12 + 14 + 16 + 18);
+
+    // The map can be modified after being built
+    ck_assert(int_int_btree_map_insert(map, 1, 1));
+    ck_assert(int_int_btree_map_erase(map, 0));
+    ck_assert_int_eq(*int_int_btree_map_first(map).key, 1);
+
+    int_int_btree_map_free(map);
+    int_vec_free(keys);
+}
+END_TEST
+
+START_TEST(test_hashmap_insert) {
+    HASHMAP(int, int)* map = int_int_hashmap_new();
+
+    for (int n = 0; n < 20000; n++) {
+        ck_assert(int_int_hashmap_insert(map, (n * 7919) % 20000, n));
+    }
+    ck_assert(!int_int_hashmap_insert(map, 0, -1));
+    ck_assert_int_eq(int_int_hashmap_length(map), 20000);
+    // At most 7/8 of the slots are used
+    ck_assert_int_ge(int_int_hashmap_capacity(map) - int_int_hashmap_capacity(map) / 8, 20000);
+    ck_assert_int_eq(*int_int_hashmap_find(map, 0), -1);
+    ck_assert_int_eq(*int_int_hashmap_find(map, 7919), 1);
+    ck_assert(int_int_hashmap_find(map, 20000) == NULL);
+    ck_assert(int_int_hashmap_find(map, -1) == NULL);
+
+    int_int_hashmap_clear(map);
+    ck_assert_int_eq(int_int_hashmap_length(map), 0);
+    ck_assert(int_int_hashmap_find(map, 0) == NULL);
+
+    // Reserving up front avoids any rehash
+    ck_assert(int_int_hashmap_reserve(map, 100000));
+    size_t capacity = int_int_hashmap_capacity(map);
+    for (int n = 0; n < 100000; n++) {
+        int_int_hashmap_insert(map, n * 16, n);
+    }
+    ck_assert_uint_eq(int_int_hashmap_capacity(map), capacity);
+    for (int n = 0; n < 100000; n++) {
+        ck_assert_int_eq(*int_int_hashmap_find(map, n * 16), n);
+    }
+
+    int_int_hashmap_free(map);
+
+    HASHMAP(keyed, int)* keyed_map = keyed_int_hashmap_new();
+    for (int n = 0; n < 1000; n++) {
+        keyed key = {n % 10, n / 10};
+        ck_assert(keyed_int_hashmap_insert(keyed_map, key, n));
+    }
+    keyed key = {3, 42};
+    ck_assert_int_eq(*keyed_int_hashmap_find(keyed_map, key), 423);
+    key.payload = 100;
+    ck_assert(keyed_int_hashmap_find(keyed_map, key) == NULL);
+    keyed_int_hashmap_free(keyed_map);
+}
+END_TEST
+
+START_TEST(test_hashmap_erase) {
+    HASHMAP(int, int)* map = int_int_hashmap_new();
+
+    for (int n = 0; n < 20000; n++) {
+        int_int_hashmap_insert(map, n, n);
+    }
+    for (int n = 0; n < 20000; n++) {
+        int key = (n * 7919) % 20000;
+        if (key % 5 != 0) ck_assert(int_int_hashmap_erase(map, key));
+    }
+    ck_assert(!int_int_hashmap_erase(map, 1));
+    ck_assert_int_eq(int_int_hashmap_length(map), 4000);
+    for (int n = 0; n < 20000; n++) {
+        ck_assert((int_int_hashmap_find(map, n) != NULL) == (n % 5 == 0));
+    }
+
+    // Churn at a constant size must not grow the map, however many tombstones are left behind
+    size_t capacity = int_int_hashmap_capacity(map);
+    for (int n = 0; n < 200000; n++) {
+        ck_assert(int_int_hashmap_insert(map, 20000 + n, n));
+        ck_assert(int_int_hashmap_erase(map, 20000 + n));
+    }
+    ck_assert_uint_eq(int_int_hashmap_capacity(map), capacity);
+    ck_assert_int_eq(int_int_hashmap_length(map), 4000);
+
+    for (int n = 0; n < 20000; n += 5) {
+        ck_assert(int_int_hashmap_erase(map, n));
+    }
+    ck_assert_int_eq(int_int_hashmap_length(map), 0);
+    ck_assert(int_int_hashmap_find(map, 0) == NULL);
+
+    int_int_hashmap_free(map);
+}
+END_TEST
+
+bool test_hashmap_for_each_sub(const int* key, int* value, void* data) {
+    *(int*)data += *key;
+    *value += 1;
+    return true;
+}
+
+START_TEST(test_hashmap_random) {
+    HASHMAP(int, int)* map = int_int_hashmap_new();
+    int reference[512];
+    for (int n = 0; n < 512; n++) reference[n] = -1;
+
+    srand(1);
+    for (int n = 0; n < 100000; n++) {
+        int key = rand() % 512;
+        if (rand() % 2) {
+            ck_assert(int_int_hashmap_insert(map, key, n) == (reference[key] < 0));
+            reference[key] = n;
+        } else {
+            ck_assert(int_int_hashmap_erase(map, key) == (reference[key] >= 0));
+            reference[key] = -1;
+        }
+    }
+    size_t length = 0;
+    int sum = 0;
+    for (int n = 0; n < 512; n++) {
+        int* value = int_int_hashmap_find(map, n);
+        if (reference[n] < 0) {
+            ck_assert(value == NULL);
+        } else {
+            ck_assert_int_eq(*value, reference[n]);
+            length++;
+            sum += n;
+        }
+    }
+    ck_assert_uint_eq(int_int_hashmap_length(map), length);
+
+    int visited = 0;
+    ck_assert_uint_eq(int_int_hashmap_for_each(map, test_hashmap_for_each_sub, &visited), length);
+    ck_assert_int_eq(visited, sum);
+    for (int n = 0; n < 512; n++) {
+        if (reference[n] >= 0) ck_assert_int_eq(*int_int_hashmap_find(map, n), reference[n] + 1);
+    }
+
+    int_int_hashmap_free(map);
+}
+END_TEST
+
+START_TEST(test_slotmap) {
+    SLOTMAP(int)* map = int_slotmap_new(0);
+    uint64_t handles[100];
+    for (int n = 0; n < 100; n++) {
+        handles[n] = int_slotmap_insert(map, n);
+        ck_assert(handles[n] != SLOTMAP_NULL);
+    }
+    ck_assert_int_eq(int_slotmap_length(map), 100);
+    ck_assert(!int_slotmap_contains(map, SLOTMAP_NULL));
+
+    int value;
+    for (int n = 0; n < 100; n += 3) {
+        ck_assert(int_slotmap_remove(map, handles[n], &value));
+        ck_assert_int_eq(value, n);
+        ck_assert(!int_slotmap_remove(map, handles[n], NULL));
+    }
+    ck_assert_int_eq(int_slotmap_length(map), 66);
+    for (int n = 0; n < 100; n++) {
+        if (n % 3 == 0) {
+            ck_assert(int_slotmap_get(map, handles[n]) == NULL);
+        } else {
+            ck_assert_int_eq(*int_slotmap_get(map, handles[n]), n);
+        }
+    }
+
+    // Vacated slots are reused, with a new generation: the old handles stay invalid
+    uint64_t reused = int_slotmap_insert(map, -1);
+    ck_assert_uint_eq(SLOTMAP_INDEX(reused), 99);
+    ck_assert_uint_eq(SLOTMAP_GENERATION(reused), 3);
+    ck_assert(int_slotmap_get(map, handles[99]) == NULL);
+    ck_assert_int_eq(*int_slotmap_get(map, reused), -1);
+    ck_assert(int_slotmap_get(map, SLOTMAP_HANDLE(99, 2)) == NULL);
+
+    // The values are packed, and each of them knows its handle
+    int* values = int_slotmap_values(map);
+    for (size_t n = 0; n < int_slotmap_length(map); n++) {
+        ck_assert_int_eq(*int_slotmap_get(map, int_slotmap_handle_at(map, n)), values[n]);
+    }
+    ck_assert(int_slotmap_handle_at(map, int_slotmap_length(map)) == SLOTMAP_NULL);
+
+    int_slotmap_clear(map);
+    ck_assert_int_eq(int_slotmap_length(map), 0);
+    ck_assert(!int_slotmap_contains(map, reused));
+    ck_assert(!int_slotmap_contains(map, handles[1]));
+
+    int_slotmap_free(map);
+}
+END_TEST
+
+START_TEST(test_slotmap_random) {
+    SLOTMAP(int)* map = int_slotmap_new(16);
+    uint64_t handles[512];
+    int reference[512];
+    for (int n = 0; n < 512; n++) reference[n] = -1;
+
+    srand(2);
+    for (int n = 0; n < 100000; n++) {
+        int key = rand() % 512;
+        if (reference[key] < 0) {
+            handles[key] = int_slotmap_insert(map, n);
+            reference[key] = n;
+        } else if (rand() % 2) {
+            int value;
+            ck_assert(int_slotmap_remove(map, handles[key], &value));
+            ck_assert_int_eq(value, reference[key]);
+            ck_assert(!int_slotmap_contains(map, handles[key]));
+            reference[key] = -1;
+        } else {
+            ck_assert_int_eq(*int_slotmap_get(map, handles[key]), reference[key]);
+        }
+    }
+    size_t length = 0;
+    for (int n = 0; n < 512; n++) {
+        if (reference[n] < 0) continue;
+        ck_assert_int_eq(*int_slotmap_get(map, handles[n]), reference[n]);
+        length++;
+    }
+    ck_assert_uint_eq(int_slotmap_length(map), length);
+    // No more slots than there were values at once
+    ck_assert(map->slot_count <= 512);
+
+    int_slotmap_free(map);
+}
+END_TEST
+
 Suite* ll_suite() {
     Suite* res = suite_create("LinkedList");
     TCase* tc_core = tcase_create("Core");
@@ -300,6 +2107,13 @@ Suite* ll_suite() {
     tcase_add_test(tc_core, test_ll_push);
     tcase_add_test(tc_core, test_ll_head);
     tcase_add_test(tc_core, test_ll_tail);
+    tcase_add_test(tc_core, test_ll_pop);
+    tcase_add_test(tc_core, test_ll_sort);
+    tcase_add_test(tc_core, test_ll_merge);
+    tcase_add_test(tc_core, test_ll_find);
+    tcase_add_test(tc_core, test_ll_for_each_multi);
+    tcase_add_test(tc_core, test_ll_atomic_stack);
+    tcase_add_test(tc_core, test_ll_atomic_stack_threads);
     suite_add_tcase(res, tc_core);
     return res;
 }
@@ -312,6 +2126,19 @@ Suite* bt_suite() {
     tcase_add_test(tc_core, test_bt_depth);
     tcase_add_test(tc_core, test_bt_leaves);
     tcase_add_test(tc_core, test_bt_get);
+    tcase_add_test(tc_core, test_bt_par);
+    tcase_add_test(tc_core, test_bt_arena);
+    tcase_add_test(tc_core, test_bt_io);
+    tcase_add_test(tc_core, test_bt_io_degenerate);
+    tcase_add_test(tc_core, test_bt_bfs);
+    tcase_add_test(tc_core, test_bst_find);
+    tcase_add_test(tc_core, test_bst_range);
+    tcase_add_test(tc_core, test_bst_vec);
+    tcase_add_test(tc_core, test_bst_cursor);
+    tcase_add_test(tc_core, test_bst_cursor_split);
+    tcase_add_test(tc_core, test_bbst_insert);
+    tcase_add_test(tc_core, test_bbst_erase);
+    tcase_add_test(tc_core, test_ost);
     suite_add_tcase(res, tc_core);
     return res;
 }
@@ -323,6 +2150,18 @@ Suite* vec_suite() {
     tcase_add_test(tc_core, test_vec_length);
     tcase_add_test(tc_core, test_vec_pop);
     tcase_add_test(tc_core, test_vec_find);
+    tcase_add_test(tc_core, test_vec_eytzinger);
+    tcase_add_test(tc_core, test_heap_push_pop);
+    tcase_add_test(tc_core, test_heap_heapify);
+    tcase_add_test(tc_core, test_soa_vec);
+    tcase_add_test(tc_core, test_pvec);
+    tcase_add_test(tc_core, test_pvec_concurrent);
+    tcase_add_test(tc_core, test_gapbuf);
+    tcase_add_test(tc_core, test_vec_par);
+    tcase_add_test(tc_core, test_vec_sorted_search);
+    tcase_add_test(tc_core, test_vec_sorted_set);
+    tcase_add_test(tc_core, test_segvec);
+    tcase_add_test(tc_core, test_segvec_concurrent);
     suite_add_tcase(res, tc_core);
     return res;
 }
@@ -338,20 +2177,68 @@ Suite* ring_suite() {
     return res;
 }
 
+Suite* skiplist_suite() {
+    Suite* res = suite_create("SkipList");
+    TCase* tc_core = tcase_create("Core");
+    tcase_add_test(tc_core, test_skiplist_insert);
+    tcase_add_test(tc_core, test_skiplist_erase);
+    tcase_add_test(tc_core, test_skiplist_range);
+    suite_add_tcase(res, tc_core);
+    return res;
+}
+
+Suite* btree_map_suite() {
+    Suite* res = suite_create("BTreeMap");
+    TCase* tc_core = tcase_create("Core");
+    tcase_add_test(tc_core, test_btree_map_insert);
+    tcase_add_test(tc_core, test_btree_map_erase);
+    tcase_add_test(tc_core, test_btree_map_from_sorted_vecs);
+    suite_add_tcase(res, tc_core);
+    return res;
+}
+
+Suite* bitvec_suite() {
+    Suite* res = suite_create("BitVec");
+    TCase* tc_core = tcase_create("Core");
+    tcase_add_test(tc_core, test_bitvec_push);
+    tcase_add_test(tc_core, test_bitvec_rank_select);
+    tcase_add_test(tc_core, test_bitvec_bulk);
+    suite_add_tcase(res, tc_core);
+    return res;
+}
+
+Suite* hashmap_suite() {
+    Suite* res = suite_create("HashMap");
+    TCase* tc_core = tcase_create("Core");
+    tcase_add_test(tc_core, test_hashmap_insert);
+    tcase_add_test(tc_core, test_hashmap_erase);
+    tcase_add_test(tc_core, test_hashmap_random);
+    suite_add_tcase(res, tc_core);
+    return res;
+}
+
+Suite* slotmap_suite() {
+    Suite* res = suite_create("SlotMap");
+    TCase* tc_core = tcase_create("Core");
+    tcase_add_test(tc_core, test_slotmap);
+    tcase_add_test(tc_core, test_slotmap_random);
+    suite_add_tcase(res, tc_core);
+    return res;
+}
+
 int main(int argc, char* argv[]) {
-    Suite* ll_s = ll_suite();
-    Suite* bt_s = bt_suite();
-    Suite* vec_s = vec_suite();
-    Suite* ring_s = ring_suite();
-    SRunner* ll_sr = srunner_create(ll_s);
-    SRunner* bt_sr = srunner_create(bt_s);
-    SRunner* vec_sr = srunner_create(vec_s);
-    SRunner* ring_sr = srunner_create(ring_s);
-
-    srunner_run_all(ll_sr, CK_NORMAL);
-    srunner_run_all(bt_sr, CK_NORMAL);
-    srunner_run_all(vec_sr, CK_NORMAL);
-    srunner_run_all(ring_sr, CK_NORMAL);
-    int fails = srunner_ntests_failed(ll_sr) + srunner_ntests_failed(bt_sr) + srunner_ntests_failed(vec_sr) + srunner_ntests_failed(ring_sr);
+    SRunner* sr = srunner_create(ll_suite());
+    srunner_add_suite(sr, bt_suite());
+    srunner_add_suite(sr, vec_suite());
+    srunner_add_suite(sr, bitvec_suite());
+    srunner_add_suite(sr, ring_suite());
+    srunner_add_suite(sr, skiplist_suite());
+    srunner_add_suite(sr, btree_map_suite());
+    srunner_add_suite(sr, hashmap_suite());
+    srunner_add_suite(sr, slotmap_suite());
+
+    srunner_run_all(sr, CK_NORMAL);
+    int fails = srunner_ntests_failed(sr);
+    srunner_free(sr);
     return (fails == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
 }
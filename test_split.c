@@ -0,0 +1,6 @@
+#include <btree.h>
+
+// The tree functions of `long` are defined here, apart from test.c, which only declares them:
+// this checks that the functions defined by DEF_BST_CMP link against a DEF_BT in another file.
+DECL_BT(long);
+DEF_BT(long);